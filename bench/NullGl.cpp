@@ -0,0 +1,702 @@
+#include "NullGl.hpp"
+#include "NullGl_.hpp"
+#include "glCompact/gl/Constants.hpp"
+
+#include <cstring>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    namespace nullGl {
+        static uint32_t functionIndex(
+            const char* glFunctionName
+        ) {
+            for (uint32_t i = 0; i < functionTableSize; ++i)
+                if (strcmp(functionTable[i].name, glFunctionName) == 0) return i;
+            return functionTableSize;
+        }
+
+        //Overwritten functions still show up in the call counter
+        #define NULLGL_COUNT_CALL(glFunctionName) { static const uint32_t callIndex = functionIndex(glFunctionName); callCount[callIndex]++; }
+
+        static uint32_t          nextObjectId = 1;
+        static ProgramReflection nextProgramReflection;
+        static map<GLuint, ProgramReflection> programReflection;
+        static map<GLuint, GLint>             programTransformFeedbackVaryingCount; //set by glTransformFeedbackVaryings
+        static map<GLuint, vector<char>>      bufferStorage;
+        static map<GLenum, GLuint>            bufferBinding;
+        static vector<char>                   bufferUnknown;
+        static const char                     programBinary[16] = "nullGl program";
+        static bool                           gpuLag             = false;
+        static uint64_t                       fenceCount         = 0;
+        static uint64_t                       finishedFenceCount = 0;
+        static map<uintptr_t, uint64_t>       fenceSequence; //only with gpuLag
+
+        static int64_t getValue(
+            GLenum   pname,
+            uint32_t index
+        ) {
+            switch (pname) {
+                case GL_MAJOR_VERSION:                              return 4;
+                case GL_MINOR_VERSION:                              return 6;
+                case GL_NUM_EXTENSIONS:                             return 0;
+                case GL_CONTEXT_PROFILE_MASK:                       return GL_CONTEXT_CORE_PROFILE_BIT;
+                case GL_MAX_TEXTURE_SIZE:                           return 16384;
+                case GL_MAX_3D_TEXTURE_SIZE:                        return 2048;
+                case GL_MAX_CUBE_MAP_TEXTURE_SIZE:                  return 16384;
+                case GL_MAX_ARRAY_TEXTURE_LAYERS:                   return 2048;
+                case GL_MAX_RENDERBUFFER_SIZE:                      return 16384;
+                case GL_MAX_DRAW_BUFFERS:                           return 8;
+                case GL_MAX_COLOR_ATTACHMENTS:                      return 8;
+                case GL_MAX_SAMPLES:                                return 8;
+                case GL_MAX_VERTEX_ATTRIBS:                         return 16;
+                case GL_MAX_VERTEX_ATTRIB_BINDINGS:                 return 16;
+                case GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET:          return 2047;
+                case GL_MAX_TEXTURE_IMAGE_UNITS:                    return 32;
+                case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:           return 192;
+                case GL_MAX_IMAGE_UNITS:                            return 8;
+                case GL_MAX_UNIFORM_BUFFER_BINDINGS:                return 84;
+                case GL_MAX_UNIFORM_BLOCK_SIZE:                     return 65536;
+                case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:            return 256;
+                case GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS:         return 16;
+                case GL_MAX_SHADER_STORAGE_BLOCK_SIZE:              return 1 << 27;
+                case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT:     return 16;
+                case GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT:            return 16;
+                case GL_MAX_TEXTURE_BUFFER_SIZE:                    return 1 << 27;
+                case GL_MAX_SERVER_WAIT_TIMEOUT:                    return 0x7FFFFFFF;
+                case GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS:         return 1024;
+                case GL_MAX_COMPUTE_WORK_GROUP_COUNT:               return 65535;
+                case GL_MAX_COMPUTE_WORK_GROUP_SIZE:                return index < 2 ? 1024 : 64;
+                case GL_MAX_COMPUTE_SHARED_MEMORY_SIZE:             return 32768;
+                case GL_MAX_FRAMEBUFFER_WIDTH:                      return 16384;
+                case GL_MAX_FRAMEBUFFER_HEIGHT:                     return 16384;
+                case GL_MAX_FRAMEBUFFER_LAYERS:                     return 2048;
+                case GL_MAX_FRAMEBUFFER_SAMPLES:                    return 8;
+                case GL_MAX_TRANSFORM_FEEDBACK_BUFFERS:             return 4;
+                case GL_MAX_VERTEX_STREAMS:                         return 4;
+                case GL_MAX_DEBUG_MESSAGE_LENGTH:                   return 1024;
+                case GL_MAX_DEBUG_LOGGED_MESSAGES:                  return 64;
+                case GL_MAX_DEBUG_GROUP_STACK_DEPTH:                return 64;
+                case GL_MAX_LABEL_LENGTH:                           return 256;
+                default:                                            return 0;
+            }
+        }
+
+        static void NULLGL_STDCALL glGetIntegerv_(GLenum pname, GLint* data) {
+            NULLGL_COUNT_CALL("glGetIntegerv");
+            *data = GLint(getValue(pname, 0));
+        }
+
+        static void NULLGL_STDCALL glGetIntegeri_v_(GLenum target, GLuint index, GLint* data) {
+            NULLGL_COUNT_CALL("glGetIntegeri_v");
+            *data = GLint(getValue(target, index));
+        }
+
+        static void NULLGL_STDCALL glGetInteger64v_(GLenum pname, GLint64* data) {
+            NULLGL_COUNT_CALL("glGetInteger64v");
+            *data = getValue(pname, 0);
+        }
+
+        static void NULLGL_STDCALL glGetInteger64i_v_(GLenum target, GLuint index, GLint64* data) {
+            NULLGL_COUNT_CALL("glGetInteger64i_v");
+            *data = getValue(target, index);
+        }
+
+        static void NULLGL_STDCALL glGetFloatv_(GLenum pname, GLfloat* data) {
+            NULLGL_COUNT_CALL("glGetFloatv");
+            *data = GLfloat(getValue(pname, 0));
+        }
+
+        static void NULLGL_STDCALL glGetFloati_v_(GLenum target, GLuint index, GLfloat* data) {
+            NULLGL_COUNT_CALL("glGetFloati_v");
+            *data = GLfloat(getValue(target, index));
+        }
+
+        static void NULLGL_STDCALL glGetDoublev_(GLenum pname, GLdouble* data) {
+            NULLGL_COUNT_CALL("glGetDoublev");
+            *data = GLdouble(getValue(pname, 0));
+        }
+
+        static void NULLGL_STDCALL glGetDoublei_v_(GLenum target, GLuint index, GLdouble* data) {
+            NULLGL_COUNT_CALL("glGetDoublei_v");
+            *data = GLdouble(getValue(target, index));
+        }
+
+        static void NULLGL_STDCALL glGetBooleanv_(GLenum pname, GLboolean* data) {
+            NULLGL_COUNT_CALL("glGetBooleanv");
+            *data = getValue(pname, 0) != 0;
+        }
+
+        static const GLubyte* NULLGL_STDCALL glGetString_(GLenum name) {
+            NULLGL_COUNT_CALL("glGetString");
+            const char* s = "";
+            switch (name) {
+                case GL_VENDOR:                   s = "glCompact";             break;
+                case GL_RENDERER:                 s = "null";                  break;
+                case GL_VERSION:                  s = "4.6 glCompact nullGl";  break;
+                case GL_SHADING_LANGUAGE_VERSION: s = "4.60 glCompact nullGl"; break;
+            }
+            return reinterpret_cast<const GLubyte*>(s);
+        }
+
+        static const GLubyte* NULLGL_STDCALL glGetStringi_(GLenum, GLuint) {
+            NULLGL_COUNT_CALL("glGetStringi");
+            return reinterpret_cast<const GLubyte*>("");
+        }
+
+        //Default framebuffer is D24S8 and RGBA8 UNORM
+        static void NULLGL_STDCALL glGetFramebufferAttachmentParameteriv_(GLenum, GLenum attachment, GLenum pname, GLint* params) {
+            NULLGL_COUNT_CALL("glGetFramebufferAttachmentParameteriv");
+            switch (pname) {
+                case GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE:    *params = GL_FRAMEBUFFER_DEFAULT; break;
+                case GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE:     *params = attachment == GL_STENCIL ? 8 : 24; break;
+                case GL_FRAMEBUFFER_ATTACHMENT_RED_SIZE:
+                case GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE:
+                case GL_FRAMEBUFFER_ATTACHMENT_BLUE_SIZE:
+                case GL_FRAMEBUFFER_ATTACHMENT_ALPHA_SIZE:     *params = 8; break;
+                case GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE: *params = attachment == GL_STENCIL ? GL_UNSIGNED_INT : GL_UNSIGNED_NORMALIZED; break;
+                case GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING: *params = GL_LINEAR; break;
+                default:                                       *params = 0;
+            }
+        }
+
+        static GLenum NULLGL_STDCALL glCheckFramebufferStatus_(GLenum) {
+            NULLGL_COUNT_CALL("glCheckFramebufferStatus");
+            return GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        static GLenum NULLGL_STDCALL glCheckNamedFramebufferStatus_(GLuint, GLenum) {
+            NULLGL_COUNT_CALL("glCheckNamedFramebufferStatus");
+            return GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        //OBJECT NAMES
+        static void genObjectIds(GLsizei n, GLuint* ids) {
+            for (GLsizei i = 0; i < n; ++i) ids[i] = nextObjectId++;
+        }
+
+        static void NULLGL_STDCALL glGenBuffers_             (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenBuffers");              genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateBuffers_          (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateBuffers");           genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenTextures_            (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenTextures");             genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateTextures_(GLenum, GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateTextures");          genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenSamplers_            (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenSamplers");             genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateSamplers_         (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateSamplers");          genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenVertexArrays_        (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenVertexArrays");         genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateVertexArrays_     (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateVertexArrays");      genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenFramebuffers_        (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenFramebuffers");         genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateFramebuffers_     (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateFramebuffers");      genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenRenderbuffers_       (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenRenderbuffers");        genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateRenderbuffers_    (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateRenderbuffers");     genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenQueries_             (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenQueries");              genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateQueries_ (GLenum, GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glCreateQueries");           genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glGenTransformFeedbacks_  (GLsizei n, GLuint* ids) {NULLGL_COUNT_CALL("glGenTransformFeedbacks");   genObjectIds(n, ids);}
+        static void NULLGL_STDCALL glCreateTransformFeedbacks_(GLsizei n, GLuint* ids){NULLGL_COUNT_CALL("glCreateTransformFeedbacks");genObjectIds(n, ids);}
+
+        //BUFFER
+        static void allocateBufferStorage(GLuint buffer, GLsizeiptr size, const void* data) {
+            auto& storage = bufferStorage[buffer];
+            storage.assign(size, 0);
+            if (data && size) memcpy(&storage[0], data, size);
+        }
+
+        static void* mapBufferStorage(GLuint buffer, GLintptr offset, GLsizeiptr length) {
+            auto it = bufferStorage.find(buffer);
+            if (it == bufferStorage.end() || size_t(offset + length) > it->second.size()) {
+                //Never hand out a null pointer, even to a buffer we don't know
+                bufferUnknown.resize(max<size_t>(bufferUnknown.size(), length));
+                return bufferUnknown.data();
+            }
+            return it->second.data() + offset;
+        }
+
+        static void NULLGL_STDCALL glDeleteBuffers_(GLsizei n, const GLuint* buffers) {
+            NULLGL_COUNT_CALL("glDeleteBuffers");
+            for (GLsizei i = 0; i < n; ++i) bufferStorage.erase(buffers[i]);
+        }
+
+        static void NULLGL_STDCALL glBindBuffer_(GLenum target, GLuint buffer) {
+            NULLGL_COUNT_CALL("glBindBuffer");
+            bufferBinding[target] = buffer;
+        }
+
+        static void NULLGL_STDCALL glBufferData_(GLenum target, GLsizeiptr size, const void* data, GLenum) {
+            NULLGL_COUNT_CALL("glBufferData");
+            allocateBufferStorage(bufferBinding[target], size, data);
+        }
+
+        static void NULLGL_STDCALL glBufferStorage_(GLenum target, GLsizeiptr size, const void* data, GLbitfield) {
+            NULLGL_COUNT_CALL("glBufferStorage");
+            allocateBufferStorage(bufferBinding[target], size, data);
+        }
+
+        static void NULLGL_STDCALL glNamedBufferData_(GLuint buffer, GLsizeiptr size, const void* data, GLenum) {
+            NULLGL_COUNT_CALL("glNamedBufferData");
+            allocateBufferStorage(buffer, size, data);
+        }
+
+        static void NULLGL_STDCALL glNamedBufferStorage_(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield) {
+            NULLGL_COUNT_CALL("glNamedBufferStorage");
+            allocateBufferStorage(buffer, size, data);
+        }
+
+        static void* NULLGL_STDCALL glMapBufferRange_(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield) {
+            NULLGL_COUNT_CALL("glMapBufferRange");
+            return mapBufferStorage(bufferBinding[target], offset, length);
+        }
+
+        static void* NULLGL_STDCALL glMapNamedBufferRange_(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield) {
+            NULLGL_COUNT_CALL("glMapNamedBufferRange");
+            return mapBufferStorage(buffer, offset, length);
+        }
+
+        static GLboolean NULLGL_STDCALL glUnmapBuffer_(GLenum) {
+            NULLGL_COUNT_CALL("glUnmapBuffer");
+            return GL_TRUE;
+        }
+
+        static GLboolean NULLGL_STDCALL glUnmapNamedBuffer_(GLuint) {
+            NULLGL_COUNT_CALL("glUnmapNamedBuffer");
+            return GL_TRUE;
+        }
+
+        //SYNC AND QUERY (everything is always finished, except fences with setGpuLag)
+        static bool isFenceFinished(GLsync sync) {
+            if (!gpuLag) return true;
+            auto it = fenceSequence.find(reinterpret_cast<uintptr_t>(sync));
+            return it == fenceSequence.end() || it->second <= finishedFenceCount;
+        }
+
+        static GLsync NULLGL_STDCALL glFenceSync_(GLenum, GLbitfield) {
+            NULLGL_COUNT_CALL("glFenceSync");
+            GLsync sync = reinterpret_cast<GLsync>(uintptr_t(nextObjectId++));
+            fenceCount++;
+            if (gpuLag) fenceSequence[reinterpret_cast<uintptr_t>(sync)] = fenceCount;
+            else        finishedFenceCount = fenceCount;
+            return sync;
+        }
+
+        static GLenum NULLGL_STDCALL glClientWaitSync_(GLsync sync, GLbitfield, GLuint64 timeout) {
+            NULLGL_COUNT_CALL("glClientWaitSync");
+            if (isFenceFinished(sync)) return GL_ALREADY_SIGNALED;
+            if (timeout == 0) return GL_TIMEOUT_EXPIRED;
+            finishedFenceCount = fenceSequence[reinterpret_cast<uintptr_t>(sync)];
+            return GL_CONDITION_SATISFIED;
+        }
+
+        static void NULLGL_STDCALL glGetSynciv_(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values) {
+            NULLGL_COUNT_CALL("glGetSynciv");
+            if (length) *length = 1;
+            if (bufSize > 0) *values = pname == GL_SYNC_STATUS ? (isFenceFinished(sync) ? GL_SIGNALED : GL_UNSIGNALED) : 0;
+        }
+
+        static void NULLGL_STDCALL glGetQueryObjectiv_    (GLuint, GLenum pname, GLint*    params) {NULLGL_COUNT_CALL("glGetQueryObjectiv");     *params = pname == GL_QUERY_RESULT_AVAILABLE;}
+        static void NULLGL_STDCALL glGetQueryObjectuiv_   (GLuint, GLenum pname, GLuint*   params) {NULLGL_COUNT_CALL("glGetQueryObjectuiv");    *params = pname == GL_QUERY_RESULT_AVAILABLE;}
+        static void NULLGL_STDCALL glGetQueryObjecti64v_  (GLuint, GLenum pname, GLint64*  params) {NULLGL_COUNT_CALL("glGetQueryObjecti64v");   *params = pname == GL_QUERY_RESULT_AVAILABLE;}
+        static void NULLGL_STDCALL glGetQueryObjectui64v_ (GLuint, GLenum pname, GLuint64* params) {NULLGL_COUNT_CALL("glGetQueryObjectui64v");  *params = pname == GL_QUERY_RESULT_AVAILABLE;}
+
+        //SHADER AND PROGRAM
+        static GLuint NULLGL_STDCALL glCreateShader_(GLenum) {
+            NULLGL_COUNT_CALL("glCreateShader");
+            return nextObjectId++;
+        }
+
+        static void NULLGL_STDCALL glGetShaderiv_(GLuint, GLenum pname, GLint* params) {
+            NULLGL_COUNT_CALL("glGetShaderiv");
+            *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+        }
+
+        static GLuint NULLGL_STDCALL glCreateProgram_() {
+            NULLGL_COUNT_CALL("glCreateProgram");
+            GLuint id = nextObjectId++;
+            programReflection[id] = nextProgramReflection;
+            return id;
+        }
+
+        static void NULLGL_STDCALL glDeleteProgram_(GLuint program) {
+            NULLGL_COUNT_CALL("glDeleteProgram");
+            programReflection.erase(program);
+            programTransformFeedbackVaryingCount.erase(program);
+        }
+
+        static int32_t maxNameLength(const vector<ProgramReflection::Variable>& variableList) {
+            size_t len = 0;
+            for (auto& v : variableList) len = max(len, v.name.size() + 1);
+            return int32_t(len);
+        }
+
+        static int32_t uniformCount(const ProgramReflection& pr) {
+            size_t count = pr.uniform.size();
+            for (auto& ub : pr.uniformBlock) count += ub.member.size();
+            return int32_t(count);
+        }
+
+        //Active uniform index of uniform block members, they are listed after all uniforms of ProgramReflection::uniform
+        static const ProgramReflection::UniformBlockMember* uniformBlockMember(const ProgramReflection& pr, GLuint index) {
+            if (index < pr.uniform.size()) return 0;
+            index -= GLuint(pr.uniform.size());
+            for (auto& ub : pr.uniformBlock) {
+                if (index < ub.member.size()) return &ub.member[index];
+                index -= GLuint(ub.member.size());
+            }
+            return 0;
+        }
+
+        static void NULLGL_STDCALL glTransformFeedbackVaryings_(GLuint program, GLsizei count, const GLchar* const*, GLenum) {
+            NULLGL_COUNT_CALL("glTransformFeedbackVaryings");
+            programTransformFeedbackVaryingCount[program] = count;
+        }
+
+        static void NULLGL_STDCALL glGetProgramiv_(GLuint program, GLenum pname, GLint* params) {
+            NULLGL_COUNT_CALL("glGetProgramiv");
+            const auto& pr = programReflection[program];
+            switch (pname) {
+                case GL_LINK_STATUS:                  *params = GL_TRUE;                         break;
+                case GL_ACTIVE_ATTRIBUTES:            *params = GLint(pr.attribute.size());      break;
+                case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:  *params = maxNameLength(pr.attribute);     break;
+                case GL_ACTIVE_UNIFORMS:              *params = uniformCount(pr);                break;
+                case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+                    *params = maxNameLength(pr.uniform);
+                    for (auto& ub : pr.uniformBlock) for (auto& m : ub.member) *params = max(*params, GLint(m.name.size() + 1));
+                    *params += 3; //for "[0]" of arrays
+                    break;
+                case GL_ACTIVE_UNIFORM_BLOCKS:        *params = GLint(pr.uniformBlock.size());   break;
+                case GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH:
+                    *params = 0;
+                    for (auto& ub : pr.uniformBlock) *params = max(*params, GLint(ub.name.size() + 1));
+                    break;
+                case GL_PROGRAM_BINARY_LENGTH:        *params = sizeof(programBinary);           break;
+                case GL_TRANSFORM_FEEDBACK_VARYINGS:  *params = programTransformFeedbackVaryingCount[program]; break;
+                default:                              *params = 0;
+            }
+        }
+
+        //Every program has the same dummy binary. glProgramBinary stays a stub, a program created from any binary reports the reflection of setProgramReflection().
+        static void NULLGL_STDCALL glGetProgramBinary_(GLuint, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) {
+            NULLGL_COUNT_CALL("glGetProgramBinary");
+            GLsizei size = min<GLsizei>(bufSize, sizeof(programBinary));
+            memcpy(binary, programBinary, size);
+            if (length) *length = size;
+            *binaryFormat = 1;
+        }
+
+        //Only the shader storage blocks of the reflection are reported through the program interface queries. Every other program interface is empty.
+        static void NULLGL_STDCALL glGetProgramInterfaceiv_(GLuint program, GLenum programInterface, GLenum pname, GLint* params) {
+            NULLGL_COUNT_CALL("glGetProgramInterfaceiv");
+            *params = 0;
+            if (programInterface != GL_SHADER_STORAGE_BLOCK) return;
+            const auto& storageBlock = programReflection[program].storageBlock;
+            if (pname == GL_ACTIVE_RESOURCES) *params = GLint(storageBlock.size());
+            if (pname == GL_MAX_NAME_LENGTH)
+                for (auto& sb : storageBlock) *params = max(*params, GLint(sb.name.size() + 1));
+        }
+
+        static void copyName(const string& name, GLsizei bufSize, GLsizei* length, GLchar* nameOut) {
+            if (bufSize == 0) {
+                if (length) *length = 0;
+                return;
+            }
+            GLsizei len = min<GLsizei>(GLsizei(name.size()), bufSize - 1);
+            memcpy(nameOut, name.c_str(), len);
+            nameOut[len] = 0;
+            if (length) *length = len;
+        }
+
+        static void NULLGL_STDCALL glGetActiveAttrib_(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+            NULLGL_COUNT_CALL("glGetActiveAttrib");
+            const auto& v = programReflection[program].attribute.at(index);
+            *size = v.arraySize;
+            *type = v.type;
+            copyName(v.name, bufSize, length, name);
+        }
+
+        static GLint NULLGL_STDCALL glGetAttribLocation_(GLuint program, const GLchar* name) {
+            NULLGL_COUNT_CALL("glGetAttribLocation");
+            for (auto& v : programReflection[program].attribute)
+                if (v.name == name) return v.location;
+            return -1;
+        }
+
+        static void NULLGL_STDCALL glGetActiveUniform_(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+            NULLGL_COUNT_CALL("glGetActiveUniform");
+            const auto& pr = programReflection[program];
+            if (auto m = uniformBlockMember(pr, index)) {
+                *size = m->arraySize;
+                *type = m->type;
+                copyName(m->arraySize > 1 ? m->name + "[0]" : m->name, bufSize, length, name);
+                return;
+            }
+            const auto& v = pr.uniform.at(index);
+            *size = v.arraySize;
+            *type = v.type;
+            copyName(v.arraySize > 1 ? v.name + "[0]" : v.name, bufSize, length, name);
+        }
+
+        static void NULLGL_STDCALL glGetActiveUniformBlockName_(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei* length, GLchar* uniformBlockName) {
+            NULLGL_COUNT_CALL("glGetActiveUniformBlockName");
+            copyName(programReflection[program].uniformBlock.at(uniformBlockIndex).name, bufSize, length, uniformBlockName);
+        }
+
+        static GLuint NULLGL_STDCALL glGetUniformBlockIndex_(GLuint program, const GLchar* uniformBlockName) {
+            NULLGL_COUNT_CALL("glGetUniformBlockIndex");
+            const auto& uniformBlock = programReflection[program].uniformBlock;
+            for (size_t i = 0; i < uniformBlock.size(); ++i)
+                if (uniformBlock[i].name == uniformBlockName) return GLuint(i);
+            return GL_INVALID_INDEX;
+        }
+
+        //Uniform blocks never report a layout qualifier binding
+        static void NULLGL_STDCALL glGetActiveUniformBlockiv_(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params) {
+            NULLGL_COUNT_CALL("glGetActiveUniformBlockiv");
+            const auto& pr = programReflection[program];
+            const auto& ub = pr.uniformBlock.at(uniformBlockIndex);
+            GLint firstIndex = GLint(pr.uniform.size());
+            for (GLuint i = 0; i < uniformBlockIndex; ++i) firstIndex += GLint(pr.uniformBlock[i].member.size());
+            switch (pname) {
+                case GL_UNIFORM_BLOCK_DATA_SIZE:              *params = ub.dataSize;                       break;
+                case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS:        *params = GLint(ub.member.size());           break;
+                case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES: for (size_t i = 0; i < ub.member.size(); ++i) params[i] = firstIndex + GLint(i); break;
+                default:                                      *params = 0;
+            }
+        }
+
+        static void NULLGL_STDCALL glGetActiveUniformsiv_(GLuint program, GLsizei uniformCount, const GLuint* uniformIndices, GLenum pname, GLint* params) {
+            NULLGL_COUNT_CALL("glGetActiveUniformsiv");
+            const auto& pr = programReflection[program];
+            for (GLsizei i = 0; i < uniformCount; ++i) {
+                params[i] = pname == GL_UNIFORM_OFFSET || pname == GL_UNIFORM_BLOCK_INDEX ? -1 : 0;
+                auto m = uniformBlockMember(pr, uniformIndices[i]);
+                if (!m) continue;
+                switch (pname) {
+                    case GL_UNIFORM_OFFSET:        params[i] = m->offset;       break;
+                    case GL_UNIFORM_ARRAY_STRIDE:  params[i] = m->arrayStride;  break;
+                    case GL_UNIFORM_MATRIX_STRIDE: params[i] = m->matrixStride; break;
+                }
+            }
+        }
+
+        //Buffer variable resource index = storage block index * 256 + variable index. Blocks without variables report a single unsized uint array "data[]".
+        static const ProgramReflection::StorageBlockVariable defaultStorageBlockVariable = {"data[0]", GL_UNSIGNED_INT, 0, 0, 4, 0, 0, 0};
+
+        static const ProgramReflection::StorageBlockVariable& storageBlockVariable(const ProgramReflection& pr, GLuint index) {
+            const auto& sb = pr.storageBlock.at(index / 256);
+            return sb.variable.empty() ? defaultStorageBlockVariable : sb.variable.at(index % 256);
+        }
+
+        static void NULLGL_STDCALL glGetProgramResourceName_(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) {
+            NULLGL_COUNT_CALL("glGetProgramResourceName");
+            const auto& pr = programReflection[program];
+            if (programInterface == GL_SHADER_STORAGE_BLOCK) copyName(pr.storageBlock.at(index).name,       bufSize, length, name);
+            else                                             copyName(storageBlockVariable(pr, index).name, bufSize, length, name);
+        }
+
+        static void NULLGL_STDCALL glGetProgramResourceiv_(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params) {
+            NULLGL_COUNT_CALL("glGetProgramResourceiv");
+            const auto& pr = programReflection[program];
+            //GL_ACTIVE_VARIABLES returns one value per variable
+            if (programInterface == GL_SHADER_STORAGE_BLOCK && propCount == 1 && props[0] == GL_ACTIVE_VARIABLES) {
+                GLsizei count = min(max<GLsizei>(GLsizei(pr.storageBlock.at(index).variable.size()), 1), bufSize);
+                for (GLsizei i = 0; i < count; ++i) params[i] = GLint(index * 256 + i);
+                if (length) *length = count;
+                return;
+            }
+            GLsizei count = min(propCount, bufSize);
+            for (GLsizei i = 0; i < count; ++i) {
+                params[i] = 0;
+                if (programInterface == GL_SHADER_STORAGE_BLOCK) {
+                    const auto& sb = pr.storageBlock.at(index);
+                    if (props[i] == GL_NUM_ACTIVE_VARIABLES) params[i] = max<GLint>(GLint(sb.variable.size()), 1);
+                    if (props[i] == GL_BUFFER_BINDING)       params[i] = sb.binding;
+                } else if (programInterface == GL_BUFFER_VARIABLE) {
+                    const auto& v = storageBlockVariable(pr, index);
+                    switch (props[i]) {
+                        case GL_NAME_LENGTH:            params[i] = GLint(v.name.size() + 1); break;
+                        case GL_TYPE:                   params[i] = GLint(v.type);            break;
+                        case GL_ARRAY_SIZE:             params[i] = v.arraySize;              break;
+                        case GL_OFFSET:                 params[i] = v.offset;                 break;
+                        case GL_ARRAY_STRIDE:           params[i] = v.arrayStride;            break;
+                        case GL_MATRIX_STRIDE:          params[i] = v.matrixStride;           break;
+                        case GL_TOP_LEVEL_ARRAY_SIZE:   params[i] = v.topLevelArraySize;      break;
+                        case GL_TOP_LEVEL_ARRAY_STRIDE: params[i] = v.topLevelArrayStride;    break;
+                    }
+                }
+            }
+            if (length) *length = count;
+        }
+
+        static GLint NULLGL_STDCALL glGetUniformLocation_(GLuint program, const GLchar* name) {
+            NULLGL_COUNT_CALL("glGetUniformLocation");
+            string s(name);
+            int32_t arrayIndex = 0;
+            auto bracket = s.find('[');
+            if (bracket != string::npos) {
+                arrayIndex = atoi(s.c_str() + bracket + 1);
+                s = s.substr(0, bracket);
+            }
+            for (auto& v : programReflection[program].uniform)
+                if (v.name == s && arrayIndex < max(v.arraySize, 1)) return v.location + arrayIndex;
+            return -1;
+        }
+
+        //All uniforms read back as 0, so samplers/images never report a layout qualifier binding
+        static void NULLGL_STDCALL glGetUniformiv_(GLuint, GLint, GLint* params) {
+            NULLGL_COUNT_CALL("glGetUniformiv");
+            *params = 0;
+        }
+
+        static void NULLGL_STDCALL glGetUniformuiv_(GLuint, GLint, GLuint* params) {
+            NULLGL_COUNT_CALL("glGetUniformuiv");
+            *params = 0;
+        }
+
+        static void NULLGL_STDCALL glGetUniformfv_(GLuint, GLint, GLfloat* params) {
+            NULLGL_COUNT_CALL("glGetUniformfv");
+            *params = 0;
+        }
+
+        static void NULLGL_STDCALL glGetUniformdv_(GLuint, GLint, GLdouble* params) {
+            NULLGL_COUNT_CALL("glGetUniformdv");
+            *params = 0;
+        }
+
+        static const FunctionTableEntry overwriteTable[] = {
+            #define NULLGL_OVERWRITE(glFunctionName, PROC) {#glFunctionName, reinterpret_cast<void*>(static_cast<PROC>(&glFunctionName##_))}
+            NULLGL_OVERWRITE(glGetIntegerv,                         GLGETINTEGERVPROC),
+            NULLGL_OVERWRITE(glGetIntegeri_v,                       GLGETINTEGERI_VPROC),
+            NULLGL_OVERWRITE(glGetInteger64v,                       GLGETINTEGER64VPROC),
+            NULLGL_OVERWRITE(glGetInteger64i_v,                     GLGETINTEGER64I_VPROC),
+            NULLGL_OVERWRITE(glGetFloatv,                           GLGETFLOATVPROC),
+            NULLGL_OVERWRITE(glGetFloati_v,                         GLGETFLOATI_VPROC),
+            NULLGL_OVERWRITE(glGetDoublev,                          GLGETDOUBLEVPROC),
+            NULLGL_OVERWRITE(glGetDoublei_v,                        GLGETDOUBLEI_VPROC),
+            NULLGL_OVERWRITE(glGetBooleanv,                         GLGETBOOLEANVPROC),
+            NULLGL_OVERWRITE(glGetString,                           GLGETSTRINGPROC),
+            NULLGL_OVERWRITE(glGetStringi,                          GLGETSTRINGIPROC),
+            NULLGL_OVERWRITE(glGetFramebufferAttachmentParameteriv, GLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC),
+            NULLGL_OVERWRITE(glCheckFramebufferStatus,              GLCHECKFRAMEBUFFERSTATUSPROC),
+            NULLGL_OVERWRITE(glCheckNamedFramebufferStatus,         GLCHECKNAMEDFRAMEBUFFERSTATUSPROC),
+            NULLGL_OVERWRITE(glGenBuffers,                          GLGENBUFFERSPROC),
+            NULLGL_OVERWRITE(glCreateBuffers,                       GLCREATEBUFFERSPROC),
+            NULLGL_OVERWRITE(glGenTextures,                         GLGENTEXTURESPROC),
+            NULLGL_OVERWRITE(glCreateTextures,                      GLCREATETEXTURESPROC),
+            NULLGL_OVERWRITE(glGenSamplers,                         GLGENSAMPLERSPROC),
+            NULLGL_OVERWRITE(glCreateSamplers,                      GLCREATESAMPLERSPROC),
+            NULLGL_OVERWRITE(glGenVertexArrays,                     GLGENVERTEXARRAYSPROC),
+            NULLGL_OVERWRITE(glCreateVertexArrays,                  GLCREATEVERTEXARRAYSPROC),
+            NULLGL_OVERWRITE(glGenFramebuffers,                     GLGENFRAMEBUFFERSPROC),
+            NULLGL_OVERWRITE(glCreateFramebuffers,                  GLCREATEFRAMEBUFFERSPROC),
+            NULLGL_OVERWRITE(glGenRenderbuffers,                    GLGENRENDERBUFFERSPROC),
+            NULLGL_OVERWRITE(glCreateRenderbuffers,                 GLCREATERENDERBUFFERSPROC),
+            NULLGL_OVERWRITE(glGenQueries,                          GLGENQUERIESPROC),
+            NULLGL_OVERWRITE(glCreateQueries,                       GLCREATEQUERIESPROC),
+            NULLGL_OVERWRITE(glGenTransformFeedbacks,               GLGENTRANSFORMFEEDBACKSPROC),
+            NULLGL_OVERWRITE(glCreateTransformFeedbacks,            GLCREATETRANSFORMFEEDBACKSPROC),
+            NULLGL_OVERWRITE(glDeleteBuffers,                       GLDELETEBUFFERSPROC),
+            NULLGL_OVERWRITE(glBindBuffer,                          GLBINDBUFFERPROC),
+            NULLGL_OVERWRITE(glBufferData,                          GLBUFFERDATAPROC),
+            NULLGL_OVERWRITE(glBufferStorage,                       GLBUFFERSTORAGEPROC),
+            NULLGL_OVERWRITE(glNamedBufferData,                     GLNAMEDBUFFERDATAPROC),
+            NULLGL_OVERWRITE(glNamedBufferStorage,                  GLNAMEDBUFFERSTORAGEPROC),
+            NULLGL_OVERWRITE(glMapBufferRange,                      GLMAPBUFFERRANGEPROC),
+            NULLGL_OVERWRITE(glMapNamedBufferRange,                 GLMAPNAMEDBUFFERRANGEPROC),
+            NULLGL_OVERWRITE(glUnmapBuffer,                         GLUNMAPBUFFERPROC),
+            NULLGL_OVERWRITE(glUnmapNamedBuffer,                    GLUNMAPNAMEDBUFFERPROC),
+            NULLGL_OVERWRITE(glFenceSync,                           GLFENCESYNCPROC),
+            NULLGL_OVERWRITE(glClientWaitSync,                      GLCLIENTWAITSYNCPROC),
+            NULLGL_OVERWRITE(glGetSynciv,                           GLGETSYNCIVPROC),
+            NULLGL_OVERWRITE(glGetQueryObjectiv,                    GLGETQUERYOBJECTIVPROC),
+            NULLGL_OVERWRITE(glGetQueryObjectuiv,                   GLGETQUERYOBJECTUIVPROC),
+            NULLGL_OVERWRITE(glGetQueryObjecti64v,                  GLGETQUERYOBJECTI64VPROC),
+            NULLGL_OVERWRITE(glGetQueryObjectui64v,                 GLGETQUERYOBJECTUI64VPROC),
+            NULLGL_OVERWRITE(glCreateShader,                        GLCREATESHADERPROC),
+            NULLGL_OVERWRITE(glGetShaderiv,                         GLGETSHADERIVPROC),
+            NULLGL_OVERWRITE(glCreateProgram,                       GLCREATEPROGRAMPROC),
+            NULLGL_OVERWRITE(glDeleteProgram,                       GLDELETEPROGRAMPROC),
+            NULLGL_OVERWRITE(glGetProgramiv,                        GLGETPROGRAMIVPROC),
+            NULLGL_OVERWRITE(glTransformFeedbackVaryings,           GLTRANSFORMFEEDBACKVARYINGSPROC),
+            NULLGL_OVERWRITE(glGetProgramInterfaceiv,               GLGETPROGRAMINTERFACEIVPROC),
+            NULLGL_OVERWRITE(glGetProgramResourceName,              GLGETPROGRAMRESOURCENAMEPROC),
+            NULLGL_OVERWRITE(glGetProgramResourceiv,                GLGETPROGRAMRESOURCEIVPROC),
+            NULLGL_OVERWRITE(glGetProgramBinary,                    GLGETPROGRAMBINARYPROC),
+            NULLGL_OVERWRITE(glGetActiveAttrib,                     GLGETACTIVEATTRIBPROC),
+            NULLGL_OVERWRITE(glGetAttribLocation,                   GLGETATTRIBLOCATIONPROC),
+            NULLGL_OVERWRITE(glGetActiveUniform,                    GLGETACTIVEUNIFORMPROC),
+            NULLGL_OVERWRITE(glGetActiveUniformBlockName,           GLGETACTIVEUNIFORMBLOCKNAMEPROC),
+            NULLGL_OVERWRITE(glGetUniformBlockIndex,                GLGETUNIFORMBLOCKINDEXPROC),
+            NULLGL_OVERWRITE(glGetActiveUniformBlockiv,             GLGETACTIVEUNIFORMBLOCKIVPROC),
+            NULLGL_OVERWRITE(glGetActiveUniformsiv,                 GLGETACTIVEUNIFORMSIVPROC),
+            NULLGL_OVERWRITE(glGetUniformLocation,                  GLGETUNIFORMLOCATIONPROC),
+            NULLGL_OVERWRITE(glGetUniformiv,                        GLGETUNIFORMIVPROC),
+            NULLGL_OVERWRITE(glGetUniformuiv,                       GLGETUNIFORMUIVPROC),
+            NULLGL_OVERWRITE(glGetUniformfv,                        GLGETUNIFORMFVPROC),
+            NULLGL_OVERWRITE(glGetUniformdv,                        GLGETUNIFORMDVPROC),
+            #undef NULLGL_OVERWRITE
+        };
+
+        void* getGlFunctionPointer(
+            const char* glFunctionName
+        ) {
+            for (auto& entry : overwriteTable)
+                if (strcmp(entry.name, glFunctionName) == 0) return entry.pointer;
+            uint32_t i = functionIndex(glFunctionName);
+            return i < functionTableSize ? functionTable[i].pointer : nullptr;
+        }
+
+        /**
+            \brief Reflection information that every program created after this call reports
+        */
+        void setProgramReflection(
+            const ProgramReflection& programReflection
+        ) {
+            nextProgramReflection = programReflection;
+        }
+
+        uint64_t getCallCount() {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < functionTableSize; ++i) sum += callCount[i];
+            return sum;
+        }
+
+        uint64_t getCallCount(
+            const char* glFunctionName
+        ) {
+            uint32_t i = functionIndex(glFunctionName);
+            return i < functionTableSize ? callCount[i] : 0;
+        }
+
+        /**
+            \brief List of all functions that got called at last once, sorted by call count
+        */
+        vector<pair<string, uint64_t>> getCallCountList() {
+            vector<pair<string, uint64_t>> list;
+            for (uint32_t i = 0; i < functionTableSize; ++i)
+                if (callCount[i]) list.emplace_back(functionTable[i].name, callCount[i]);
+            sort(list.begin(), list.end(), [](const pair<string, uint64_t>& a, const pair<string, uint64_t>& b) {
+                return a.second > b.second;
+            });
+            return list;
+        }
+
+        void resetCallCount() {
+            for (uint32_t i = 0; i < functionTableSize; ++i) callCount[i] = 0;
+        }
+
+        void setGpuLag(
+            bool enable
+        ) {
+            gpuLag             = enable;
+            finishedFenceCount = fenceCount;
+            fenceSequence.clear();
+        }
+
+        uint64_t getFenceCount() {
+            return fenceCount;
+        }
+
+        uint64_t getFinishedFenceCount() {
+            return finishedFenceCount;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace glCompact {
+    /*
+        Null OpenGL backend
+
+        Hands out a stub for every OpenGL function in gl.xml. The stubs do nothing but count the call.
+        Queries needed to initialize glCompact (version, limits, default framebuffer format, shader reflection, object names, buffer mapping)
+        return plausible values of a OpenGL 4.6 core context without any extensions.
+
+        This is used to measure the pure CPU overhead of glCompact without a GPU, driver or window.
+
+            ContextScope contextScope(nullGl::getGlFunctionPointer);
+
+        There is no real shader compiler. The reflection information every newly created program reports is set via setProgramReflection().
+    */
+    namespace nullGl {
+        struct ProgramReflection {
+            struct Variable {
+                std::string name;
+                uint32_t    type;
+                int32_t     arraySize;
+                int32_t     location;
+            };
+            struct StorageBlockVariable {
+                std::string name;
+                uint32_t    type;
+                int32_t     arraySize;
+                int32_t     offset;
+                int32_t     arrayStride;
+                int32_t     matrixStride;
+                int32_t     topLevelArraySize;
+                int32_t     topLevelArrayStride;
+            };
+            struct StorageBlock {
+                std::string                       name;
+                int32_t                           binding;
+                std::vector<StorageBlockVariable> variable; //empty reports a single unsized uint array "data[]"
+            };
+            struct UniformBlockMember {
+                std::string name;
+                uint32_t    type;
+                int32_t     arraySize;
+                int32_t     offset;
+                int32_t     arrayStride;
+                int32_t     matrixStride;
+            };
+            struct UniformBlock {
+                std::string                     name;
+                int32_t                         dataSize;
+                std::vector<UniformBlockMember> member; //active uniforms with location -1, listed after all uniforms
+            };
+            std::vector<Variable>     attribute;
+            std::vector<Variable>     uniform;
+            std::vector<StorageBlock> storageBlock;
+            std::vector<UniformBlock> uniformBlock;
+        };
+
+        void* getGlFunctionPointer(const char* glFunctionName);
+
+        void setProgramReflection(const ProgramReflection& programReflection);
+
+        uint64_t getCallCount();
+        uint64_t getCallCount(const char* glFunctionName);
+        std::vector<std::pair<std::string, uint64_t>> getCallCountList();
+        void     resetCallCount();
+
+        //With GPU lag a fence only gets signaled when the CPU waits on it (glClientWaitSync with a timeout). Commands issued before the last
+        //fence that got waited on count as finished, everything after it as still executing. Without GPU lag every fence is always signaled.
+        void     setGpuLag(bool enable);
+        uint64_t getFenceCount();         //fences created so far
+        uint64_t getFinishedFenceCount(); //fences created so far that count as finished by the GPU
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "glCompact/gl/FunctionsTypedef.hpp"
+
+#include <cstdint>
+
+namespace glCompact {
+    namespace nullGl {
+        #if defined(_WIN32)
+            #define NULLGL_STDCALL __stdcall
+        #else
+            #define NULLGL_STDCALL
+        #endif
+
+        struct FunctionTableEntry {
+            const char* name;
+            void*       pointer;
+        };
+
+        //Generated from gl.xml, one entry for every function. Index into this table is also the index into callCount.
+        extern const FunctionTableEntry functionTable[];
+        extern const uint32_t           functionTableSize;
+        extern uint64_t                 callCount[];
+
+        /*
+            Generic stub for every function in gl.xml. Only counts the call and returns a value initialized return type.
+            Partial specialization on the PROC typedef, so the stub has exactly the same signature and calling convention as the real function.
+        */
+        template<uint32_t index, typename F>
+        struct Stub;
+
+        template<uint32_t index, typename R, typename... A>
+        struct Stub<index, R(NULLGL_STDCALL*)(A...)> {
+            static R NULLGL_STDCALL call(A...) {
+                callCount[index]++;
+                return R();
+            }
+        };
+    }
+}
@@ -0,0 +1,1162 @@
+#include "NullGl.hpp"
+#include "glCompact/glCompact.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <cmath>
+#if defined(_WIN32)
+    #include <direct.h>
+    #include <io.h>
+    #include <process.h>
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+#endif
+
+/*
+    glCompact_bench
+
+    Measures the CPU overhead of glCompact per draw call. Runs against the null OpenGL backend (NullGl.hpp), so no GPU, driver or window is involved.
+    Everything measured is glCompact state tracking (processPendingChanges, Context_ cached* functions, UniformSetter) plus the cost of calling the stubs.
+
+    Usage: glCompact_bench [drawCount] [-v]
+        drawCount  draws per scenario (default 1000000)
+        -v         also list the OpenGL functions called in each scenario
+                   (and the elided/forwarded state checks, if GLCOMPACT_STATISTICS is defined in config.hpp)
+
+    After the draw scenarios drawCount random free+allocate pairs of BufferGpuAllocator are measured,
+    then DepthPyramid builds at different resolutions, CPU vs GPU culling of 100000 objects, UniformSetter lookups in a pipeline with 512 uniforms
+    and the creation of pipelines with and without the program cache.
+    The cache files are written to a new directory in $TMPDIR (or $TEMP, /tmp) that gets removed at exit, so every run starts with an empty cache.
+*/
+
+using namespace std;
+using namespace glm;
+using namespace glCompact;
+
+static const string vertexShader = R"""(
+    #version 330
+    layout(location = 0) in vec2 position;
+    void main() {
+        gl_Position = vec4(position.x, position.y, 0.0, 1.0);
+    }
+)""";
+
+static const string fragmentShader = R"""(
+    #version 330
+    uniform vec4 rgba;
+    uniform sampler2D texture_binding0;
+    uniform sampler2D texture_binding1;
+    uniform sampler2D texture_binding2;
+    uniform sampler2D texture_binding3;
+    out vec4 outputColor;
+    void main() {
+        outputColor = rgba
+            * texture(texture_binding0, vec2(0.5))
+            * texture(texture_binding1, vec2(0.5))
+            * texture(texture_binding2, vec2(0.5))
+            * texture(texture_binding3, vec2(0.5));
+    }
+)""";
+
+//Stand-in for a skinning or tessellation pass whose output gets reused by several draws
+static const string captureVertexShader = R"""(
+    #version 330
+    layout(location = 0) in vec2 position;
+    out vec2 outPosition;
+    void main() {
+        outPosition = position * 0.5;
+    }
+)""";
+
+class BenchPipeline : public PipelineRasterization {
+    public:
+        using PipelineRasterization::PipelineRasterization;
+        UniformSetter<vec4> rgba{this, "rgba"};
+};
+
+//What the null backend reports as active attributes/uniforms for the shaders above
+static nullGl::ProgramReflection getBenchProgramReflection() {
+    const uint32_t glFloatVec2 = 0x8B50;
+    const uint32_t glFloatVec4 = 0x8B52;
+    const uint32_t glSampler2d = 0x8B5E;
+    nullGl::ProgramReflection programReflection;
+    programReflection.attribute = {
+        {"position",         glFloatVec2, 1, 0}
+    };
+    programReflection.uniform = {
+        {"rgba",             glFloatVec4, 1, 0},
+        {"texture_binding0", glSampler2d, 1, 1},
+        {"texture_binding1", glSampler2d, 1, 2},
+        {"texture_binding2", glSampler2d, 1, 3},
+        {"texture_binding3", glSampler2d, 1, 4}
+    };
+    return programReflection;
+}
+
+//What the null backend reports for the compute shader of TextureInterface::generateMipmapsViaPipelineCompute()
+static nullGl::ProgramReflection getMipmapProgramReflection() {
+    const uint32_t glInt       = 0x1404;
+    const uint32_t glSampler2d = 0x8B5E;
+    const uint32_t glImage2d   = 0x904D;
+    nullGl::ProgramReflection programReflection;
+    programReflection.uniform = {
+        {"srcLod",              glInt,       1, 0},
+        {"levelCount",          glInt,       1, 1},
+        {"srcTexture_binding0", glSampler2d, 1, 2},
+        {"dstImage_binding0",   glImage2d,   1, 3},
+        {"dstImage_binding1",   glImage2d,   1, 4},
+        {"dstImage_binding2",   glImage2d,   1, 5},
+        {"dstImage_binding3",   glImage2d,   1, 6}
+    };
+    return programReflection;
+}
+
+//What the null backend reports for the compute shader of PipelineComputeCulling
+static nullGl::ProgramReflection getCullingProgramReflection() {
+    const uint32_t glInt       = 0x1404;
+    const uint32_t glUint      = 0x1405;
+    const uint32_t glFloatMat4 = 0x8B5C;
+    const uint32_t glSampler2d = 0x8B5E;
+    nullGl::ProgramReflection programReflection;
+    programReflection.uniform = {
+        {"objectCount",           glUint,      1, 0},
+        {"viewProjection",        glFloatMat4, 1, 1},
+        {"hiZ",                   glInt,       1, 2},
+        {"depthZeroToOne",        glInt,       1, 3},
+        {"depthReversed",         glInt,       1, 4},
+        {"depthPyramid_binding0", glSampler2d, 1, 5}
+    };
+    programReflection.storageBlock = {
+        {"objectBuffer",  0, {}},
+        {"commandBuffer", 1, {}},
+        {"countBuffer",   2, {}}
+    };
+    return programReflection;
+}
+
+//Per object values, set as single uniforms or written into the uniform block Object_binding0
+class ObjectPipeline : public PipelineRasterization {
+    public:
+        using PipelineRasterization::PipelineRasterization;
+        UniformSetter<mat4>  model    {this, "model"};
+        UniformSetter<vec4>  rgba     {this, "rgba"};
+        UniformSetter<float> roughness{this, "roughness"};
+};
+
+class ObjectBlock : public UniformBlockLayout {
+    public:
+        using UniformBlockLayout::UniformBlockLayout;
+        Member<mat4>  model    {this, "model"};
+        Member<vec4>  rgba     {this, "rgba"};
+        Member<float> roughness{this, "roughness"};
+};
+
+//The same block as C++ struct, that gets uploaded as it is
+struct ObjectStd140 {
+    GLCOMPACT_BLOCK_LAYOUT(std140);
+    GLCOMPACT_BLOCK_MEMBER(mat4,  model);
+    GLCOMPACT_BLOCK_MEMBER(vec4,  rgba);
+    GLCOMPACT_BLOCK_MEMBER(float, roughness);
+};
+static_assert(offsetof(ObjectStd140, roughness) == 80 && sizeof(ObjectStd140) == 96, "ObjectStd140 does not follow std140");
+
+//Element of layout(std430) buffer Light_binding0 {Light light[];} with struct Light {vec3 position; float radius; vec3 color; uint flags;}
+struct Light {
+    GLCOMPACT_BLOCK_LAYOUT(std430);
+    GLCOMPACT_BLOCK_MEMBER(vec3,     position);
+    GLCOMPACT_BLOCK_MEMBER(float,    radius);
+    GLCOMPACT_BLOCK_MEMBER(vec3,     color);
+    GLCOMPACT_BLOCK_MEMBER(uint32_t, flags);
+};
+static_assert(offsetof(Light, color) == 16 && sizeof(Light) == 32, "Light does not follow std430");
+
+//What the null backend reports for ObjectPipeline, or with block for the std140 block layout(std140) uniform Object_binding0 {mat4 model; vec4 rgba; float roughness;}
+static nullGl::ProgramReflection getObjectProgramReflection(
+    bool block
+) {
+    const uint32_t glFloat     = 0x1406;
+    const uint32_t glFloatVec2 = 0x8B50;
+    const uint32_t glFloatVec4 = 0x8B52;
+    const uint32_t glFloatMat4 = 0x8B5C;
+    nullGl::ProgramReflection programReflection;
+    programReflection.attribute = {
+        {"position", glFloatVec2, 1, 0}
+    };
+    if (block) {
+        programReflection.uniformBlock = {
+            {"Object_binding0", 96, {
+                {"model",     glFloatMat4, 1,  0, 0, 16},
+                {"rgba",      glFloatVec4, 1, 64, 0,  0},
+                {"roughness", glFloat,     1, 80, 0,  0}
+            }}
+        };
+    } else {
+        programReflection.uniform = {
+            {"model",     glFloatMat4, 1, 0},
+            {"rgba",      glFloatVec4, 1, 1},
+            {"roughness", glFloat,     1, 2}
+        };
+    }
+    return programReflection;
+}
+
+//What the null backend reports for a pipeline with the storage block Light_binding0
+static nullGl::ProgramReflection getLightProgramReflection() {
+    const uint32_t glFloat     = 0x1406;
+    const uint32_t glFloatVec2 = 0x8B50;
+    const uint32_t glFloatVec3 = 0x8B51;
+    const uint32_t glUint      = 0x1405;
+    nullGl::ProgramReflection programReflection;
+    programReflection.attribute = {
+        {"position", glFloatVec2, 1, 0}
+    };
+    programReflection.storageBlock = {
+        {"Light_binding0", 0, {
+            {"light[0].position", glFloatVec3, 1,  0, 0, 0, 0, 32},
+            {"light[0].radius",   glFloat,     1, 12, 0, 0, 0, 32},
+            {"light[0].color",    glFloatVec3, 1, 16, 0, 0, 0, 32},
+            {"light[0].flags",    glUint,      1, 28, 0, 0, 0, 32}
+        }}
+    };
+    return programReflection;
+}
+
+//Stand-in for big material pipelines, UniformSetter members are constructed by lookup()
+class ManyUniformPipeline : public PipelineRasterization {
+    public:
+        using PipelineRasterization::PipelineRasterization;
+        void lookup(const string& uniformName) {
+            UniformSetter<float> uniform{this, uniformName};
+        }
+};
+
+//What the null backend reports for ManyUniformPipeline, uniformCount float uniforms named uniform0, uniform1, ...
+static nullGl::ProgramReflection getManyUniformProgramReflection(
+    uint32_t uniformCount
+) {
+    const uint32_t glFloat     = 0x1406;
+    const uint32_t glFloatVec2 = 0x8B50;
+    nullGl::ProgramReflection programReflection;
+    programReflection.attribute = {
+        {"position", glFloatVec2, 1, 0}
+    };
+    for (uint32_t i = 0; i < uniformCount; ++i)
+        programReflection.uniform.push_back({"uniform" + to_string(i), glFloat, 1, int32_t(i)});
+    return programReflection;
+}
+
+static uint32_t drawCount = 1000000;
+static bool     verbose   = false;
+
+template<typename F>
+static void runScenario(
+    const char* name,
+    F           drawFunc
+) {
+    for (uint32_t i = 0; i < drawCount / 10; ++i) drawFunc(i);
+    nullGl::resetCallCount();
+    resetStatistics();
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < drawCount; ++i) drawFunc(i);
+    auto end   = chrono::steady_clock::now();
+
+    double ns             = double(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    double glCallsPerDraw = double(nullGl::getCallCount()) / double(drawCount);
+    cout << "  " << left << setw(30) << name
+         << right << setw(10) << fixed << setprecision(1) << ns / double(drawCount)
+         << setw(16) << setprecision(2) << glCallsPerDraw << endl;
+    if (verbose)
+        for (auto& entry : nullGl::getCallCountList())
+            cout << "      " << left << setw(40) << entry.first << right << setw(10) << setprecision(2) << double(entry.second) / double(drawCount) << endl;
+    //getStatistics() stays empty without GLCOMPACT_STATISTICS, then only the call counts are listed
+    if (verbose) {
+        Statistics statistics = getStatistics();
+        bool hasStateCheck = false;
+        for (uint32_t i = 0; i < uint32_t(StatisticsCategory::count); ++i) {
+            auto& stateCheck = statistics.stateCheck[i];
+            if (!stateCheck.elided && !stateCheck.forwarded) continue;
+            if (!hasStateCheck) cout << "      " << left << setw(40) << "state checks (elided/forwarded per draw)" << endl;
+            hasStateCheck = true;
+            cout << "      " << left << setw(30) << Statistics::getCategoryName(StatisticsCategory(i))
+                 << right << setw(10) << setprecision(2) << double(stateCheck.elided) / double(drawCount)
+                 << setw(10) << double(stateCheck.forwarded) / double(drawCount) << endl;
+        }
+    }
+}
+
+//Creates pipelineCount pipelines with different vertex shader sources and reports the time and OpenGL calls per created pipeline
+static void runPipelineCreation(
+    const char*         name,
+    uint32_t            pipelineCount,
+    PipelineCompileMode compileMode = PipelineCompileMode::blocking
+) {
+    nullGl::resetCallCount();
+    resetProgramCacheCounter();
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < pipelineCount; ++i) {
+        BenchPipeline pipeline(Primitive::triangles, vertexShader + "//" + to_string(i) + "\n", "", "", "", fragmentShader, compileMode);
+        pipeline.isReady();
+    }
+    auto end   = chrono::steady_clock::now();
+
+    double us                 = double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0;
+    double glCallsPerPipeline = double(nullGl::getCallCount()) / double(pipelineCount);
+    ProgramCacheCounter programCacheCounter = getProgramCacheCounter();
+    cout << "  " << left << setw(30) << name
+         << right << setw(10) << fixed << setprecision(1) << us / double(pipelineCount)
+         << setw(16) << setprecision(2) << glCallsPerPipeline
+         << setw(8) << programCacheCounter.hit << setw(8) << programCacheCounter.miss << endl;
+    if (verbose)
+        for (auto& entry : nullGl::getCallCountList())
+            cout << "      " << left << setw(40) << entry.first << right << setw(10) << setprecision(2) << double(entry.second) / double(pipelineCount) << endl;
+}
+
+//Like runPipelineCreation, but compiling and linking happens on a PipelineCompiler worker. Only the render thread part (constructing the pipeline from the job) is measured.
+//NullGl is not thread safe, so all jobs are finished before the render thread continues.
+static void runPipelineCompiler(
+    const char*         name,
+    uint32_t            pipelineCount,
+    const ContextScope& contextScope
+) {
+    PipelineCompiler pipelineCompiler(&contextScope, [](uint32_t){});
+    vector<PipelineCompiler::Job> job;
+    for (uint32_t i = 0; i < pipelineCount; ++i)
+        job.push_back(pipelineCompiler.compileRasterization(vertexShader + "//" + to_string(i) + "\n", "", "", "", fragmentShader));
+    pipelineCompiler.waitIdle();
+    nullGl::resetCallCount();
+    resetProgramCacheCounter();
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < pipelineCount; ++i) {
+        BenchPipeline pipeline(Primitive::triangles, job[i]);
+    }
+    auto end   = chrono::steady_clock::now();
+
+    double us                 = double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0;
+    double glCallsPerPipeline = double(nullGl::getCallCount()) / double(pipelineCount);
+    cout << "  " << left << setw(30) << name
+         << right << setw(10) << fixed << setprecision(1) << us / double(pipelineCount)
+         << setw(16) << setprecision(2) << glCallsPerPipeline << endl;
+    if (verbose)
+        for (auto& entry : nullGl::getCallCountList())
+            cout << "      " << left << setw(40) << entry.first << right << setw(10) << setprecision(2) << double(entry.second) / double(pipelineCount) << endl;
+}
+
+//Random free/allocate pattern with sizes from 16 byte up to 64 KiB, while keeping liveCount allocations alive.
+//Only measures the CPU side, the warm up pass creates the blocks that the fragmentation needs.
+static void runBufferGpuAllocator(
+    uint32_t operationCount
+) {
+    const uint32_t liveCount = 4096;
+    BufferGpuAllocator allocator(16 * 1024 * 1024, false);
+    vector<BufferGpuAllocator::Allocation> allocation(liveCount);
+    uint32_t random = 1;
+    auto nextRandom = [&]() {random = random * 1664525u + 1013904223u; return random >> 8;};
+    auto randomSize = [&]() {return uintptr_t(16) << (nextRandom() % 13);};
+    auto freeAllocate = [&]() {
+        auto& a = allocation[nextRandom() % liveCount];
+        allocator.free(a);
+        a = allocator.allocate(randomSize(), 16 * (1 + nextRandom() % 4));
+    };
+    for (auto& a : allocation) a = allocator.allocate(randomSize(), 16 * (1 + nextRandom() % 4));
+    for (uint32_t i = 0; i < liveCount * 16; ++i) freeAllocate();
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < operationCount; ++i) freeAllocate();
+    auto end   = chrono::steady_clock::now();
+
+    double ns = double(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    BufferGpuAllocatorStatistics statistics = allocator.getStatistics();
+    cout << endl;
+    cout << "  " << left << setw(30) << "BufferGpuAllocator free+alloc" << right << setw(10) << fixed << setprecision(1) << ns / double(operationCount) << " ns" << endl;
+    cout << "      blocks " << statistics.blockCount << ", used " << statistics.usedSize / 1024 << " of " << statistics.capacity / 1024 << " KiB"
+         << ", free ranges " << statistics.freeRangeCount << ", largest free range " << statistics.largestFreeRange / 1024 << " KiB"
+         << ", fragmentation " << setprecision(2) << statistics.getFragmentation() << endl;
+    for (auto& a : allocation) allocator.free(a);
+}
+
+//Builds a DepthPyramid from frames of different resolutions. The null backend does not execute the dispatches,
+//so this measures the CPU side and the GL calls per build, which grow with the level count.
+static void runDepthPyramid(
+    uint32_t buildCount
+) {
+    cout << endl;
+    cout << "  depth pyramid build               us/build   GL calls/build  levels" << endl;
+    if (!threadContextGroup->feature.pipelineCompute) {
+        cout << "  " << left << setw(30) << "DepthPyramid" << "  skipped, needs config.hpp pipelineCompute" << endl;
+        return;
+    }
+    const uvec2 resolution[] = {{256, 256}, {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+    DepthPyramid depthPyramid;
+    for (auto size : resolution) {
+        Texture2d depthTexture(SurfaceFormat::D32_SFLOAT, size.x, size.y, false);
+        Frame frame(depthTexture, {});
+        nullGl::setProgramReflection(getMipmapProgramReflection());
+        depthPyramid.build(frame); //creates the texture and (the first time) the pipeline
+        nullGl::setProgramReflection(getBenchProgramReflection());
+        nullGl::resetCallCount();
+
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < buildCount; ++i) depthPyramid.build(frame);
+        auto end   = chrono::steady_clock::now();
+
+        double us = double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()) / 1000.0;
+        string name = to_string(size.x) + "x" + to_string(size.y);
+        cout << "  " << left << setw(30) << name
+             << right << setw(10) << fixed << setprecision(2) << us / double(buildCount)
+             << setw(16) << double(nullGl::getCallCount()) / double(buildCount)
+             << setw(8)  << depthPyramid.getMipmapCount() << endl;
+    }
+}
+
+//CPU mirror of the texel selection in isOccluded() of the PipelineComputeCulling shader, every level 0 row must land in the level lod texel that covers it.
+//With non power of two sizes scaling uv by the rounded down level size undershoots, e.g. 1080 rows at lod 4 (67 rows) row 1012 is in texel 63, not 62.
+static bool checkHiZTexelMapping(
+    const Texture2d& depthPyramidTexture,
+    uint32_t         lod,
+    uint32_t         rowFirst,
+    uint32_t         rowLast,
+    uint32_t         texelFirst,
+    uint32_t         texelLast
+) {
+    const int baseSize  = int(depthPyramidTexture.getMipmapLevelSize(0).y);
+    const int levelSize = int(depthPyramidTexture.getMipmapLevelSize(lod).y);
+    bool texelFirstUsed = false;
+    bool texelLastUsed  = false;
+    for (uint32_t row = rowFirst; row <= rowLast; ++row) {
+        const float uv    = (float(row) + 0.5f) / float(baseSize);
+        const int   texel = std::min(int(uv * float(baseSize)) >> lod, levelSize - 1);
+        if (texel != std::min(int(row >> lod), levelSize - 1)) return false;
+        texelFirstUsed |= uint32_t(texel) == texelFirst;
+        texelLastUsed  |= uint32_t(texel) == texelLast;
+    }
+    return texelFirstUsed && texelLastUsed;
+}
+
+//objectCount objects with bounding spheres spread around the camera, about a sixth of them is inside the frustum.
+//CPU culling issues one drawIndexed per visible object, GPU culling one dispatch and one drawIndexedIndirectCount per frame.
+//The null backend does not execute the dispatch, so the GPU side only shows its constant CPU cost.
+static void runCulling(
+    BenchPipeline& pipeline,
+    uint32_t       frameCount
+) {
+    const uint32_t objectCount = 100000;
+    cout << endl;
+    cout << "  " << left << setw(30) << "culling " + to_string(objectCount) + " objects" << right << setw(10) << "us/frame" << setw(16) << "GL calls/frame" << endl;
+
+    vector<CullingObject> object(objectCount);
+    uint32_t random = 1;
+    auto nextRandom = [&]() {random = random * 1664525u + 1013904223u; return float(random >> 8) / float(1 << 24);};
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        object[i].boundingSphere = vec4(nextRandom() * 200.0f - 100.0f, nextRandom() * 200.0f - 100.0f, nextRandom() * 200.0f - 100.0f, 0.5f + nextRandom());
+        object[i].command        = {3, 1, 0, 0, i};
+    }
+    //camera at the origin looking down -z, so the view matrix is the identity
+    const mat4 viewProjection = frustum(-0.1f * 16.0f / 9.0f, 0.1f * 16.0f / 9.0f, -0.1f, 0.1f, 0.1f, 1000.0f);
+
+    const uint32_t indexData[] = {0, 1, 2};
+    BufferGpu indexBuffer(false, sizeof(indexData), indexData);
+    pipeline.setAttributeIndexBuffer(IndexType::UINT32, indexBuffer);
+
+    auto report = [&](const char* name, double ns) {
+        cout << "  " << left << setw(30) << name
+             << right << setw(10) << fixed << setprecision(1) << ns / 1000.0 / double(frameCount)
+             << setw(16) << setprecision(2) << double(nullGl::getCallCount()) / double(frameCount) << endl;
+    };
+
+    //Gribb/Hartmann planes, same test as the culling shader
+    vec4 row[4];
+    for (int i = 0; i < 4; ++i) row[i] = vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    const vec4 plane[6] = {row[3] + row[0], row[3] - row[0], row[3] + row[1], row[3] - row[1], row[3] + row[2], row[3] - row[2]};
+    auto isInFrustum = [&](vec4 sphere) {
+        for (auto& p : plane)
+            if (p.x * sphere.x + p.y * sphere.y + p.z * sphere.z + p.w < -sphere.w * sqrt(p.x * p.x + p.y * p.y + p.z * p.z)) return false;
+        return true;
+    };
+    nullGl::resetCallCount();
+    auto start = chrono::steady_clock::now();
+    uint32_t visibleCount = 0;
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        visibleCount = 0;
+        for (auto& o : object) {
+            if (!isInFrustum(o.boundingSphere)) continue;
+            pipeline.drawIndexed(o.command.count, o.command.instanceCount, o.command.firstIndex, o.command.baseVertex, o.command.baseInstance);
+            visibleCount++;
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    report("CPU frustum culling", double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+    cout << "      visible objects " << visibleCount << endl;
+
+    {
+        //same levels as DepthPyramid::build() creates for a 1920x1080 frame
+        Texture2d depthPyramidTexture(SurfaceFormat::R32_SFLOAT, 1920, 1080, true);
+        const bool hiZTexelMappingOk =
+               checkHiZTexelMapping(depthPyramidTexture, 4, 1000, 1012, 62, 63)
+            && checkHiZTexelMapping(depthPyramidTexture, 4, 0, 1079, 0, 66)
+            && checkHiZTexelMapping(depthPyramidTexture, depthPyramidTexture.getMipmapCount() - 1, 0, 1079, 0, 0);
+        cout << "      Hi-Z texel mapping 1920x1080 " << (hiZTexelMappingOk ? "ok" : "FAILED") << endl;
+    }
+
+    if (!(threadContextGroup->feature.pipelineCompute && threadContextGroup->feature.drawIndirectCount)) {
+        cout << "  " << left << setw(30) << "PipelineComputeCulling" << "  skipped, needs config.hpp pipelineCompute and drawIndirectCount" << endl;
+        pipeline.setAttributeIndexBuffer();
+        return;
+    }
+    BufferGpu objectBuffer (false, objectCount * sizeof(CullingObject), object.data());
+    BufferGpu commandBuffer(false, objectCount * sizeof(DrawElementsIndirectCommand));
+    BufferGpu countBuffer  (false, sizeof(uint32_t));
+    nullGl::setProgramReflection(getCullingProgramReflection());
+    PipelineComputeCulling culling;
+    nullGl::setProgramReflection(getMipmapProgramReflection());
+    Texture2d depthTexture(SurfaceFormat::D32_SFLOAT, 1920, 1080, false);
+    Frame depthFrame(depthTexture, {});
+    DepthPyramid depthPyramid;
+    depthPyramid.build(depthFrame);
+    nullGl::setProgramReflection(getBenchProgramReflection());
+
+    for (int withHiZ = 0; withHiZ < 2; ++withHiZ) {
+        nullGl::resetCallCount();
+        start = chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frameCount; ++frame) {
+            if (withHiZ) culling.cull(objectBuffer, objectCount, commandBuffer, countBuffer, viewProjection, depthPyramid);
+            else         culling.cull(objectBuffer, objectCount, commandBuffer, countBuffer, viewProjection);
+            pipeline.drawIndexedIndirectCount(commandBuffer, 0, countBuffer, 0, objectCount);
+        }
+        end = chrono::steady_clock::now();
+        report(withHiZ ? "PipelineComputeCulling Hi-Z" : "PipelineComputeCulling", double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+    }
+    pipeline.setAttributeIndexBuffer();
+}
+
+//Draws a mesh in passCount passes, either running the vertex stage in every pass or capturing its output once and drawing that via drawTransformFeedback
+static void runTransformFeedback(
+    BenchPipeline (&pipeline)[2],
+    BufferGpu     (&attributeBuffer)[4],
+    uint32_t      frameCount
+) {
+    const uint32_t passCount   = 4;
+    const uint32_t vertexCount = 3;
+    cout << endl;
+    cout << "  " << left << setw(30) << "mesh reuse in " + to_string(passCount) + " passes" << right << setw(10) << "us/frame" << setw(16) << "GL calls/frame" << endl;
+
+    auto report = [&](const char* name, double ns) {
+        cout << "  " << left << setw(30) << name
+             << right << setw(10) << fixed << setprecision(1) << ns / 1000.0 / double(frameCount)
+             << setw(16) << setprecision(2) << double(nullGl::getCallCount()) / double(frameCount) << endl;
+    };
+
+    nullGl::resetCallCount();
+    auto start = chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+        for (uint32_t pass = 0; pass < passCount; ++pass)
+            pipeline[pass & 1].draw(vertexCount, 1, 0, 0);
+    auto end = chrono::steady_clock::now();
+    report("vertex stage per pass", double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+
+    TransformFeedbackLayout transformFeedbackLayout;
+    transformFeedbackLayout.addOutput("outPosition");
+    BenchPipeline capturePipeline(Primitive::triangles, captureVertexShader, "", "", "", "", transformFeedbackLayout);
+    AttributeLayout attributeLayout;
+    attributeLayout.addBufferIndex();
+    attributeLayout.addLocation(0, AttributeFormat::R32G32_SFLOAT);
+    capturePipeline.setAttributeLayout(attributeLayout);
+    capturePipeline.setAttributeBuffer(0, attributeBuffer[0]);
+    capturePipeline.setRasterizerDiscard(true);
+
+    BufferGpu captureBuffer(false, vertexCount * sizeof(vec2));
+    TransformFeedback transformFeedback;
+    transformFeedback.setBuffer(0, captureBuffer);
+    for (auto& p : pipeline) p.setAttributeBuffer(0, captureBuffer);
+
+    nullGl::resetCallCount();
+    start = chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        {
+            TransformFeedback::Scope scope(transformFeedback, capturePipeline);
+            capturePipeline.draw(vertexCount, 1, 0, 0);
+        }
+        for (uint32_t pass = 0; pass < passCount; ++pass)
+            pipeline[pass & 1].drawTransformFeedback(transformFeedback);
+    }
+    end = chrono::steady_clock::now();
+    report("capture once, TF draw per pass", double(chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+
+    pipeline[0].setAttributeBuffer(0, attributeBuffer[0]);
+    pipeline[1].setAttributeBuffer(0, attributeBuffer[1]);
+}
+
+//UniformSetter construction, what dominates constructing pipeline or material objects with many UniformSetter members
+static void runUniformLookup(
+    uint32_t lookupCount
+) {
+    const uint32_t uniformCount = 512;
+    nullGl::setProgramReflection(getManyUniformProgramReflection(uniformCount));
+    ManyUniformPipeline pipeline(Primitive::triangles, vertexShader + "//many uniforms\n", "", "", "", fragmentShader);
+    nullGl::setProgramReflection(getBenchProgramReflection());
+    vector<string> uniformName;
+    for (uint32_t i = 0; i < uniformCount; ++i) uniformName.push_back("uniform" + to_string(i));
+
+    cout << endl;
+    cout << "  " << left << setw(30) << "uniform lookup" << right << setw(10) << "ns/lookup" << endl;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < lookupCount; ++i) pipeline.lookup(uniformName[(i * 7) % uniformCount]);
+    auto end   = chrono::steady_clock::now();
+    double ns = double(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    cout << "  " << left << setw(30) << to_string(uniformCount) + " uniforms" << right << setw(10) << fixed << setprecision(1) << ns / double(lookupCount) << endl;
+}
+
+//All allocations of a frame are made before its draws are issued and they overflow into the next segment of the BufferRing.
+//With the GPU lag of the null backend this checks that no allocation overlaps the data of a draw that is still executing.
+static void runBufferRingOverflow(
+    BenchPipeline& pipeline
+) {
+    const uint32_t  frameCount  = 64;
+    const uint32_t  objectCount = 6;
+    const uintptr_t blockSize   = 256;
+    BufferRing bufferRing(blockSize * 4, 3);
+
+    struct DrawRange {
+        uintptr_t offset;
+        uintptr_t size;
+        uint64_t  fenceCount; //draw is finished when more fences than this are finished
+    };
+    vector<DrawRange>              inFlight;
+    vector<BufferRing::Allocation> allocation;
+    bool overwritten = false;
+    nullGl::setGpuLag(true);
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        allocation.clear();
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            BufferRing::Allocation a = bufferRing.allocate(blockSize, blockSize);
+            inFlight.erase(remove_if(inFlight.begin(), inFlight.end(), [](const DrawRange& r) {return nullGl::getFinishedFenceCount() > r.fenceCount;}), inFlight.end());
+            for (auto& r : inFlight)
+                if (a.offset < r.offset + r.size && r.offset < a.offset + a.size) overwritten = true;
+            memset(a.mem, int(frame), size_t(a.size));
+            allocation.push_back(a);
+        }
+        bufferRing.flushWrites();
+        for (auto& a : allocation) {
+            pipeline.setAttributeBuffer(0, bufferRing.getBuffer(), a.offset);
+            pipeline.draw(3, 1, 0, 0);
+            inFlight.push_back({a.offset, a.size, nullGl::getFenceCount()});
+        }
+        bufferRing.nextSegment();
+    }
+    nullGl::setGpuLag(false);
+    cout << "      BufferRing overflow mid frame " << (overwritten ? "OVERWRITES IN FLIGHT DATA" : "ok") << ", ring stalls " << bufferRing.getStallCount() << endl;
+}
+
+static string getTempDirectory() {
+    for (const char* name : {"TMPDIR", "TEMP", "TMP"})
+        if (const char* value = getenv(name))
+            if (*value) return value;
+    return "/tmp";
+}
+
+//New empty directory in the temp directory, removed together with all files in it when going out of scope
+struct TempDirectoryScope {
+    string path;
+
+    TempDirectoryScope(const string& prefix) {
+        #if defined(_WIN32)
+            for (uint32_t i = 0; path.empty() && i < 100; ++i) {
+                string candidate = getTempDirectory() + "/" + prefix + to_string(_getpid()) + "_" + to_string(i);
+                if (_mkdir(candidate.c_str()) == 0) path = candidate;
+            }
+        #else
+            string pattern = getTempDirectory() + "/" + prefix + "XXXXXX";
+            if (mkdtemp(&pattern[0])) path = pattern;
+        #endif
+        if (path.empty()) throw runtime_error("Can not create a temp directory in " + getTempDirectory());
+    }
+
+    ~TempDirectoryScope() {
+        #if defined(_WIN32)
+            _finddata_t fileData;
+            intptr_t handle = _findfirst((path + "/*").c_str(), &fileData);
+            if (handle != -1) {
+                do {
+                    if (!(fileData.attrib & _A_SUBDIR)) std::remove((path + "/" + fileData.name).c_str());
+                } while (_findnext(handle, &fileData) == 0);
+                _findclose(handle);
+            }
+            _rmdir(path.c_str());
+        #else
+            if (DIR* dir = opendir(path.c_str())) {
+                while (dirent* entry = readdir(dir))
+                    if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) std::remove((path + "/" + entry->d_name).c_str());
+                closedir(dir);
+            }
+            rmdir(path.c_str());
+        #endif
+    }
+};
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-v") == 0) verbose   = true;
+        else                            drawCount = uint32_t(std::max(atoi(argv[i]), 1));
+    }
+
+    ContextScope contextScope(nullGl::getGlFunctionPointer);
+    nullGl::setProgramReflection(getBenchProgramReflection());
+
+    const uint32_t textureSlotCount = 4;
+    const uint32_t texturePoolSize  = 16;
+    const uint32_t bufferPoolSize   = 4;
+
+    AttributeLayout attributeLayout;
+    attributeLayout.addBufferIndex();
+    attributeLayout.addLocation(0, AttributeFormat::R32G32_SFLOAT);
+
+    float attributeData[] = {
+        -1.0f, -1.0f,
+         0.0f,  1.0f,
+         1.0f, -1.0f
+    };
+    BufferGpu attributeBuffer[bufferPoolSize] = {
+        {false, sizeof(attributeData), attributeData},
+        {false, sizeof(attributeData), attributeData},
+        {false, sizeof(attributeData), attributeData},
+        {false, sizeof(attributeData), attributeData}
+    };
+
+    vector<Texture2d> texture;
+    for (uint32_t i = 0; i < texturePoolSize; ++i) texture.emplace_back(SurfaceFormat::R8G8B8A8_UNORM, 16, 16, false);
+    Sampler sampler;
+
+    BenchPipeline pipeline[2] = {
+        {Primitive::triangles, vertexShader, "", "", "", fragmentShader},
+        {Primitive::triangles, vertexShader, "", "", "", fragmentShader}
+    };
+    for (auto& p : pipeline) {
+        p.setAttributeLayout(attributeLayout);
+        p.setAttributeBuffer(0, attributeBuffer[0]);
+        p.rgba = vec4(1.0f, 0.0f, 0.0f, 0.0f);
+        for (uint32_t slot = 0; slot < textureSlotCount; ++slot) {
+            p.setTexture(slot, texture[slot]);
+            p.setSampler(slot, sampler);
+        }
+    }
+    //Second pipeline differs in states and bindings, so switching is not free
+    pipeline[1].setDepthTest(CompareOperator::less);
+    pipeline[1].setDepthWrite(true);
+    pipeline[1].setAttributeBuffer(0, attributeBuffer[1]);
+    for (uint32_t slot = 0; slot < textureSlotCount; ++slot) pipeline[1].setTexture(slot, texture[textureSlotCount + slot]);
+
+    setDrawFrame(getDisplayFrame());
+
+    cout << "glCompact_bench (null OpenGL backend, " << drawCount << " draws per scenario)" << endl;
+    cout << "  " << left << setw(30) << "scenario" << right << setw(10) << "ns/draw" << setw(16) << "GL calls/draw" << endl;
+
+    runScenario("same pipeline redraw", [&](uint32_t) {
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    runScenario("pipeline switch", [&](uint32_t i) {
+        pipeline[i & 1].draw(3, 1, 0, 0);
+    });
+
+    runScenario("texture slot churn", [&](uint32_t i) {
+        for (uint32_t slot = 0; slot < textureSlotCount; ++slot)
+            pipeline[0].setTexture(slot, texture[(i + slot) % texturePoolSize]);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    runScenario("attribute buffer rebinding", [&](uint32_t i) {
+        pipeline[0].setAttributeBuffer(0, attributeBuffer[i % bufferPoolSize]);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    runScenario("uniform setter", [&](uint32_t i) {
+        pipeline[0].rgba = vec4(float(i));
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    //The same texture/uniform/draw sequence as direct calls, recorded into a CommandList and replayed in blocks of commandListDrawCount draws
+    const uint32_t commandListDrawCount = 1000;
+    auto textureUniformDraw = [&](uint32_t i) {
+        pipeline[0].setTexture(0, texture[i % texturePoolSize]);
+        pipeline[0].rgba = vec4(float(i));
+        pipeline[0].draw(3, 1, 0, 0);
+    };
+    auto recordTextureUniformDraw = [&](CommandList& commandList, uint32_t i) {
+        commandList.setTexture(pipeline[0], 0, texture[i % texturePoolSize]);
+        commandList.setUniform(pipeline[0].rgba, vec4(float(i)));
+        commandList.draw(pipeline[0], 3, 1, 0, 0);
+    };
+    runScenario("direct texture+uniform+draw", textureUniformDraw);
+
+    CommandList commandList;
+    runScenario("CommandList record", [&](uint32_t i) {
+        if (i % commandListDrawCount == 0) commandList.clear();
+        recordTextureUniformDraw(commandList, i);
+    });
+
+    commandList.clear();
+    for (uint32_t i = 0; i < commandListDrawCount; ++i) recordTextureUniformDraw(commandList, i);
+    runScenario("CommandList replay", [&](uint32_t i) {
+        if (i % commandListDrawCount == 0) commandList.replay();
+    });
+
+    //Objects in random order with one of two pipelines, textures and attribute buffers. Submitted directly, or sorted through a DrawQueue in blocks of drawQueueDrawCount draws
+    const uint32_t drawQueueDrawCount = 1000;
+    auto randomObject = [](uint32_t i) {return (i * 2654435761u) >> 8;};
+    runScenario("unsorted objects", [&](uint32_t i) {
+        uint32_t object = randomObject(i);
+        BenchPipeline& p = pipeline[object & 1];
+        p.setTexture(0, texture[(object >> 1) % texturePoolSize]);
+        p.setAttributeBuffer(0, attributeBuffer[(object >> 5) % bufferPoolSize]);
+        p.draw(3, 1, 0, 0);
+    });
+
+    DrawQueue drawQueue;
+    DrawQueueStatistics drawQueueStatistics;
+    runScenario("DrawQueue sorted objects", [&](uint32_t i) {
+        uint32_t object = randomObject(i);
+        drawQueue.add(pipeline[object & 1])
+            .setTexture(0, texture[(object >> 1) % texturePoolSize])
+            .setAttributeBuffer(0, attributeBuffer[(object >> 5) % bufferPoolSize])
+            .draw(3, 1, 0, 0);
+        if (drawQueue.getPacketCount() == drawQueueDrawCount) {
+            drawQueue.submit();
+            drawQueueStatistics = drawQueue.getStatistics();
+        }
+    });
+    cout << "      per " << drawQueueDrawCount << " draws: program binds " << drawQueueStatistics.programBindsUnsorted << " -> " << drawQueueStatistics.programBinds
+         << ", texture binds " << drawQueueStatistics.textureBindsUnsorted << " -> " << drawQueueStatistics.textureBinds
+         << ", buffer sets " << drawQueueStatistics.bufferSetsUnsorted << " -> " << drawQueueStatistics.bufferSets << endl;
+
+    //Consecutive draws of one pipeline that only differ in their draw arguments, issued directly or collected into glMultiDrawArraysIndirect via setDrawBatching
+    auto varyingDraw = [&](uint32_t i) {
+        pipeline[0].draw(3, 1, (i % 1000) * 3, 0);
+    };
+    runScenario("varying draw arguments", varyingDraw);
+    setDrawBatching(true);
+    runScenario("batched draw arguments", varyingDraw);
+    setDrawBatching(false);
+
+    //Pipelines with different attribute layouts in turn, respecifying the single VAO or switching between the VAOs of setVertexArrayCache.
+    //The thrashing cache is smaller than the number of layouts, so every switch respecifies the least recently used VAO.
+    //The null backend makes GL calls nearly free, so the saved attribute format calls only show in the GL calls per draw.
+    const uint32_t layoutCount = 4;
+    deque<BenchPipeline> layoutPipeline; //deque, because pipelines can not be moved
+    for (uint32_t i = 0; i < layoutCount; ++i) {
+        AttributeLayout layout;
+        layout.addBufferIndex();
+        layout.addLocation(0, AttributeFormat::R32G32_SFLOAT);
+        if (i) layout.addSpacing(uint16_t(i * 8));
+        layoutPipeline.emplace_back(Primitive::triangles, vertexShader, "", "", "", fragmentShader);
+        layoutPipeline.back().setAttributeLayout(layout);
+        layoutPipeline.back().setAttributeBuffer(0, attributeBuffer[i % bufferPoolSize]);
+    }
+    auto layoutSwitchDraw = [&](uint32_t i) {
+        layoutPipeline[i % layoutCount].draw(3, 1, 0, 0);
+    };
+    runScenario("layout switch, single VAO", layoutSwitchDraw);
+    setVertexArrayCache(layoutCount);
+    runScenario("layout switch, VAO cache", layoutSwitchDraw);
+    setVertexArrayCache(layoutCount - 1);
+    runScenario("layout switch, VAO cache LRU", layoutSwitchDraw);
+    setVertexArrayCache(0);
+    layoutPipeline.clear();
+
+    //Uniforms of both pipelines set before each draw, mostly to the value they already have, like per object code that does not track what it set.
+    //Immediate writes bind the program of the other pipeline and forward every value, shadowed writes only upload changed values at the draw.
+    auto uniformBothDraw = [&](uint32_t i) {
+        pipeline[0].rgba = vec4(float(i / 8));
+        pipeline[1].rgba = vec4(1.0f);
+        pipeline[i & 1].draw(3, 1, 0, 0);
+    };
+    runScenario("uniforms, immediate", uniformBothDraw);
+    pipeline[0].setUniformShadowing(true);
+    pipeline[1].setUniformShadowing(true);
+    runScenario("uniforms, shadowed", uniformBothDraw);
+    pipeline[0].setUniformShadowing(false);
+    pipeline[1].setUniformShadowing(false);
+
+    //Per object model matrix, color and roughness as single uniforms, or written into a uniform block that gets uploaded with copyFromMemory or
+    //written into a BufferRing. Blocks of frameDrawCount draws go into one buffer/segment, like the objects of one frame.
+    const uint32_t frameDrawCount = 1000;
+    nullGl::setProgramReflection(getObjectProgramReflection(false));
+    ObjectPipeline objectPipeline(Primitive::triangles, vertexShader + "//object uniforms\n", "", "", "", fragmentShader);
+    nullGl::setProgramReflection(getObjectProgramReflection(true));
+    PipelineRasterization objectBlockPipeline(Primitive::triangles, vertexShader + "//object uniform block\n", "", "", "", fragmentShader);
+    nullGl::setProgramReflection(getBenchProgramReflection());
+    ObjectBlock objectBlock(objectBlockPipeline, "Object_binding0");
+    for (PipelineRasterization* p : {static_cast<PipelineRasterization*>(&objectPipeline), static_cast<PipelineRasterization*>(&objectBlockPipeline)}) {
+        p->setAttributeLayout(attributeLayout);
+        p->setAttributeBuffer(0, attributeBuffer[0]);
+    }
+    mat4 objectModel(1.0f);
+    objectModel[3] = vec4(1.0f, 2.0f, 3.0f, 1.0f);
+    runScenario("object uniforms, UniformSetter", [&](uint32_t i) {
+        objectPipeline.model     = objectModel;
+        objectPipeline.rgba      = vec4(float(i));
+        objectPipeline.roughness = 0.5f;
+        objectPipeline.draw(3, 1, 0, 0);
+    });
+
+    const uint32_t objectBlockStride = 256; //GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT of the null backend
+    BufferGpu objectBlockBuffer(true, objectBlockStride * frameDrawCount);
+    vector<uint8_t> objectBlockMemory(objectBlock.getSize());
+    runScenario("object uniform block, copy", [&](uint32_t i) {
+        objectBlock.model    .write(objectBlockMemory.data(), objectModel);
+        objectBlock.rgba     .write(objectBlockMemory.data(), vec4(float(i)));
+        objectBlock.roughness.write(objectBlockMemory.data(), 0.5f);
+        uintptr_t offset = (i % frameDrawCount) * objectBlockStride;
+        objectBlockBuffer.copyFromMemory(objectBlockMemory.data(), offset, objectBlock.getSize());
+        objectBlockPipeline.setUniformBuffer(objectBlock.getBinding(), objectBlockBuffer, offset, objectBlock.getSize());
+        objectBlockPipeline.draw(3, 1, 0, 0);
+    });
+
+    objectBlockPipeline.verifyUniformBlockLayout("Object_binding0", BlockLayoutDescription::create<ObjectStd140>({
+        GLCOMPACT_BLOCK_LAYOUT_MEMBER(ObjectStd140, model),
+        GLCOMPACT_BLOCK_LAYOUT_MEMBER(ObjectStd140, rgba),
+        GLCOMPACT_BLOCK_LAYOUT_MEMBER(ObjectStd140, roughness)
+    }));
+    ObjectStd140 objectStd140;
+    runScenario("object uniform block, struct", [&](uint32_t i) {
+        objectStd140.model     = objectModel;
+        objectStd140.rgba      = vec4(float(i));
+        objectStd140.roughness = 0.5f;
+        uintptr_t offset = (i % frameDrawCount) * objectBlockStride;
+        objectBlockBuffer.copyFromMemory(&objectStd140, offset, sizeof(objectStd140));
+        objectBlockPipeline.setUniformBuffer(0, objectBlockBuffer, offset, sizeof(objectStd140));
+        objectBlockPipeline.draw(3, 1, 0, 0);
+    });
+
+    if (threadContextGroup->feature.bufferStaging) {
+        BufferRing bufferRing(objectBlockStride * frameDrawCount);
+        runScenario("object uniform block, ring", [&](uint32_t i) {
+            auto allocation = objectBlock.allocate(bufferRing);
+            objectBlock.model    .write(allocation.mem, objectModel);
+            objectBlock.rgba     .write(allocation.mem, vec4(float(i)));
+            objectBlock.roughness.write(allocation.mem, 0.5f);
+            bufferRing.flushWrites();
+            objectBlock.setUniformBuffer(objectBlockPipeline, bufferRing, allocation);
+            objectBlockPipeline.draw(3, 1, 0, 0);
+            if (i % frameDrawCount == frameDrawCount - 1) bufferRing.nextSegment();
+        });
+    } else {
+        cout << "  " << left << setw(30) << "object uniform block, ring" << "  skipped, needs config.hpp bufferStaging" << endl;
+    }
+
+    //All lights of a std430 storage block array, tightly packed in a std::vector and uploaded with one copyFromMemory per draw
+    if (threadContextGroup->feature.shaderStorageBufferObject) {
+        nullGl::setProgramReflection(getLightProgramReflection());
+        PipelineRasterization lightPipeline(Primitive::triangles, vertexShader + "//light storage block\n", "", "", "", fragmentShader);
+        nullGl::setProgramReflection(getBenchProgramReflection());
+        lightPipeline.verifyStorageBlockLayout("Light_binding0", BlockLayoutDescription::create<Light>({
+            GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, position),
+            GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, radius),
+            GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, color),
+            GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, flags)
+        }));
+        lightPipeline.setAttributeLayout(attributeLayout);
+        lightPipeline.setAttributeBuffer(0, attributeBuffer[0]);
+        vector<Light> lightList(64);
+        BufferGpu lightBuffer(true, lightList.size() * sizeof(Light));
+        runScenario("light storage block, struct", [&](uint32_t i) {
+            lightList[i % lightList.size()].radius = float(i);
+            lightBuffer.copyFromMemory(lightList.data(), 0, lightList.size() * sizeof(Light));
+            lightPipeline.setShaderStorageBuffer(0, lightBuffer);
+            lightPipeline.draw(3, 1, 0, 0);
+        });
+    } else {
+        cout << "  " << left << setw(30) << "light storage block, struct" << "  skipped, needs config.hpp shaderStorageBufferObject" << endl;
+    }
+
+    //Per draw vertex data, uploaded with copyFromMemory or written into a BufferRing that moves to the next segment every frameDrawCount draws
+    BufferGpu streamBuffer(true, sizeof(attributeData) * frameDrawCount);
+    runScenario("copyFromMemory vertex data", [&](uint32_t i) {
+        uintptr_t offset = (i % frameDrawCount) * sizeof(attributeData);
+        streamBuffer.copyFromMemory(attributeData, offset, sizeof(attributeData));
+        pipeline[0].setAttributeBuffer(0, streamBuffer, offset);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    if (threadContextGroup->feature.bufferStaging) {
+        BufferRing bufferRing(sizeof(attributeData) * frameDrawCount);
+        runScenario("BufferRing vertex data", [&](uint32_t i) {
+            auto allocation = bufferRing.allocate(sizeof(attributeData));
+            memcpy(allocation.getPtr(), attributeData, sizeof(attributeData));
+            bufferRing.flushWrites();
+            pipeline[0].setAttributeBuffer(0, bufferRing.getBuffer(), allocation.offset);
+            pipeline[0].draw(3, 1, 0, 0);
+            if (i % frameDrawCount == frameDrawCount - 1) bufferRing.nextSegment();
+        });
+        cout << "      ring stalls " << bufferRing.getStallCount() << endl;
+        runBufferRingOverflow(pipeline[0]);
+    } else {
+        cout << "  " << left << setw(30) << "BufferRing vertex data" << "  skipped, needs config.hpp bufferStaging" << endl;
+    }
+    pipeline[0].setAttributeBuffer(0, attributeBuffer[0]);
+
+    //Reading back a small result after each draw, synchronous with copyToMemory or via BufferReadbackPool handles that are consumed once ready
+    BufferGpu resultBuffer(true, 16);
+    uint32_t  result[4];
+    runScenario("copyToMemory readback", [&](uint32_t) {
+        pipeline[0].draw(3, 1, 0, 0);
+        resultBuffer.copyToMemory(result, 0, sizeof(result));
+    });
+
+    if (threadContextGroup->feature.bufferStaging) {
+        BufferReadbackPool readbackPool;
+        deque<BufferReadback> pendingReadback;
+        runScenario("BufferReadback readback", [&](uint32_t) {
+            pipeline[0].draw(3, 1, 0, 0);
+            pendingReadback.push_back(readbackPool.readback(resultBuffer, 0, sizeof(result)));
+            while (!pendingReadback.empty() && pendingReadback.front().isReady()) {
+                memcpy(result, pendingReadback.front().getPtr(), sizeof(result));
+                pendingReadback.pop_front();
+            }
+        });
+        cout << "      pooled staging buffers " << readbackPool.getBufferCount() << endl;
+    } else {
+        cout << "  " << left << setw(30) << "BufferReadback readback" << "  skipped, needs config.hpp bufferStaging" << endl;
+    }
+
+    //Texture capture with 3 readbacks in flight, the oldest one gets consumed after each draw
+    uint8_t texel[16 * 16 * 4];
+    runScenario("copyConvertToMemory texture", [&](uint32_t) {
+        pipeline[0].draw(3, 1, 0, 0);
+        texture[0].copyConvertToMemory(texel, sizeof(texel), MemorySurfaceFormat::R8G8B8A8_UNORM, 0, {0, 0, 0}, {16, 16, 1});
+    });
+
+    if (threadContextGroup->feature.bufferStaging) {
+        BufferReadbackPool readbackPool;
+        deque<BufferReadback> pendingReadback;
+        runScenario("BufferReadback texture", [&](uint32_t) {
+            pipeline[0].draw(3, 1, 0, 0);
+            pendingReadback.push_back(readbackPool.readback(texture[0], MemorySurfaceFormat::R8G8B8A8_UNORM, 0, {0, 0, 0}, {16, 16, 1}));
+            if (pendingReadback.size() > 3) {
+                memcpy(texel, pendingReadback.front().getPtr(), sizeof(texel));
+                pendingReadback.pop_front();
+            }
+        });
+        cout << "      pooled staging buffers " << readbackPool.getBufferCount() << endl;
+    } else {
+        cout << "  " << left << setw(30) << "BufferReadback texture" << "  skipped, needs config.hpp bufferStaging" << endl;
+    }
+
+    //Streaming a 16x16 texture per draw, directly from memory or queued into a TextureUploader that issues the uploads once per frame
+    runScenario("copyConvertFromMemory texture", [&](uint32_t i) {
+        texture[i % texturePoolSize].copyConvertFromMemory(texel, sizeof(texel), MemorySurfaceFormat::R8G8B8A8_UNORM, 0, {0, 0, 0}, {16, 16, 1});
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    if (threadContextGroup->feature.bufferStaging) {
+        TextureUploader textureUploader(sizeof(texel) * frameDrawCount * 2, sizeof(texel) * frameDrawCount);
+        runScenario("TextureUploader texture", [&](uint32_t i) {
+            textureUploader.upload(texture[i % texturePoolSize], texel, sizeof(texel), MemorySurfaceFormat::R8G8B8A8_UNORM, 0, {0, 0, 0}, {16, 16, 1});
+            pipeline[0].draw(3, 1, 0, 0);
+            if (i % frameDrawCount == frameDrawCount - 1) textureUploader.update();
+        });
+        textureUploader.finish();
+        TextureUploaderStatistics statistics = textureUploader.getStatistics();
+        cout << "      uploaded " << statistics.uploadedBytes / (1024 * 1024) << " MiB, " << setprecision(0) << statistics.bytesPerSecond / (1024.0 * 1024.0) << " MiB/s"
+             << ", budget limited frames " << statistics.budgetLimitedFrames << ", ring limited frames " << statistics.ringLimitedFrames << endl;
+    } else {
+        cout << "  " << left << setw(30) << "TextureUploader texture" << "  skipped, needs config.hpp bufferStaging" << endl;
+    }
+
+    //Regenerating the mipmaps of a 256x256 texture per draw, via the driver or via the compute shader that writes up to 4 levels per dispatch
+    Texture2d mipmapTexture(SurfaceFormat::R8G8B8A8_UNORM, 256, 256, true);
+    runScenario("generateMipmaps driver", [&](uint32_t) {
+        mipmapTexture.generateMipmaps();
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    if (threadContextGroup->feature.pipelineCompute) {
+        nullGl::setProgramReflection(getMipmapProgramReflection());
+        mipmapTexture.generateMipmaps(MipmapFilter::box); //creates the pipeline with the reflection above
+        nullGl::setProgramReflection(getBenchProgramReflection());
+        runScenario("generateMipmaps compute", [&](uint32_t) {
+            mipmapTexture.generateMipmaps(MipmapFilter::box);
+            pipeline[0].draw(3, 1, 0, 0);
+        });
+    } else {
+        cout << "  " << left << setw(30) << "generateMipmaps compute" << "  skipped, needs config.hpp pipelineCompute" << endl;
+    }
+
+    //Meshes in their own buffers, or sub-allocated from one BufferGpuAllocator block and selected via firstVertex
+    const uint32_t meshCount = 64;
+    deque<BufferGpu> meshBuffer;
+    for (uint32_t i = 0; i < meshCount; ++i) meshBuffer.emplace_back(false, sizeof(attributeData), attributeData);
+    runScenario("separate mesh buffers", [&](uint32_t i) {
+        pipeline[0].setAttributeBuffer(0, meshBuffer[randomObject(i) % meshCount]);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    const uint32_t vertexStride = sizeof(attributeData) / 3;
+    BufferGpuAllocator meshAllocator(1024 * 1024);
+    vector<BufferGpuAllocator::Allocation> meshAllocation;
+    for (uint32_t i = 0; i < meshCount; ++i) {
+        meshAllocation.push_back(meshAllocator.allocate(sizeof(attributeData), vertexStride));
+        meshAllocator.getBuffer(meshAllocation.back()).copyFromMemory(attributeData, meshAllocation.back().offset, sizeof(attributeData));
+    }
+    pipeline[0].setAttributeBuffer(0, meshAllocator.getBuffer(0));
+    runScenario("BufferGpuAllocator meshes", [&](uint32_t i) {
+        auto& allocation = meshAllocation[randomObject(i) % meshCount];
+        pipeline[0].draw(3, 1, uint32_t(allocation.offset / vertexStride), 0);
+    });
+    pipeline[0].setAttributeBuffer(0, attributeBuffer[0]);
+    for (auto& allocation : meshAllocation) meshAllocator.free(allocation);
+
+    GpuTimer gpuTimer;
+    runScenario("GpuTimer scope per draw", [&](uint32_t) {
+        GpuTimer::Scope scope(gpuTimer);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+
+    OcclusionQuery occlusionQuery;
+    runScenario("OcclusionQuery scope per draw", [&](uint32_t) {
+        OcclusionQuery::Scope scope(occlusionQuery);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+    runScenario("ConditionalRender per draw", [&](uint32_t) {
+        {
+            OcclusionQuery::Scope scope(occlusionQuery);
+            pipeline[0].draw(3, 1, 0, 0);
+        }
+        ConditionalRenderScope condition(occlusionQuery, ConditionalRenderMode::noWait);
+        pipeline[0].draw(3, 1, 0, 0);
+    });
+    occlusionQuery.free();
+
+    runBufferGpuAllocator(drawCount);
+    runDepthPyramid(std::max(drawCount / 100, 1u));
+    runCulling(pipeline[0], std::max(drawCount / 20000, 1u));
+    runTransformFeedback(pipeline, attributeBuffer, std::max(drawCount / 10, 1u));
+    runUniformLookup(drawCount);
+
+    const uint32_t pipelineCount = 256;
+    cout << endl;
+    cout << "  " << left << setw(30) << "pipeline creation" << right << setw(10) << "us/pipe" << setw(16) << "GL calls/pipe" << setw(8) << "hit" << setw(8) << "miss" << endl;
+    runPipelineCreation("program cache disabled", pipelineCount);
+    runPipelineCreation("async compile", pipelineCount, PipelineCompileMode::async);
+    runPipelineCompiler("PipelineCompiler worker", pipelineCount, contextScope);
+    {
+        TempDirectoryScope cacheDirectory("glCompact_bench_");
+        setProgramCacheDirectory(cacheDirectory.path);
+        runPipelineCreation("program cache first use", pipelineCount);
+        runPipelineCreation("program cache hit", pipelineCount);
+        setProgramCacheDirectory("");
+    }
+
+    return 0;
+}
@@ -81,5 +81,9 @@ namespace glCompact {
         //The OpenGL Standard defines that function without an active context on the calling thread have no effect.
         //This enables an assert check to catch this in glCompact functions.
         #define GLCOMPACT_DEBUG_ASSERT_THREAD_HAS_ACTIVE_CONTEXT
+
+        //Counts every OpenGL call issued by glCompact and how many cached state checks were elided versus forwarded to OpenGL, per state category.
+        //Read and reset via getStatistics()/resetStatistics() (Statistics.hpp). Adds overhead to every OpenGL call, leave this undefined for release builds.
+        //#define GLCOMPACT_STATISTICS
     }
 }
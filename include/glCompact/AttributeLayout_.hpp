@@ -4,6 +4,7 @@
 namespace glCompact {
     class AttributeLayout_ : public AttributeLayout {
         friend class PipelineRasterization;
+        friend class Context_;
 
         enum class GpuType : uint8_t {
             unused,
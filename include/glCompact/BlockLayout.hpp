@@ -0,0 +1,203 @@
+#pragma once
+#include "glCompact/cppTypeToGlType.hpp"
+
+#include <cstddef> //offsetof
+#include <cstdint> //C++11
+#include <cstring>
+#include <string>
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+
+/*
+    Declares a C++ struct whose members follow the std140 or std430 block layout rules. Must be the first line of the struct.
+
+        struct Light {
+            GLCOMPACT_BLOCK_LAYOUT(std430);
+            GLCOMPACT_BLOCK_MEMBER(glm::vec3, position);
+            GLCOMPACT_BLOCK_MEMBER(float,     radius);
+            GLCOMPACT_BLOCK_MEMBER(glm::vec3, color);
+            GLCOMPACT_BLOCK_MEMBER(uint32_t,  flags);
+        };
+
+    GLCOMPACT_BLOCK_MEMBER aligns every member to the base alignment of its rule, so the compiler places it at the same offset as the GLSL compiler does.
+    Types with a comma, like BlockArray, need a type alias first.
+*/
+#define GLCOMPACT_BLOCK_LAYOUT(rule) static constexpr glCompact::BlockLayoutRule blockLayoutRule = glCompact::BlockLayoutRule::rule
+#define GLCOMPACT_BLOCK_MEMBER(type, name) alignas(glCompact::BlockLayoutType<type, blockLayoutRule>::alignment) type name
+//Entry of BlockLayoutDescription::create<Struct>()
+#define GLCOMPACT_BLOCK_LAYOUT_MEMBER(Struct, name) glCompact::BlockLayoutMember::create<decltype(Struct::name), Struct::blockLayoutRule>(#name, offsetof(Struct, name))
+
+namespace glCompact {
+    enum class BlockLayoutRule : uint8_t {
+        std140, //default of uniform blocks, array strides, matrix columns and structs are rounded up to 16 byte
+        std430  //storage blocks only, the same as std140 without rounding up to 16 byte
+    };
+
+    constexpr uint32_t blockLayoutRoundUp_(uint32_t value, uint32_t alignment) {return (value + alignment - 1) / alignment * alignment;}
+
+    //Layout of the GLSL type glType under rule, matrices are column-major
+    template<int32_t glType, BlockLayoutRule rule>
+    struct BlockLayoutGlType_ {
+        static constexpr uint32_t scalarSize =
+            glType == 0x140A || (glType >= 0x8FFC && glType <= 0x8FFE) || (glType >= 0x8F46 && glType <= 0x8F4E) ? 8 : 4; //double types
+        static constexpr uint32_t columns =
+            glType == 0x8B5A || glType == 0x8B65 || glType == 0x8B66 || glType == 0x8F46 || glType == 0x8F49 || glType == 0x8F4A ? 2 :
+            glType == 0x8B67 || glType == 0x8B5B || glType == 0x8B68 || glType == 0x8F4B || glType == 0x8F47 || glType == 0x8F4C ? 3 :
+            glType == 0x8B69 || glType == 0x8B6A || glType == 0x8B5C || glType == 0x8F4D || glType == 0x8F4E || glType == 0x8F48 ? 4 : 1;
+        //components of vectors, rows of matrices
+        static constexpr uint32_t rows =
+            glType == 0x8B50 || glType == 0x8FFC || glType == 0x8B53 || glType == 0x8DC6 || glType == 0x8B57
+         || glType == 0x8B5A || glType == 0x8B67 || glType == 0x8B69 || glType == 0x8F46 || glType == 0x8F4B || glType == 0x8F4D ? 2 :
+            glType == 0x8B51 || glType == 0x8FFD || glType == 0x8B54 || glType == 0x8DC7 || glType == 0x8B58
+         || glType == 0x8B65 || glType == 0x8B5B || glType == 0x8B6A || glType == 0x8F49 || glType == 0x8F47 || glType == 0x8F4E ? 3 :
+            glType == 0x8B52 || glType == 0x8FFE || glType == 0x8B55 || glType == 0x8DC8 || glType == 0x8B59
+         || glType == 0x8B66 || glType == 0x8B68 || glType == 0x8B5C || glType == 0x8F4A || glType == 0x8F4C || glType == 0x8F48 ? 4 : 1;
+        static constexpr uint32_t vectorAlignment = rows == 1 ? scalarSize : rows == 2 ? 2 * scalarSize : 4 * scalarSize;
+        //matrices are laid out like an array of their column vectors
+        static constexpr uint32_t matrixStride = columns == 1 ? 0 : rule == BlockLayoutRule::std140 ? blockLayoutRoundUp_(vectorAlignment, 16) : vectorAlignment;
+        static constexpr uint32_t alignment    = columns == 1 ? vectorAlignment : matrixStride;
+        static constexpr uint32_t size         = columns == 1 ? rows * scalarSize : columns * matrixStride;
+        static constexpr uint32_t arrayStride  = blockLayoutRoundUp_(size, rule == BlockLayoutRule::std140 ? blockLayoutRoundUp_(alignment, 16) : alignment);
+    };
+
+    /*
+        Block layout of the C++ type T under rule: glType (0 for structs), alignment, size, arraySize (1 for everything but BlockArray) and the array and matrix stride.
+        The primary template covers structs declared with GLCOMPACT_BLOCK_LAYOUT, the specializations GL types, BlockArray and BlockMatrix.
+    */
+    template<typename T, BlockLayoutRule rule, typename Enable = void>
+    struct BlockLayoutType {
+        static_assert(std::is_class<T>::value, "Not a valid type for block layouts");
+        static_assert(rule != BlockLayoutRule::std140 || alignof(T) % 16 == 0, "Structs inside of std140 blocks have a 16 byte alignment, declare them as struct alignas(16)");
+        static constexpr int32_t  glType       = 0;
+        static constexpr uint32_t alignment    = alignof(T);
+        static constexpr uint32_t size         = sizeof(T);
+        static constexpr uint32_t arraySize    = 1;
+        static constexpr uint32_t arrayStride  = sizeof(T);
+        static constexpr uint32_t matrixStride = 0;
+    };
+
+    template<typename T, BlockLayoutRule rule>
+    struct BlockLayoutType<T, rule, typename std::enable_if<cppTypeToGlType<T>() != 0>::type> {
+        typedef BlockLayoutGlType_<cppTypeToGlType<T>(), rule> GlType;
+        static_assert(sizeof(T) % 4 == 0, "GLSL bool types take 4 byte per component in blocks, use uint types in GLSL and C++ instead");
+        static_assert(sizeof(T) == GlType::columns * GlType::rows * GlType::scalarSize, "glm types with padding (GLM_FORCE_ALIGNED) can not be used in block layouts");
+        static_assert(sizeof(T) == GlType::size, "This matrix has padded columns under this block layout rule, use BlockMatrix");
+        static constexpr int32_t  glType       = cppTypeToGlType<T>();
+        static constexpr uint32_t alignment    = GlType::alignment;
+        static constexpr uint32_t size         = GlType::size;
+        static constexpr uint32_t arraySize    = 1;
+        static constexpr uint32_t arrayStride  = GlType::arrayStride;
+        static constexpr uint32_t matrixStride = GlType::matrixStride;
+    };
+
+    template<typename T, uint32_t padding>
+    struct BlockLayoutPadded_ {
+        T       value;
+        uint8_t padding_[padding];
+    };
+    template<typename T>
+    struct BlockLayoutPadded_<T, 0> {
+        T value;
+    };
+
+    /** BlockArray
+        \brief Array member of a block layout struct, with the array stride of rule (e.g. float[4] takes 64 byte in std140)
+    */
+    template<typename T, uint32_t count, BlockLayoutRule rule>
+    class BlockArray {
+        public:
+            static constexpr uint32_t stride = BlockLayoutType<T, rule>::arrayStride;
+            static_assert(BlockLayoutType<T, rule>::arraySize == 1, "Arrays of arrays are not supported");
+
+                  T& operator[](uint32_t i)       {return element[i].value;}
+            const T& operator[](uint32_t i) const {return element[i].value;}
+            constexpr uint32_t size() const {return count;}
+        private:
+            BlockLayoutPadded_<T, stride - sizeof(T)> element[count];
+            static_assert(sizeof(BlockLayoutPadded_<T, stride - sizeof(T)>) == stride, "BlockArray element does not match the array stride");
+    };
+
+    template<typename T, uint32_t count, BlockLayoutRule rule, BlockLayoutRule arrayRule>
+    struct BlockLayoutType<BlockArray<T, count, arrayRule>, rule, void> {
+        typedef BlockLayoutType<T, rule> Element;
+        static_assert(rule == arrayRule, "BlockArray must use the same rule as its block layout");
+        static constexpr int32_t  glType       = Element::glType;
+        static constexpr uint32_t alignment    = rule == BlockLayoutRule::std140 ? blockLayoutRoundUp_(Element::alignment, 16) : Element::alignment;
+        static constexpr uint32_t size         = count * Element::arrayStride;
+        static constexpr uint32_t arraySize    = count;
+        static constexpr uint32_t arrayStride  = Element::arrayStride;
+        static constexpr uint32_t matrixStride = Element::matrixStride;
+    };
+
+    /** BlockMatrix
+        \brief Matrix member of a block layout struct, for matrices whose columns are padded under rule (e.g. mat3 in std140 and std430)
+
+        \details Converts from and to the tightly packed glm matrix M.
+    */
+    template<typename M, BlockLayoutRule rule>
+    class BlockMatrix {
+        public:
+            typedef BlockLayoutGlType_<cppTypeToGlType<M>(), rule> GlType;
+            static_assert(GlType::columns > 1, "BlockMatrix only takes matrix types");
+            static_assert(sizeof(M) == GlType::columns * GlType::rows * GlType::scalarSize, "glm types with padding (GLM_FORCE_ALIGNED) can not be used in block layouts");
+
+            BlockMatrix() = default;
+            BlockMatrix(const M& m) {*this = m;}
+            BlockMatrix& operator=(const M& m) {
+                const uint32_t columnSize = GlType::rows * GlType::scalarSize;
+                for (uint32_t c = 0; c < GlType::columns; ++c) std::memcpy(data + c * GlType::matrixStride, reinterpret_cast<const uint8_t*>(&m) + c * columnSize, columnSize);
+                return *this;
+            }
+            operator M() const {
+                M m;
+                const uint32_t columnSize = GlType::rows * GlType::scalarSize;
+                for (uint32_t c = 0; c < GlType::columns; ++c) std::memcpy(reinterpret_cast<uint8_t*>(&m) + c * columnSize, data + c * GlType::matrixStride, columnSize);
+                return m;
+            }
+        private:
+            alignas(GlType::alignment) uint8_t data[GlType::size];
+    };
+
+    template<typename M, BlockLayoutRule rule, BlockLayoutRule matrixRule>
+    struct BlockLayoutType<BlockMatrix<M, matrixRule>, rule, void> {
+        typedef BlockLayoutGlType_<cppTypeToGlType<M>(), rule> GlType;
+        static_assert(rule == matrixRule, "BlockMatrix must use the same rule as its block layout");
+        static constexpr int32_t  glType       = cppTypeToGlType<M>();
+        static constexpr uint32_t alignment    = GlType::alignment;
+        static constexpr uint32_t size         = GlType::size;
+        static constexpr uint32_t arraySize    = 1;
+        static constexpr uint32_t arrayStride  = GlType::arrayStride;
+        static constexpr uint32_t matrixStride = GlType::matrixStride;
+    };
+
+    //Member of a BlockLayoutDescription, usually created with GLCOMPACT_BLOCK_LAYOUT_MEMBER
+    struct BlockLayoutMember {
+        std::string name;
+        int32_t     type;
+        uint32_t    offset;
+        uint32_t    arraySize;
+        uint32_t    arrayStride;
+        uint32_t    matrixStride;
+
+        template<typename T, BlockLayoutRule rule>
+        static BlockLayoutMember create(const char* name, uintptr_t offset) {
+            typedef BlockLayoutType<T, rule> Type;
+            static_assert(Type::glType != 0, "Only members of GL types, BlockArray and BlockMatrix can be described, members of nested structs are not verified");
+            return BlockLayoutMember{name, Type::glType, uint32_t(offset), Type::arraySize, Type::arrayStride, Type::matrixStride};
+        }
+    };
+
+    //Runtime description of a block layout struct, to verify it against the reflection of a pipeline with PipelineInterface::verifyUniformBlockLayout/verifyStorageBlockLayout
+    struct BlockLayoutDescription {
+        BlockLayoutRule                rule;
+        uint32_t                       size; //sizeof the struct, the stride of a top level array of it
+        std::vector<BlockLayoutMember> member;
+
+        template<typename Struct>
+        static BlockLayoutDescription create(std::initializer_list<BlockLayoutMember> member) {
+            static_assert(std::is_standard_layout<Struct>::value, "Block layout structs must be standard layout types");
+            return BlockLayoutDescription{Struct::blockLayoutRule, uint32_t(sizeof(Struct)), member};
+        }
+    };
+}
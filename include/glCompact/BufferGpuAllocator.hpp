@@ -0,0 +1,87 @@
+#pragma once
+#include "glCompact/BufferGpu.hpp"
+
+#include <cstdint> //C++11
+#include <vector>
+#include <deque>
+
+namespace glCompact {
+    struct BufferGpuAllocatorStatistics {
+        uint32_t  blockCount       = 0;
+        uintptr_t capacity         = 0; //size of all blocks together
+        uintptr_t usedSize         = 0; //including alignment padding
+        uintptr_t freeSize         = 0;
+        uint32_t  allocationCount  = 0;
+        uint32_t  freeRangeCount   = 0;
+        uintptr_t largestFreeRange = 0;
+        //0.0 if all free memory is in one range, approaches 1.0 the more it is split up into small ranges
+        float getFragmentation() const {return freeSize ? 1.0f - float(largestFreeRange) / float(freeSize) : 0.0f;}
+    };
+
+    class BufferGpuAllocator {
+        public:
+            static constexpr uint32_t invalidIndex = 0xFFFFFFFF;
+
+            struct Allocation {
+                uint32_t  block  = invalidIndex;
+                uint32_t  node   = invalidIndex;
+                uintptr_t offset = 0; //byte offset inside of getBuffer(block)
+                uintptr_t size   = 0;
+                bool isValid() const {return block != invalidIndex;}
+            };
+
+            BufferGpuAllocator(uintptr_t blockSize = 64 * 1024 * 1024, bool clientMemoryCopyable = true);
+            BufferGpuAllocator           (const BufferGpuAllocator&) = delete;
+            BufferGpuAllocator& operator=(const BufferGpuAllocator&) = delete;
+
+            Allocation allocate(uintptr_t size, uintptr_t alignment = granularity);
+            void       free    (Allocation& allocation);
+
+            BufferGpu& getBuffer(const Allocation& allocation) {return block[allocation.block];}
+            BufferGpu& getBuffer(uint32_t blockIndex)          {return block[blockIndex];}
+            uint32_t   getBlockCount() const {return uint32_t(block.size());}
+            uintptr_t  getBlockSize () const {return blockSize;}
+
+            BufferGpuAllocatorStatistics getStatistics() const;
+        private:
+            //TLSF (two level segregated fit): free ranges are sorted into lists by the power of two of their size (first level)
+            //and a linear subdivision of that (second level). Both levels have bitmaps of non empty lists, so finding a fitting range is O(1).
+            static constexpr uint32_t  granularity  = 16;
+            static constexpr uint32_t  slBits       = 4;
+            static constexpr uint32_t  slCount      = 1 << slBits;
+            static constexpr uint32_t  smallSizeLog2 = 8; //sizes below 256 byte (granularity * slCount) are all in first level 0
+            static constexpr uint32_t  flCount      = 64 - smallSizeLog2 + 1;
+
+            struct Node {
+                uintptr_t offset       = 0;
+                uintptr_t size         = 0;
+                uint32_t  block        = invalidIndex; //invalidIndex for unused nodes
+                uint32_t  prevPhysical = invalidIndex;
+                uint32_t  nextPhysical = invalidIndex;
+                uint32_t  prevFree     = invalidIndex;
+                uint32_t  nextFree     = invalidIndex;
+                bool      isFree       = false;
+            };
+
+            uintptr_t              blockSize;
+            bool                   clientMemoryCopyable;
+            std::deque<BufferGpu>  block; //deque, because BufferGpu must not be copied on growth
+            std::vector<Node>      node;
+            std::vector<uint32_t>  unusedNode;
+
+            uint64_t flBitmap = 0;
+            uint32_t slBitmap[flCount] = {};
+            uint32_t freeHead[flCount][slCount];
+
+            uintptr_t usedSize        = 0;
+            uint32_t  allocationCount = 0;
+
+            static void mapping(uintptr_t size, uint32_t& fl, uint32_t& sl);
+            uint32_t findFree  (uintptr_t size);
+            void     insertFree(uint32_t nodeIndex);
+            void     removeFree(uint32_t nodeIndex);
+            uint32_t newNode   ();
+            void     releaseNode(uint32_t nodeIndex);
+            void     addBlock  (uintptr_t minimumSize);
+    };
+}
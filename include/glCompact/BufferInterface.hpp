@@ -10,6 +10,7 @@ namespace glCompact {
             friend class PipelineRasterization;
             friend class PipelineCompute;
             friend class Frame;
+            friend class TransformFeedback;
         public:
             void copyFromBuffer                  (const BufferInterface& srcBuffer, uintptr_t   srcOffset, uintptr_t thisOffset, uintptr_t size);
             void copyFromBufferViaPipelineCompute(const BufferInterface& srcBuffer, uintptr_t   srcOffset, uintptr_t thisOffset, uintptr_t size);
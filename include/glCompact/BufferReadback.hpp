@@ -0,0 +1,69 @@
+#pragma once
+#include "glCompact/BufferStaging.hpp"
+#include "glCompact/Fence.hpp"
+#include "glCompact/CastAnyPtr.hpp"
+#include "glCompact/MemorySurfaceFormat.hpp"
+
+#include <cstdint> //C++11
+#include <deque>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace glCompact {
+    class TextureInterface;
+    class Frame;
+    class BufferReadbackPool;
+    class BufferReadback {
+            friend class BufferReadbackPool;
+        public:
+            BufferReadback() = default;
+            BufferReadback           (const BufferReadback&  readback) = delete;
+            BufferReadback           (      BufferReadback&& readback);
+            BufferReadback& operator=(const BufferReadback&  readback) = delete;
+            BufferReadback& operator=(      BufferReadback&& readback);
+            ~BufferReadback();
+
+            bool       isValid() const {return pool != 0;}
+            bool       isReady();
+            bool       wait(uint64_t timeoutInNanoseconds = ~0);
+            CastAnyPtr getPtr ();
+            uintptr_t  getSize     () const {return size;}
+            uintptr_t  getRowStride() const {return rowStride;}
+            void       release();
+        private:
+            BufferReadbackPool* pool      = 0;
+            uint32_t            entry     = 0;
+            uintptr_t           size      = 0;
+            uintptr_t           rowStride = 0; //0 for buffer readbacks
+            bool                ready     = false;
+    };
+
+    class BufferReadbackPool {
+            friend class BufferReadback;
+        public:
+            BufferReadbackPool() = default;
+            BufferReadbackPool           (const BufferReadbackPool&) = delete;
+            BufferReadbackPool& operator=(const BufferReadbackPool&) = delete;
+            ~BufferReadbackPool() = default;
+
+            BufferReadback readback     (const BufferInterface& srcBuffer, uintptr_t srcOffset, uintptr_t size);
+            BufferReadback readback     (const TextureInterface& texture, MemorySurfaceFormat memorySurfaceFormat, uint32_t mipmapLevel, glm::ivec3 texOffset, glm::ivec3 texSize);
+            BufferReadback readbackRgba (Frame& frame, uint32_t rgbaSlot, MemorySurfaceFormat memorySurfaceFormat, glm::ivec2 offset, glm::ivec2 size);
+            BufferReadback readbackDepth(Frame& frame,                    MemorySurfaceFormat memorySurfaceFormat, glm::ivec2 offset, glm::ivec2 size);
+
+            uint32_t  getBufferCount() const {return uint32_t(entry.size());}
+            uintptr_t getPoolSize   () const;
+        private:
+            struct Entry {
+                Entry(uintptr_t size) : buffer(size) {}
+                BufferStaging buffer;
+                Fence         fence;
+                bool          inUse = false;
+            };
+            std::deque<Entry> entry; //deque, because Fence and BufferStaging must not be moved on growth
+
+            uint32_t       acquire(uintptr_t size);
+            BufferReadback submit (uint32_t entryIndex, uintptr_t size, uintptr_t rowStride);
+            static uintptr_t getRowStride(MemorySurfaceFormat memorySurfaceFormat, int32_t width);
+    };
+}
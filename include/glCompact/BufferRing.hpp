@@ -0,0 +1,60 @@
+#pragma once
+#include "glCompact/BufferStaging.hpp"
+#include "glCompact/Fence.hpp"
+#include "glCompact/CastAnyPtr.hpp"
+
+#include <cstdint> //C++11
+#include <vector>
+
+namespace glCompact {
+    class BufferRing {
+        public:
+            struct Allocation {
+                uintptr_t  offset = 0; //byte offset inside of getBuffer()
+                uintptr_t  size   = 0;
+                void*      mem    = 0;
+                CastAnyPtr getPtr() const {return mem;}
+            };
+
+            BufferRing(uintptr_t segmentSize, uint32_t segmentCount = 3);
+            BufferRing           (const BufferRing&) = delete;
+            BufferRing& operator=(const BufferRing&) = delete;
+            ~BufferRing() = default;
+
+            Allocation allocate             (uintptr_t size, uintptr_t alignment = 4);
+            Allocation allocateUniform      (uintptr_t size);
+            Allocation allocateShaderStorage(uintptr_t size);
+
+            void flushWrites();
+            void nextSegment();
+
+            const BufferStaging& getBuffer      () const {return buffer;}
+            uintptr_t            getSegmentSize () const {return segmentSize;}
+            uint32_t             getSegmentCount() const {return uint32_t(segment.size());}
+            uintptr_t            getSegmentUsed () const {return head - segmentBegin();}
+
+            uint64_t getStallCount      () const {return stallCount;}
+            uint64_t getStallNanoseconds() const {return stallNanoseconds;}
+            void     resetStallCounter  ();
+        private:
+            struct Segment {
+                Fence fence;
+                bool  inUse = false; //fence got inserted and the segment was not reused yet
+            };
+
+            uintptr_t            segmentSize;
+            BufferStaging        buffer;
+            std::vector<Segment> segment;
+            uint32_t             segmentIndex      = 0;
+            uint32_t             frameSegmentIndex = 0; //first segment used since the last nextSegment()
+            uintptr_t            head              = 0;
+            uintptr_t            flushBegin        = 0;
+
+            uint64_t stallCount       = 0;
+            uint64_t stallNanoseconds = 0;
+
+            uintptr_t segmentBegin() const {return uintptr_t(segmentIndex) * segmentSize;}
+            void      advanceSegment();
+            void      waitForSegment(Segment& s);
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "glCompact/IndexType.hpp"
+
+#include <cstdint> //C++11
+#include <cstddef>
+#include <vector>
+#include <new>
+#include <type_traits>
+
+namespace glCompact {
+    class PipelineInterface;
+    class PipelineRasterization;
+    class PipelineCompute;
+    class TextureInterface;
+    class BufferInterface;
+    class Sampler;
+    class CommandList {
+            friend class DrawQueue;
+        public:
+            CommandList(std::size_t reserveByteSize = 0);
+
+            void setTexture             (PipelineInterface& pipeline, uint32_t slot, const TextureInterface& texture);
+            void setTexture             (PipelineInterface& pipeline, uint32_t slot);
+            void setSampler             (PipelineInterface& pipeline, uint32_t slot, const Sampler& sampler);
+            void setSampler             (PipelineInterface& pipeline, uint32_t slot);
+            void setUniformBuffer       (PipelineInterface& pipeline, uint32_t slot, const BufferInterface& buffer, uintptr_t offset = 0);
+            void setUniformBuffer       (PipelineInterface& pipeline, uint32_t slot, const BufferInterface& buffer, uintptr_t offset, uintptr_t size);
+            void setUniformBuffer       (PipelineInterface& pipeline, uint32_t slot);
+
+            void setAttributeBuffer     (PipelineRasterization& pipeline, uint32_t slot, const BufferInterface& buffer, uintptr_t offset = 0);
+            void setAttributeBuffer     (PipelineRasterization& pipeline, uint32_t slot);
+            void setAttributeIndexBuffer(PipelineRasterization& pipeline, IndexType indexType, const BufferInterface& buffer, uintptr_t offset = 0);
+            void setAttributeIndexBuffer(PipelineRasterization& pipeline);
+
+            //Records uniformSetter = value, e.g. commandList.setUniform(myPipeline.color, glm::vec4(1.0f))
+            template<typename S, typename T>
+            void setUniform(S& uniformSetter, const T& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "CommandList can only record uniform values of trivially copyable types");
+                static_assert(alignof(T) <= alignment, "CommandList can not record uniform values with an alignment above 8 bytes");
+                char* p = allocate(CommandType::setUniform, sizeof(UniformHeader) + sizeof(T));
+                UniformHeader* header = new (p) UniformHeader;
+                header->apply         = &applyUniform<S, T>;
+                header->uniformSetter = &uniformSetter;
+                new (p + sizeof(UniformHeader)) T(value);
+            }
+
+            void draw                   (PipelineRasterization& pipeline, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,                       uint32_t firstInstance);
+            void drawIndexed            (PipelineRasterization& pipeline, uint32_t indexCount,  uint32_t instanceCount, uint32_t firstIndex , int32_t vertexOffset, uint32_t firstInstance);
+            void drawIndirect           (PipelineRasterization& pipeline, const BufferInterface& parameterBuffer, intptr_t parameterBufferOffset, uint32_t count, uint32_t stride = 16);
+            void drawIndexedIndirect    (PipelineRasterization& pipeline, const BufferInterface& parameterBuffer, intptr_t parameterBufferOffset, uint32_t count, uint32_t stride = 20);
+
+            void dispatch               (PipelineCompute& pipeline, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+            void dispatchIndirect       (PipelineCompute& pipeline, const BufferInterface& buffer, uintptr_t offset);
+
+            void replay() const;
+            void clear();
+
+            uint32_t    getCommandCount() const {return commandCount;}
+            std::size_t getByteSize    () const {return data.size();}
+            std::size_t getCapacity    () const {return data.capacity();}
+        private:
+            static constexpr uint32_t alignment = 8;
+
+            enum class CommandType : uint32_t {
+                setTexture,
+                setTextureNone,
+                setSampler,
+                setSamplerNone,
+                setUniformBuffer,
+                setUniformBufferNone,
+                setAttributeBuffer,
+                setAttributeBufferNone,
+                setAttributeIndexBuffer,
+                setAttributeIndexBufferNone,
+                setUniform,
+                draw,
+                drawIndexed,
+                drawIndirect,
+                drawIndexedIndirect,
+                dispatch,
+                dispatchIndirect
+            };
+
+            //Every command starts with this, size includes the header and padding to the next command
+            struct CommandHeader {
+                CommandType type;
+                uint32_t    size;
+            };
+
+            struct UniformHeader {
+                void (*apply)(void* uniformSetter, const void* value);
+                void* uniformSetter;
+            };
+
+            template<typename S, typename T>
+            static void applyUniform(void* uniformSetter, const void* value) {
+                *static_cast<S*>(uniformSetter) = *static_cast<const T*>(value);
+            }
+
+            std::vector<char> data;
+            uint32_t          commandCount = 0;
+
+            void  replay(std::size_t byteBegin, std::size_t byteEnd) const;
+            char* allocate(CommandType type, uint32_t payloadSize);
+            template<typename T>
+            T*    allocate(CommandType type);
+    };
+}
@@ -0,0 +1,17 @@
+///@file
+#pragma once
+#include <cstdint> //C++11
+
+namespace glCompact {
+    enum class ConditionalRenderMode : int32_t {
+        wait                   = 0x8E13, //GL_QUERY_WAIT, the GPU waits for the query result
+        noWait                 = 0x8E14, //GL_QUERY_NO_WAIT, the GPU may render if the result is not available yet
+        byRegionWait           = 0x8E15, //GL_QUERY_BY_REGION_WAIT
+        byRegionNoWait         = 0x8E16, //GL_QUERY_BY_REGION_NO_WAIT
+        //inverted conditions, rendering only happens if the query did not pass. GL_ARB_conditional_render_inverted (Core since 4.5)
+        waitInverted           = 0x8E17, //GL_QUERY_WAIT_INVERTED
+        noWaitInverted         = 0x8E18, //GL_QUERY_NO_WAIT_INVERTED
+        byRegionWaitInverted   = 0x8E19, //GL_QUERY_BY_REGION_WAIT_INVERTED
+        byRegionNoWaitInverted = 0x8E1A  //GL_QUERY_BY_REGION_NO_WAIT_INVERTED
+    };
+}
@@ -10,6 +10,7 @@
 #include "glCompact/BlendFactors.hpp"
 #include "glCompact/BlendEquations.hpp"
 #include "glCompact/SurfaceFormatDetail.hpp"
+#include "glCompact/Statistics.hpp"
 
 #include <glm/fwd.hpp>
 
@@ -18,7 +19,12 @@
 
 namespace glCompact {
     class PipelineInterface;
+    class PipelineRasterization;
     class PipelineCompute;
+    class PipelineComputeMipmap_;
+    class GpuTimer;
+    class OcclusionQuery;
+    class TransformFeedback;
 
     class Context_ {
         public:
@@ -38,6 +44,11 @@ namespace glCompact {
             Frame displayFrame;
             Frame* pending_frame = 0;
             Frame* current_frame = 0;
+            GpuTimer* frameGpuTimer = 0; //GpuTimer of pending_frame, running while it is set as draw frame
+            const OcclusionQuery* runningOcclusionQuery           = 0; //only one occlusion query can be active at a time
+            const OcclusionQuery* conditionalRenderOcclusionQuery = 0; //set by setCondition()
+            TransformFeedback*    transformFeedback               = 0; //between TransformFeedback::begin() and end()
+            bool                  transformFeedbackCapturing      = false; //transformFeedback is set and not paused, no other program can be bound
 
             //output frame
             std::string rgbaSurfaceFormatString;
@@ -77,11 +88,51 @@ namespace glCompact {
             bool       buffer_attribute_index_enabled = 0;
             uint32_t   buffer_attribute_index_id      = 0;
 
+            //VERTEX ARRAY CACHE (setVertexArrayCache)
+            //With vertexArrayCacheSize above 0 every distinct attribute layout gets its own VAO. The attribute states above always belong to the bound VAO,
+            //the states of all others are kept in their VertexArrayState.
+            struct VertexArrayState {
+                uint32_t         id       = 0;  //0 if the VAO got deleted, free for reuse
+                uint64_t         lastUse  = 0;
+                AttributeLayout_ attributeLayout_;
+                 int32_t         buffer_attribute_highestIndexNonNull = -1;
+                uint32_t         buffer_attribute_id    [config::MAX_ATTRIBUTES] = {};
+                uintptr_t        buffer_attribute_offset[config::MAX_ATTRIBUTES] = {};
+                uint32_t         buffer_attribute_index_id = 0;
+            };
+            uint32_t                      vertexArrayCacheSize    = 0;
+            std::vector<VertexArrayState> vertexArrayCache;
+            VertexArrayState              vertexArrayDefault;           //states of defaultVaoId while a cached VAO is bound
+             int32_t                      vertexArrayCurrent      = -1; //index into vertexArrayCache, -1 for defaultVaoId
+            uint64_t                      vertexArrayUseCounter   = 0;
+
+            bool cachedBindVertexArray(const AttributeLayout_& attributeLayout, int32_t& indexHint);
+            void vertexArrayBindDefault();
+            void vertexArrayCacheClear();
+            void vertexArrayStateSwap(int32_t index);
+
             //BUFFER INDIRECT
             uint32_t   buffer_draw_indirect_id     = 0;
             uint32_t   buffer_dispatch_indirect_id = 0;
             uint32_t   buffer_parameter_id         = 0;
 
+            //DRAW BATCHING (setDrawBatching)
+            //Consecutive draws of the same pipeline without state changes in between are collected here and submitted as one glMultiDraw*Indirect
+            bool                   drawBatchEnabled      = false;
+            PipelineRasterization* drawBatchPipeline     = nullptr;
+            bool                   drawBatchIndexed      = false;
+            uint32_t               drawBatchPrimitive    = 0;
+            uint32_t               drawBatchIndexType    = 0;
+            uint32_t               drawBatchCount        = 0;
+            std::vector<uint32_t>  drawBatchCommand;  //packed DrawIndirectCommand (4 x uint32_t) or DrawElementsIndirectCommand (5 x uint32_t) structures
+            uint32_t               drawBatchBufferId     = 0;
+            uint32_t               drawBatchBufferOffset = 0;
+            static constexpr uint32_t drawBatchBufferSize = 64 * 1024;
+
+            //Must be called before anything that emits GL commands that may depend on the order of already issued draws
+            void flushDrawBatch() {if (drawBatchCount) submitDrawBatch();}
+            void submitDrawBatch();
+
             //BUFFER UNIFORM
             size_t     buffer_uniform_count;
              int32_t   buffer_uniform_getHighestIndexNonNull();
@@ -191,6 +242,7 @@ namespace glCompact {
             //Multi sample
             bool multiSample = true; //default enabled, if disabled fill all samples of a texel with the same value!
 
+            bool rasterizerDiscard = false;
 
             //BARRIER
             uint32_t memoryBarrierMask = 0;
@@ -204,6 +256,13 @@ namespace glCompact {
 
             //helper
             PipelineCompute* pipelineComputeCopy = nullptr;
+            std::vector<PipelineComputeMipmap_*> pipelineComputeMipmap;
+
+            //STATISTICS
+            #ifdef GLCOMPACT_STATISTICS
+                std::vector<uint64_t>  statistics_glCallCount;
+                Statistics::StateCheck statistics_stateCheck[uint32_t(StatisticsCategory::count)];
+            #endif
 
             void cachedBindTextureCompatibleOrFirstTime(uint32_t texSlot, int32_t texTarget, uint32_t texId);
             void cachedBindTexture                     (uint32_t texSlot, int32_t texTarget, uint32_t texId);
@@ -218,6 +277,7 @@ namespace glCompact {
             void cachedViewport            (glm::uvec2 offset, glm::uvec2 size);
             void cachedScissorEnabled      (bool enabled);
             void cachedScissor             (glm::uvec2 offset, glm::uvec2 size);
+            void cachedRasterizerDiscard   (bool enabled);
 
             void cachedBindPixelPackBuffer  (uint32_t bufferId);
             void cachedBindPixelUnpackBuffer(uint32_t bufferId);
@@ -229,6 +289,8 @@ namespace glCompact {
             void cachedBindDispatchIndirectBuffer(uint32_t bufferId);
             void cachedBindParameterBuffer       (uint32_t bufferId);
 
+            void switchFrameGpuTimer(GpuTimer* gpuTimer);
+
             void setGlState(uint32_t state,                 bool enable);
             void setGlState(uint32_t state, uint32_t index, bool enable);
 
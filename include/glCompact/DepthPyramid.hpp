@@ -0,0 +1,31 @@
+#pragma once
+#include "glCompact/Texture2d.hpp"
+#include "glCompact/BufferGpu.hpp"
+#include "glCompact/MipmapFilter.hpp"
+
+#include <cstdint> //C++11
+#include <glm/vec2.hpp>
+
+namespace glCompact {
+    class Frame;
+    class DepthPyramid {
+        public:
+            DepthPyramid(MipmapFilter mipmapFilter = MipmapFilter::max);
+            DepthPyramid           (const DepthPyramid&) = delete;
+            DepthPyramid& operator=(const DepthPyramid&) = delete;
+            ~DepthPyramid() = default;
+
+            void build(Frame& frame);
+            void free();
+
+                  Texture2d&   getTexture()           {return texture;}
+            const Texture2d&   getTexture()     const {return texture;}
+                  glm::uvec2   getSize()        const {return glm::uvec2(texture.getSize());}
+                  uint32_t     getMipmapCount() const {return texture.getMipmapCount();}
+                  MipmapFilter getMipmapFilter()const {return mipmapFilter;}
+        private:
+            const MipmapFilter mipmapFilter;
+            Texture2d          texture;
+            BufferGpu          depthBuffer; //level 0 goes from the frame into this buffer and from there into the texture, all on the GPU
+    };
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint> //C++11
+
+namespace glCompact {
+    //Parameter buffer record of PipelineRasterization::drawIndirect/drawIndirectCount (stride 16)
+    struct DrawIndirectCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t first;
+        uint32_t baseInstance;
+    };
+    static_assert(sizeof(DrawIndirectCommand) == 16, "DrawIndirectCommand must be tightly packed");
+
+    //Parameter buffer record of PipelineRasterization::drawIndexedIndirect/drawIndexedIndirectCount (stride 20)
+    struct DrawElementsIndirectCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t  baseVertex;
+        uint32_t baseInstance;
+    };
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must be tightly packed");
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "glCompact/CommandList.hpp"
+#include "glCompact/IndexType.hpp"
+
+#include <cstdint> //C++11
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+namespace glCompact {
+    struct DrawQueueStatistics {
+        uint32_t packetCount          = 0;
+        uint32_t programBindsUnsorted = 0; //pipeline changes if the packets would have been submitted in the order they were added
+        uint32_t programBinds         = 0; //pipeline changes of the sorted submission
+        uint32_t textureBindsUnsorted = 0; //texture slot changes if the packets would have been submitted in the order they were added
+        uint32_t textureBinds         = 0; //texture slot changes of the sorted submission
+        uint32_t bufferSetsUnsorted   = 0; //changes of the attribute/index/uniform buffer set in the order the packets were added
+        uint32_t bufferSets           = 0; //changes of the attribute/index/uniform buffer set of the sorted submission
+        uint32_t getProgramBindsSaved() const {return programBindsUnsorted - programBinds;}
+        uint32_t getTextureBindsSaved() const {return textureBindsUnsorted - textureBinds;}
+        uint32_t getBufferSetsSaved  () const {return bufferSetsUnsorted   - bufferSets;}
+    };
+
+    class PipelineRasterization;
+    class TextureInterface;
+    class BufferInterface;
+    class DrawQueue {
+        public:
+            //Returned by DrawQueue::add(), records the bindings and uniforms of one draw. The packet is complete after one of the draw functions got called.
+            class Packet {
+                    friend class DrawQueue;
+                public:
+                    Packet& setTexture             (uint32_t slot, const TextureInterface& texture);
+                    Packet& setUniformBuffer       (uint32_t slot, const BufferInterface& buffer, uintptr_t offset = 0);
+                    Packet& setUniformBuffer       (uint32_t slot, const BufferInterface& buffer, uintptr_t offset, uintptr_t size);
+                    Packet& setAttributeBuffer     (uint32_t slot, const BufferInterface& buffer, uintptr_t offset = 0);
+                    Packet& setAttributeIndexBuffer(IndexType indexType, const BufferInterface& buffer, uintptr_t offset = 0);
+                    template<typename S, typename T>
+                    Packet& setUniform(S& uniformSetter, const T& value) {
+                        drawQueue.commandList.setUniform(uniformSetter, value);
+                        return *this;
+                    }
+
+                    void draw       (uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,                       uint32_t firstInstance);
+                    void drawIndexed(uint32_t indexCount,  uint32_t instanceCount, uint32_t firstIndex , int32_t vertexOffset, uint32_t firstInstance);
+                private:
+                    Packet(DrawQueue& drawQueue, PipelineRasterization& pipeline):drawQueue(drawQueue),pipeline(pipeline){}
+                    DrawQueue&             drawQueue;
+                    PipelineRasterization& pipeline;
+            };
+
+            Packet add(PipelineRasterization& pipeline, uint8_t layer = 0);
+            void   submit();
+            void   clear();
+
+            uint32_t            getPacketCount() const {return uint32_t(packet.size());}
+            DrawQueueStatistics getStatistics () const {return statistics;}
+        private:
+            struct PacketInfo {
+                uint64_t               key;
+                PipelineRasterization* pipeline;
+                std::size_t            commandBegin;
+                std::size_t            commandEnd;
+                uint32_t               textureBegin;
+                uint32_t               textureCount;
+                uint8_t                layer;
+                uint64_t               textureSetHash;
+                uint64_t               bufferSetHash;
+            };
+            struct TextureBinding {
+                uint32_t                slot;
+                const TextureInterface* texture;
+            };
+            struct SortEntry {
+                uint64_t key;
+                uint32_t packetIndex;
+            };
+            struct BindState {
+                const PipelineRasterization*         pipeline      = nullptr;
+                uint64_t                             bufferSetHash = 0;
+                bool                                 hasBufferSet  = false;
+                std::vector<const TextureInterface*> slotTexture;
+                void reset();
+            };
+
+            CommandList                 commandList;
+            std::vector<PacketInfo>     packet;
+            std::vector<TextureBinding> textureBinding;
+            std::vector<SortEntry>      sortEntry;
+            std::vector<SortEntry>      sortEntryTemp;
+            BindState                   unsortedBindState;
+            BindState                   sortedBindState;
+
+            std::unordered_map<const PipelineRasterization*, uint32_t> pipelineIndex;
+            std::unordered_map<uint64_t, uint32_t>                     textureSetIndex;
+            std::unordered_map<uint64_t, uint32_t>                     bufferSetIndex;
+
+            bool     packetOpen    = false;
+            uint64_t bufferSetHash = 0;
+            DrawQueueStatistics statistics;
+            DrawQueueStatistics pendingStatistics; //of the packets added since the last submit()/clear()
+
+            void finishPacket();
+            void sortPackets();
+            void countBinds(const PacketInfo& info, BindState& bindState, uint32_t& programBinds, uint32_t& textureBinds, uint32_t& bufferSets);
+    };
+}
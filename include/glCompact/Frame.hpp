@@ -9,11 +9,13 @@
 #include <glm/vec4.hpp>
 
 namespace glCompact {
+    class GpuTimer;
     class Frame;
     class Frame {
             friend class Context;
             friend class Context_;
             friend void setDrawFrame(Frame& frame);
+            friend void setDrawFrame();
             friend void setDisplayFrameSize(uint32_t x, uint32_t y);
         public:
             Frame() = default;
@@ -39,6 +41,10 @@ namespace glCompact {
             void setViewport();
             void setScissor ();
 
+            //Measures the GPU time of everything issued while this frame is set as draw frame via setDrawFrame()
+            void      setGpuTimer(GpuTimer* gpuTimer);
+            GpuTimer* getGpuTimer() const {return gpuTimer;}
+
             //By default access to sRGB targets gets automatically converted between sRGB and linear color space.
             //Note that this has has no influence on sampling from sRGB textures.
             //TODO: GLES always converts?!
@@ -104,6 +110,7 @@ namespace glCompact {
             glm::uvec2  scissorOffset   = {0, 0};
             glm::uvec2  scissorSize     = {0, 0};
             uint8_t currentRgbaReadSlot = 0;
+            GpuTimer*   gpuTimer        = nullptr;
 
             SurfaceFormat depthAndOrStencilSurfaceFormat;
             SurfaceFormat rgbaSurfaceFormat[config::MAX_RGBA_ATTACHMENTS];
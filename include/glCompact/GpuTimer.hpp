@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint> //C++11
+#include <vector>
+
+namespace glCompact {
+    class GpuTimer {
+        public:
+            GpuTimer(uint32_t ringSize = 4);
+            GpuTimer           (const GpuTimer&) = delete;
+            GpuTimer& operator=(const GpuTimer&) = delete;
+            ~GpuTimer();
+            void free();
+
+            void begin();
+            void end();
+            bool isRunning() const {return running;}
+
+            bool     hasResult();
+            uint64_t getResult();
+            uint64_t getResultCount() const {return resultCount;}
+            uint32_t getPendingCount() const;
+            uint32_t getRingSize() const {return uint32_t(slot.size());}
+
+            class Scope {
+                public:
+                    Scope(GpuTimer& gpuTimer):gpuTimer(gpuTimer){gpuTimer.begin();}
+                    Scope           (const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+                    ~Scope(){gpuTimer.end();}
+                private:
+                    GpuTimer& gpuTimer;
+            };
+        private:
+            struct Slot {
+                uint32_t queryId[2] = {}; //GL_TIMESTAMP at begin and end
+                uint64_t sequence   = 0;
+                bool     pending    = false;
+            };
+            std::vector<Slot> slot;
+            uint32_t nextSlot       = 0;
+            uint32_t runningSlot    = 0;
+            bool     running        = false;
+            uint64_t nextSequence   = 1;
+            uint64_t resultSequence = 0;
+            uint64_t result         = 0;
+            uint64_t resultCount    = 0;
+
+            void resolve();
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint> //C++11
+#include <string>
+
+namespace glCompact {
+    //32 bit FNV-1a of the null terminated string s, continuing from hash
+    constexpr uint32_t hashName(const char* s, uint32_t hash = 2166136261u) {
+        return *s ? hashName(s + 1, (hash ^ uint8_t(*s)) * 16777619u) : hash;
+    }
+
+    inline uint32_t hashName(const std::string& s, uint32_t hash = 2166136261u) {
+        for (char c : s) hash = (hash ^ uint8_t(c)) * 16777619u;
+        return hash;
+    }
+
+    /*
+        Name of a shader resource together with its hash, for the name index of PipelineInterface.
+
+        Constructed from a string literal the constructor is constexpr, so the hash can be computed at compile time:
+
+            static constexpr HashedName modelName("model");
+
+        Only keeps a pointer to the name, so it must not outlive the string it was constructed from.
+    */
+    class HashedName {
+        public:
+            constexpr HashedName(const char* name): name(name), hash(hashName(name)) {}
+            HashedName(const std::string& name): name(name.c_str()), hash(hashName(name)) {}
+
+            const char* name;
+            uint32_t    hash;
+    };
+}
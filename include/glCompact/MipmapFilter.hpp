@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint> //C++11
+
+namespace glCompact {
+    enum class MipmapFilter : uint8_t {
+        box,    //average of 2x2 texels, what glGenerateMipmap usually does
+        kaiser, //6x6 taps Kaiser windowed sinc, sharper than box
+        min,    //minimum of the covered texels, e.g. for reversed-Z depth pyramids
+        max     //maximum of the covered texels, e.g. for depth pyramids (Hi-Z) used for occlusion culling
+    };
+}
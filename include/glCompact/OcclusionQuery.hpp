@@ -0,0 +1,72 @@
+#pragma once
+#include "glCompact/OcclusionQueryType.hpp"
+#include "glCompact/ConditionalRenderMode.hpp"
+
+#include <cstdint> //C++11
+#include <vector>
+
+namespace glCompact {
+    class OcclusionQuery;
+    void setCondition(const OcclusionQuery& occlusionQuery, ConditionalRenderMode conditionalRenderMode = ConditionalRenderMode::wait);
+    void setCondition();
+
+    class OcclusionQuery {
+            friend void setCondition(const OcclusionQuery& occlusionQuery, ConditionalRenderMode conditionalRenderMode);
+        public:
+            OcclusionQuery(OcclusionQueryType occlusionQueryType = OcclusionQueryType::anySamplesPassed, uint32_t ringSize = 4);
+            OcclusionQuery           (const OcclusionQuery&) = delete;
+            OcclusionQuery& operator=(const OcclusionQuery&) = delete;
+            ~OcclusionQuery();
+            void free();
+
+            void begin();
+            void end();
+            bool isRunning() const {return running;}
+
+            bool     hasResult();
+            uint64_t getResult();
+            uint64_t waitResult();
+            uint64_t getResultCount() const {return resultCount;}
+            uint32_t getPendingCount() const;
+            uint32_t getRingSize() const {return uint32_t(slot.size());}
+            OcclusionQueryType getType() const {return occlusionQueryType;}
+
+            class Scope {
+                public:
+                    Scope(OcclusionQuery& occlusionQuery):occlusionQuery(occlusionQuery){occlusionQuery.begin();}
+                    Scope           (const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+                    ~Scope(){occlusionQuery.end();}
+                private:
+                    OcclusionQuery& occlusionQuery;
+            };
+        private:
+            struct Slot {
+                uint32_t queryId  = 0;
+                uint64_t sequence = 0;
+                bool     pending  = false;
+            };
+            const OcclusionQueryType occlusionQueryType;
+            std::vector<Slot> slot;
+            uint32_t nextSlot       = 0;
+            uint32_t runningSlot    = 0;
+            int32_t  lastEndedSlot  = -1; //used by setCondition()
+            bool     running        = false;
+            uint64_t nextSequence   = 1;
+            uint64_t resultSequence = 0;
+            uint64_t result         = 0;
+            uint64_t resultCount    = 0;
+
+            void resolve();
+            void resolveSlot(Slot& s, uint64_t value);
+    };
+
+    //Draws inside of the scope are only executed if the last ended query of occlusionQuery passed
+    class ConditionalRenderScope {
+        public:
+            ConditionalRenderScope(const OcclusionQuery& occlusionQuery, ConditionalRenderMode conditionalRenderMode = ConditionalRenderMode::wait){setCondition(occlusionQuery, conditionalRenderMode);}
+            ConditionalRenderScope           (const ConditionalRenderScope&) = delete;
+            ConditionalRenderScope& operator=(const ConditionalRenderScope&) = delete;
+            ~ConditionalRenderScope(){setCondition();}
+    };
+}
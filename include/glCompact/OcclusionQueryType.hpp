@@ -0,0 +1,11 @@
+///@file
+#pragma once
+#include <cstdint> //C++11
+
+namespace glCompact {
+    enum class OcclusionQueryType : int32_t {
+        samplesPassed                = 0x8914, //GL_SAMPLES_PASSED, exact amount of samples that passed the depth and stencil test
+        anySamplesPassed             = 0x8C2F, //GL_ANY_SAMPLES_PASSED, 1 if any sample passed. GL_ARB_occlusion_query2 (Core since 3.3)
+        anySamplesPassedConservative = 0x8D6A  //GL_ANY_SAMPLES_PASSED_CONSERVATIVE, like anySamplesPassed but may report false positives, can be faster. GL_ARB_ES3_compatibility (Core since 4.3)
+    };
+}
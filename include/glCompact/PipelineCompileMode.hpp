@@ -0,0 +1,9 @@
+#pragma once
+#include <cstdint> //C++11
+
+namespace glCompact {
+    enum class PipelineCompileMode : uint8_t {
+        blocking, //the constructor waits until the program is compiled and linked
+        async     //the constructor only issues compiling and linking, see PipelineInterface::isReady()
+    };
+}
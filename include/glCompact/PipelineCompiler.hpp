@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint> //C++11
+#include <string>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+namespace glCompact {
+    class ContextScope;
+    struct PipelineCompilerJob_;
+    class PipelineCompiler {
+        public:
+            //Handle to a submitted pipeline, used to construct a PipelineRasterization or PipelineCompute on the render thread
+            class Job {
+                    friend class PipelineCompiler;
+                    friend class PipelineInterface;
+                public:
+                    bool isValid() const {return bool(job_);}
+                    bool isCompute() const;
+                    bool isReady();
+                    void wait();
+                    bool hasFailed();
+                    std::string getInfoLog();
+                private:
+                    std::shared_ptr<PipelineCompilerJob_> job_;
+            };
+
+            PipelineCompiler(
+                const ContextScope*                         contextScope,
+                std::function<void(uint32_t workerIndex)>   workerContextMakeCurrent,
+                std::function<void(uint32_t workerIndex)>   workerContextRelease = nullptr,
+                uint32_t                                    workerCount          = 1
+            );
+            PipelineCompiler           (const PipelineCompiler&) = delete;
+            PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+            ~PipelineCompiler();
+
+            Job compileRasterization(
+                const std::string& vertexString,
+                const std::string& tessControlString,
+                const std::string& tessEvalutionString,
+                const std::string& geometryString,
+                const std::string& fragmentString
+            );
+            Job compileCompute(const std::string& computeString);
+
+            uint32_t getWorkerCount() const {return uint32_t(worker.size());}
+            uint32_t getQueueSize();
+            void     waitIdle();
+        private:
+            const ContextScope*                       contextScope;
+            std::function<void(uint32_t workerIndex)> workerContextMakeCurrent;
+            std::function<void(uint32_t workerIndex)> workerContextRelease;
+            std::vector<std::thread>                  worker;
+
+            std::mutex                                        queueMutex;
+            std::condition_variable                           queueCondition;
+            std::condition_variable                           idleCondition;
+            std::deque<std::shared_ptr<PipelineCompilerJob_>> queue;
+            uint32_t                                          busyCount = 0;
+            bool                                              stop      = false;
+
+            Job  submit(std::shared_ptr<PipelineCompilerJob_> job);
+            void workerThread(uint32_t workerIndex);
+            static void compileJob(PipelineCompilerJob_& job);
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "glCompact/Fence.hpp"
+
+#include <cstdint> //C++11
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace glCompact {
+    /*
+        State of one PipelineCompiler job, shared by the worker thread and the PipelineCompiler::Job handle.
+        The worker only touches it until done is set, after that it belongs to the thread that holds the handle.
+        The last reference must be released on a thread with a glCompact context, because it may delete the program and the fence.
+    */
+    struct PipelineCompilerJob_ {
+        PipelineCompilerJob_() = default;
+        PipelineCompilerJob_           (const PipelineCompilerJob_&) = delete;
+        PipelineCompilerJob_& operator=(const PipelineCompilerJob_&) = delete;
+        ~PipelineCompilerJob_();
+
+        bool        compute      = false;
+        bool        hasShader[5] = {}; //rasterization: vertex, tessControl, tessEvalution, geometry, fragment; compute: only [0]
+        std::string shaderString[5];   //cleared by the worker after compiling
+
+        std::mutex              mutex;
+        std::condition_variable condition;
+        bool                    done = false;
+
+        //only valid after done
+        uint32_t          programId        = 0; //0 if compiling or linking failed
+        std::string       infoLog;
+        uint64_t          programCacheKey  = 0;
+        bool              fromProgramCache = false;
+        std::vector<char> programCacheInformation;
+        Fence             fence;                //inserted by the worker after linking
+        bool              fenceSignaled    = false;
+        bool              taken            = false; //program already handed over to a pipeline
+    };
+}
@@ -6,16 +6,22 @@
 #include <string>
 
 namespace glCompact {
+    class GpuTimer;
     class PipelineCompute;
     class PipelineCompute : public PipelineInterface {
         public:
-            PipelineCompute(const std::string& shaderString);
-            PipelineCompute(const std::string& path, const std::string& fileName);
+            PipelineCompute(const std::string& shaderString,                              PipelineCompileMode compileMode = PipelineCompileMode::blocking);
+            PipelineCompute(const std::string& path, const std::string& fileName, PipelineCompileMode compileMode = PipelineCompileMode::blocking);
+            PipelineCompute(PipelineCompiler::Job job);
 
             void dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
             void dispatchMinGroupCount(uint64_t groupCount);
             void dispatchIndirect(const BufferInterface& buffer, uintptr_t offset);
 
+            //Measures the GPU time of every dispatch, unless the GpuTimer is already running
+            void      setGpuTimer(GpuTimer* gpuTimer){this->gpuTimer = gpuTimer;}
+            GpuTimer* getGpuTimer() const {return gpuTimer;}
+
             glm::ivec3 getWorkGroupSize()const{return workGroupSize;}
             static glm::ivec3 getMaxWorkGroupCount();
             static glm::ivec3 getMaxWorkGroupSize();
@@ -25,10 +31,15 @@ namespace glCompact {
             std::string getPipelineInformationQueryString();
         private:
             glm::ivec3 workGroupSize;
-            void loadString_(const std::string& computeShaderString);
+            void loadString_(const std::string& computeShaderString, PipelineCompileMode compileMode);
+            virtual void loadFinish_();
+            void loadInformation_(const std::vector<char>* programCacheInformation);
             void collectInformation();
+            void writeInformation(ProgramCacheWriter_& writer) const;
+            void readInformation(ProgramCacheReader_& reader);
             const bool loadedFromFile = false;
             std::string fileName;
+            GpuTimer*   gpuTimer = nullptr;
 
             void processPendingChanges();
             void processPendingChangesPipeline();
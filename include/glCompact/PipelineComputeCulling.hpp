@@ -0,0 +1,35 @@
+#pragma once
+#include "glCompact/PipelineCompute.hpp"
+#include "glCompact/DrawIndirectCommand.hpp"
+
+#include <cstdint> //C++11
+#include <glm/glm.hpp>
+
+namespace glCompact {
+    class DepthPyramid;
+
+    //Input record of PipelineComputeCulling, std430 layout (48 byte)
+    struct CullingObject {
+        glm::vec4                   boundingSphere; //xyz world space center, w radius
+        DrawElementsIndirectCommand command;
+        uint32_t                    padding[3];
+    };
+    static_assert(sizeof(CullingObject) == 48, "CullingObject must match the std430 layout of the culling shader");
+
+    class PipelineComputeCulling : public PipelineCompute {
+        public:
+            PipelineComputeCulling(PipelineCompileMode compileMode = PipelineCompileMode::blocking);
+
+            void cull(BufferInterface& objectBuffer, uint32_t objectCount, BufferInterface& commandBuffer, BufferInterface& countBuffer, const glm::mat4& viewProjection);
+            void cull(BufferInterface& objectBuffer, uint32_t objectCount, BufferInterface& commandBuffer, BufferInterface& countBuffer, const glm::mat4& viewProjection, const DepthPyramid& depthPyramid, bool clipDepthZeroToOne = false);
+        private:
+            UniformSetter<uint32_t>  objectCount   {this, "objectCount"};
+            UniformSetter<glm::mat4> viewProjection{this, "viewProjection"};
+            UniformSetter<int32_t>   hiZ           {this, "hiZ"};
+            UniformSetter<int32_t>   depthZeroToOne{this, "depthZeroToOne"};
+            UniformSetter<int32_t>   depthReversed {this, "depthReversed"};
+
+            void dispatchCulling(BufferInterface& objectBuffer, uint32_t objectCount, BufferInterface& commandBuffer, BufferInterface& countBuffer, const glm::mat4& viewProjection);
+            static const std::string shaderString;
+    };
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "glCompact/PipelineCompute.hpp"
+#include "glCompact/MipmapFilter.hpp"
+
+#include <cstdint> //C++11
+#include <string>
+
+namespace glCompact {
+    /*
+        Compute downsampler used by TextureInterface::generateMipmapsViaPipelineCompute().
+        One dispatch reads one level via texelFetch and writes up to levelCountMax following levels via images.
+        One instance per image format and filter, owned by Context_.
+    */
+    class PipelineComputeMipmap_ final : public PipelineCompute {
+        public:
+            static constexpr uint32_t levelCountMax = 4;
+
+            PipelineComputeMipmap_(int32_t sizedFormat, MipmapFilter mipmapFilter);
+
+            const int32_t      sizedFormat;
+            const MipmapFilter mipmapFilter;
+            UniformSetter<int32_t> srcLod    {this, "srcLod"};
+            UniformSetter<int32_t> levelCount{this, "levelCount"};
+
+            static const char* getImageFormatQualifier(int32_t sizedFormat);
+        private:
+            static std::string getShaderString(int32_t sizedFormat, MipmapFilter mipmapFilter);
+    };
+}
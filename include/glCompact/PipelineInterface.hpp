@@ -4,6 +4,10 @@
 #include "glCompact/TextureSelector.hpp"
 #include "glCompact/SurfaceFormat.hpp"
 #include "glCompact/Sampler.hpp"
+#include "glCompact/PipelineCompileMode.hpp"
+#include "glCompact/PipelineCompiler.hpp"
+#include "glCompact/cppTypeToGlType.hpp"
+#include "glCompact/HashedName.hpp"
 
 #include <glm/fwd.hpp>
 
@@ -11,11 +15,19 @@
 #include <vector>
 #include <initializer_list> //We need to use initializer_list, because GCC has broken template arrays for unsigned int types until something like GCC 8.3
 #include <limits>
+#include <functional>
+#include <algorithm>
 
 namespace glCompact {
+    class ProgramCacheWriter_;
+    class ProgramCacheReader_;
+    struct PipelineCompilerJob_;
+    struct BlockLayoutDescription;
     class PipelineInterface {
             friend class Context_;
             friend class Sampler;
+            friend class PipelineCompiler;
+            friend class UniformBlockLayout;
         public:
             void setTexture              (uint32_t slot, const TextureInterface& texture);
             void setTexture              (uint32_t slot);
@@ -44,17 +56,19 @@ namespace glCompact {
 
             const std::string getInfoLog(){return infoLog_;}
 
+            //Only relevant for pipelines created with PipelineCompileMode::async
+            bool isReady();
+            void waitReady();
+
             void detachFromThreadContext();
 
-            //This needs GL_ARB_get_program_binary (Core since 4.1)
-            //on amd cards getting the binary works only if binaryRetrievableHint is set to true (not tested on nvidia, intel)
-            //Mesa drivers fake support for GL_ARB_get_program_binary by always rejecting to load the shader binary, to "fulfill" the minimum requirement for GL 4.1
-            //Modern drivers do this shader caching by them self (and more efficient!) in the background anyway. So it makes no sense to include this in the API.
-            //The only use I can come up with is injecting self made bytecode for specific GPUs
-            /*bool copyBinaryToMemory  (GLenum& binaryFormat, GLsizei bufSize, void* mem) const;
-            bool copyBinaryFromMemory(GLenum binaryFormat, GLsizei bufSize, const void* mem);
-            bool copyBinaryToFile    (const std::string& fileName) const;
-            bool copyBinaryFromFile  (const std::string& fileName);*/
+            void setUniformShadowing(bool enabled);
+            bool getUniformShadowing() const {return uniformShadowing;}
+
+            void verifyUniformBlockLayout(const std::string& blockName, const BlockLayoutDescription& description);
+            void verifyStorageBlockLayout(const std::string& blockName, const BlockLayoutDescription& description);
+
+            //Loading linked program binaries from disk is done by the program cache, see setProgramCacheDirectory()
         protected:
             /** UniformSetter
                 \brief class template to create an interface for a shader uniform or uniform array
@@ -97,94 +111,82 @@ namespace glCompact {
             template<typename T>
             class UniformSetter {
                 public:
-                    UniformSetter(PipelineInterface* const pParent, const std::string& uniformName) {
-                        constexpr int32_t cppType =
-                            std::is_same<T, float       >::value ? 0x1406 : //GL_FLOAT
-                            std::is_same<T, glm::vec2   >::value ? 0x8B50 : //GL_FLOAT_VEC2
-                            std::is_same<T, glm::vec3   >::value ? 0x8B51 : //GL_FLOAT_VEC3
-                            std::is_same<T, glm::vec4   >::value ? 0x8B52 : //GL_FLOAT_VEC4
-                            std::is_same<T, double      >::value ? 0x140A : //GL_DOUBLE
-                            std::is_same<T, glm::dvec2  >::value ? 0x8FFC : //GL_DOUBLE_VEC2
-                            std::is_same<T, glm::dvec3  >::value ? 0x8FFD : //GL_DOUBLE_VEC3
-                            std::is_same<T, glm::dvec4  >::value ? 0x8FFE : //GL_DOUBLE_VEC4
-                            std::is_same<T, int32_t     >::value ? 0x1404 : //GL_INT
-                            std::is_same<T, glm::ivec2  >::value ? 0x8B53 : //GL_INT_VEC2
-                            std::is_same<T, glm::ivec3  >::value ? 0x8B54 : //GL_INT_VEC3
-                            std::is_same<T, glm::ivec4  >::value ? 0x8B55 : //GL_INT_VEC4
-                            std::is_same<T, uint32_t    >::value ? 0x1405 : //GL_UNSIGNED_INT
-                            std::is_same<T, glm::uvec2  >::value ? 0x8DC6 : //GL_UNSIGNED_INT_VEC2
-                            std::is_same<T, glm::uvec3  >::value ? 0x8DC7 : //GL_UNSIGNED_INT_VEC3
-                            std::is_same<T, glm::uvec4  >::value ? 0x8DC8 : //GL_UNSIGNED_INT_VEC4
-                            std::is_same<T, bool        >::value ? 0x8B56 : //GL_BOOL
-                            std::is_same<T, glm::bvec2  >::value ? 0x8B57 : //GL_BOOL_VEC2
-                            std::is_same<T, glm::bvec3  >::value ? 0x8B58 : //GL_BOOL_VEC3
-                            std::is_same<T, glm::bvec4  >::value ? 0x8B59 : //GL_BOOL_VEC4
-                            std::is_same<T, glm::mat2x2 >::value ? 0x8B5A : //GL_FLOAT_MAT2
-                            std::is_same<T, glm::mat2x3 >::value ? 0x8B65 : //GL_FLOAT_MAT2x3
-                            std::is_same<T, glm::mat2x4 >::value ? 0x8B66 : //GL_FLOAT_MAT2x4
-                            std::is_same<T, glm::mat3x2 >::value ? 0x8B67 : //GL_FLOAT_MAT3x2
-                            std::is_same<T, glm::mat3x3 >::value ? 0x8B5B : //GL_FLOAT_MAT3
-                            std::is_same<T, glm::mat3x4 >::value ? 0x8B68 : //GL_FLOAT_MAT3x4
-                            std::is_same<T, glm::mat4x2 >::value ? 0x8B69 : //GL_FLOAT_MAT4x2
-                            std::is_same<T, glm::mat4x3 >::value ? 0x8B6A : //GL_FLOAT_MAT4x3
-                            std::is_same<T, glm::mat4x4 >::value ? 0x8B5C : //GL_FLOAT_MAT4
-                            std::is_same<T, glm::dmat2x2>::value ? 0x8F46 : //GL_DOUBLE_MAT2
-                            std::is_same<T, glm::dmat2x3>::value ? 0x8F49 : //GL_DOUBLE_MAT2x3
-                            std::is_same<T, glm::dmat2x4>::value ? 0x8F4A : //GL_DOUBLE_MAT2x4
-                            std::is_same<T, glm::dmat3x2>::value ? 0x8F4B : //GL_DOUBLE_MAT3x2
-                            std::is_same<T, glm::dmat3x3>::value ? 0x8F47 : //GL_DOUBLE_MAT3
-                            std::is_same<T, glm::dmat3x4>::value ? 0x8F4C : //GL_DOUBLE_MAT3x4
-                            std::is_same<T, glm::dmat4x2>::value ? 0x8F4D : //GL_DOUBLE_MAT4x2
-                            std::is_same<T, glm::dmat4x3>::value ? 0x8F4E : //GL_DOUBLE_MAT4x3
-                            std::is_same<T, glm::dmat4x4>::value ? 0x8F48 : //GL_DOUBLE_MAT4
-                            0;
-                        static_assert(cppType != 0, "Not a valid template type for UniformSetter");
-
-                        shaderId = pParent->id;
-                        int32_t type;
-                        for (auto& uniform : pParent->uniformList)
-                            if (uniform.name == uniformName) {
-                                location = uniform.location;
-                                type     = uniform.type;
-                                count    = uniform.arraySize;
-                                stride   = uniform.arrayStride;
-                                break;
-                            }
-                        if (location == -1) {
-                            pParent->warning("UniformSetter did not find a uniform with the name \"" + uniformName + "\"! Note that GLSL might discard uniforms if they do not affect the output.\n");
-                        } else if (cppType != type) {
-                            pParent->error("UniformSetter type mismatches GLSL type. UniformSetter is " + glTypeToCppName(cppType) + " but GLSL type is " + glTypeToGlslName(type) + ". Change UniformSetter to " + glTypeToCppName(type) + " or GLSL type to " + glTypeToGlslName(cppType));
+                    //Construction does not wait for a pipeline created with PipelineCompileMode::async, the uniform lookup and the init value are deferred until the pipeline is ready
+                    UniformSetter(PipelineInterface* const pParent, HashedName uniformName):
+                        pParent(pParent),
+                        shaderId(pParent->id)
+                    {
+                        static_assert(getCppType() != 0, "Not a valid template type for UniformSetter");
+                        if (pParent->loadPending) {
+                            std::string name(uniformName.name);
+                            pParent->loadPendingTaskList.push_back([this, name]{lookup(name);});
+                        } else {
+                            lookup(uniformName);
                         }
                     }
-                    UniformSetter(PipelineInterface* const pParent, const std::string& uniformName, const T& initValue):
+                    UniformSetter(PipelineInterface* const pParent, HashedName uniformName, const T& initValue):
                         UniformSetter(pParent, uniformName)
                     {
-                        setUniform(shaderId, location, initValue);
+                        if (pParent->loadPending) {
+                            pParent->loadPendingTaskList.push_back([this, initValue]{setUniform(shaderId, location, initValue);});
+                        } else {
+                            setUniform(shaderId, location, initValue);
+                        }
                     }
-                    UniformSetter(PipelineInterface* const pParent, const std::string& uniformName, std::initializer_list<T> valueList):
+                    UniformSetter(PipelineInterface* const pParent, HashedName uniformName, std::initializer_list<T> valueList):
                         UniformSetter(pParent, uniformName)
                     {
-                        setUniform(shaderId, location, *valueList.begin(), std::min<int>(valueList.size(), count));
+                        if (pParent->loadPending) {
+                            std::vector<T> valueVector(valueList);
+                            pParent->loadPendingTaskList.push_back([this, valueVector]{setUniform(shaderId, location, valueVector[0], std::min<int>(valueVector.size(), count));});
+                        } else {
+                            setUniform(shaderId, location, *valueList.begin(), std::min<int>(valueList.size(), count));
+                        }
                     }
                     const T& operator=(const T& value) {
-                        setUniform(shaderId, location, value);
+                        if (pParent->loadPending) pParent->waitReady();
+                        if (!pParent->uniformShadowing || !pParent->uniformShadowWrite(location, stride, &value, sizeof(T), 1))
+                            setUniform(shaderId, location, value);
                         return value;
                     }
                     std::initializer_list<T> operator=(std::initializer_list<T> valueList) {
-                        setUniform(shaderId, location, *valueList.begin(), std::min<int>(valueList.size(), count));
+                        if (pParent->loadPending) pParent->waitReady();
+                        if (!pParent->uniformShadowing || !pParent->uniformShadowWrite(location, stride, valueList.begin(), sizeof(T), std::min<int>(valueList.size(), count)))
+                            setUniform(shaderId, location, *valueList.begin(), std::min<int>(valueList.size(), count));
                         return valueList;
                     }
                     UniformSetter<T> operator[](uint32_t i) {
+                        if (pParent->loadPending) pParent->waitReady();
                         if (i < count)
-                            return UniformSetter<T>(shaderId, location + (stride * i), count - i, stride);
-                        return UniformSetter<T>(shaderId, -1, 0, 0);
+                            return UniformSetter<T>(pParent, shaderId, location + (stride * i), count - i, stride);
+                        return UniformSetter<T>(pParent, shaderId, -1, 0, 0);
                     }
                 private:
+                    static constexpr int32_t getCppType() {
+                        return cppTypeToGlType<T>();
+                    }
+
+                    PipelineInterface* pParent;
                     uint32_t shaderId;
                      int32_t location = -1;
                     uint16_t count    =  0; //uniforms and therefore locations should be limited to 64KiB?!
                     uint16_t stride   =  0;
-                    constexpr UniformSetter(uint32_t shaderId, int32_t location, uint16_t count, uint16_t stride): shaderId(shaderId), location(location), count(count), stride(stride){}
+                    constexpr UniformSetter(PipelineInterface* pParent, uint32_t shaderId, int32_t location, uint16_t count, uint16_t stride): pParent(pParent), shaderId(shaderId), location(location), count(count), stride(stride){}
+
+                    void lookup(HashedName uniformName) {
+                        int32_t type = 0;
+                        if (const Uniform* uniform = pParent->findUniform(uniformName)) {
+                            location = uniform->location;
+                            type     = uniform->type;
+                            count    = uniform->arraySize;
+                            stride   = uniform->arrayStride;
+                        }
+                        if (location == -1) {
+                            pParent->warning("UniformSetter did not find a uniform with the name \"" + std::string(uniformName.name) + "\"! Note that GLSL might discard uniforms if they do not affect the output.\n");
+                        } else if (getCppType() != type) {
+                            pParent->error("UniformSetter type mismatches GLSL type. UniformSetter is " + glTypeToCppName(getCppType()) + " but GLSL type is " + glTypeToGlslName(type) + ". Change UniformSetter to " + glTypeToCppName(type) + " or GLSL type to " + glTypeToGlslName(getCppType()));
+                        }
+                    }
             };
 
             //TODO: need setter for uniform structures
@@ -193,16 +195,16 @@ namespace glCompact {
             ~PipelineInterface();
         protected:
             template<typename T>
-            inline void setUniformByName(uint32_t shaderId, const std::string& uniformName, const T& value) {
+            inline void setUniformByName(uint32_t shaderId, HashedName uniformName, const T& value) {
                 setUniform(shaderId, getUniformLocation(uniformName), value);
             }
 
             template<typename T>
-            inline void setUniformByName(uint32_t shaderId, const std::string& uniformName, const T& value, int count) {
+            inline void setUniformByName(uint32_t shaderId, HashedName uniformName, const T& value, int count) {
                 setUniform(shaderId, getUniformLocation(uniformName), value, count);
             }
 
-            int32_t getUniformLocation(const std::string &uniformName);
+            int32_t getUniformLocation(HashedName uniformName);
 
             static void setUniform(uint32_t shaderId, int32_t uniformLocation, const float&        value);
             static void setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec2&    value);
@@ -266,8 +268,17 @@ namespace glCompact {
             uint32_t id = 0;
             std::string infoLog_;
 
-            std::string getShaderInfoLog(uint32_t objId);
-            std::string getProgramInfoLog(uint32_t objId);
+            //PipelineCompileMode::async, compiling and linking got issued but loadFinish_() did not run yet
+            bool     loadPending         = false;
+            bool     loadFailed          = false;
+            uint32_t loadShaderId[5]     = {};
+            uint64_t loadProgramCacheKey = 0;
+            std::vector<std::function<void()>> loadPendingTaskList; //deferred UniformSetter lookups and init values
+            virtual void loadFinish_() = 0;
+            PipelineCompilerJob_& loadCompilerJob_(PipelineCompiler::Job& job, bool compute);
+
+            static std::string getShaderInfoLog(uint32_t objId);
+            static std::string getProgramInfoLog(uint32_t objId);
         protected:
             virtual std::string getPipelineIdentificationString() = 0;
             std::string getPipelineInformationQueryString();
@@ -278,7 +289,7 @@ namespace glCompact {
             //TODO: -1 location = ?   if error, should we filter it out? Let get-variables be untouched or zero them?
             //All the array get functions came into OpenGL in a very late version!
             template<typename T>
-            inline void getUniformByName(const std::string& uniformName, T& value, int count = 1) {
+            inline void getUniformByName(HashedName uniformName, T& value, int count = 1) {
                 getUniform(getUniformLocation(uniformName), value, count);
             }
 
@@ -375,6 +386,22 @@ namespace glCompact {
             uint32_t*  image_mipmapLevel;
              int32_t*  image_layer;
 
+            //UNIFORM SHADOW (setUniformShadowing)
+            struct UniformShadowLocation {
+                uint32_t offset  =  0; //into uniformShadowData
+                uint32_t size    =  0; //byte, 0 if this location is not shadowed
+                 int32_t type    =  0;
+                 int32_t uniform = -1; //index into uniformList
+                bool     known   = false; //false until the first write, the program may still hold a GLSL initializer value
+                bool     dirty   = false;
+            };
+            bool       uniformShadowing = false;
+            std::vector<UniformShadowLocation> uniformShadowLocation; //indexed by uniform location
+            std::vector<uint8_t>               uniformShadowData;
+            void       uniformShadow_markLocationChange(int32_t location);
+             int32_t   uniformShadow_changedLocationMin = (std::numeric_limits<decltype(uniformShadow_changedLocationMin)>::max)();
+             int32_t   uniformShadow_changedLocationMax = -1;
+            bool       uniformShadowWrite(int32_t location, int32_t stride, const void* value, uint32_t size, int count);
 
             struct Attribute {
                 std::string name;
@@ -393,7 +420,8 @@ namespace glCompact {
             //sampler and image uniforms
             struct BindingUniform {
                 std::string name;
-                int32_t type = 0;
+                int32_t type     =  0;
+                int32_t location = -1;
             };
 
             //UBO
@@ -440,9 +468,40 @@ namespace glCompact {
             std::vector<UniformBlock>         uniformBlockList;
             std::vector<StorageBlock>         storageBlockList;
 
+            //NAME INDEX of uniformList, uniformBlockList and storageBlockList, sorted by name hash
+            struct NameIndexEntry {
+                uint32_t hash;
+                uint32_t index;
+            };
+            std::vector<NameIndexEntry> uniformNameIndex;
+            std::vector<NameIndexEntry> uniformBlockNameIndex;
+            std::vector<NameIndexEntry> storageBlockNameIndex;
+            void buildNameIndex();
+            template<typename T>
+            static void buildNameIndex(std::vector<NameIndexEntry>& nameIndex, const std::vector<T>& list) {
+                nameIndex.resize(list.size());
+                for (uint32_t i = 0; i < list.size(); ++i) nameIndex[i] = {hashName(list[i].name), i};
+                std::sort(nameIndex.begin(), nameIndex.end(), [](const NameIndexEntry& a, const NameIndexEntry& b) {return a.hash < b.hash;});
+            }
+            //Only names with the same hash get compared
+            template<typename T>
+            static const T* findByName(const std::vector<NameIndexEntry>& nameIndex, const std::vector<T>& list, HashedName name) {
+                auto it = std::lower_bound(nameIndex.begin(), nameIndex.end(), name.hash, [](const NameIndexEntry& entry, uint32_t hash) {return entry.hash < hash;});
+                for (; it != nameIndex.end() && it->hash == name.hash; ++it)
+                    if (list[it->index].name == name.name) return &list[it->index];
+                return nullptr;
+            }
+            const Uniform*      findUniform     (HashedName name) const;
+            const UniformBlock* findUniformBlock(HashedName name) const;
+            const StorageBlock* findStorageBlock(HashedName name) const;
+
             void collectInformation();
+            void updateBindingCount();
+            void writeInformation(ProgramCacheWriter_& writer) const;
+            void readInformation(ProgramCacheReader_& reader);
             void allocateMemory();
 
+            bool hasPendingChanges() const;
             void processPendingChanges();
             void processPendingChangesPipeline();
             void processPendingChangesBuffersUniform();
@@ -450,8 +509,11 @@ namespace glCompact {
             void processPendingChangesTextures();
             void processPendingChangesSamplers();
             void processPendingChangesImages();
+            void processPendingChangesUniformShadow();
 
             static std::string glTypeToGlslName(int32_t type);
             static std::string glTypeToCppName(int32_t type);
+            static uint32_t    glTypeToUniformSize(int32_t type);
+            static void        uploadUniform(int32_t type, int32_t uniformLocation, int count, const void* value);
     };
 }
@@ -10,6 +10,7 @@
 #include "glCompact/Primitive.hpp"
 #include "glCompact/IndexType.hpp"
 #include "glCompact/Tribool.hpp"
+#include "glCompact/TransformFeedback.hpp"
 
 #include <glm/vec4.hpp>
 
@@ -22,23 +23,52 @@
 namespace glCompact {
     class PipelineRasterization;
     class PipelineRasterization : public PipelineInterface {
+            friend class PipelineCompiler;
+            friend class TransformFeedback;
         public:
             PipelineRasterization(
-                Primitive          primitive,
-                const std::string& vertexString,
-                const std::string& tessControlString,
-                const std::string& tessEvalutionString,
-                const std::string& geometryString,
-                const std::string& fragmentString
+                Primitive           primitive,
+                const std::string&  vertexString,
+                const std::string&  tessControlString,
+                const std::string&  tessEvalutionString,
+                const std::string&  geometryString,
+                const std::string&  fragmentString,
+                PipelineCompileMode compileMode = PipelineCompileMode::blocking
             );
             PipelineRasterization(
-                const std::string& path,
-                Primitive          primitive,
-                const std::string& vertexFile,
-                const std::string& tessControlFile,
-                const std::string& tessEvalutionFile,
-                const std::string& geometryFile,
-                const std::string& fragmentFile
+                Primitive                      primitive,
+                const std::string&             vertexString,
+                const std::string&             tessControlString,
+                const std::string&             tessEvalutionString,
+                const std::string&             geometryString,
+                const std::string&             fragmentString,
+                const TransformFeedbackLayout& transformFeedbackLayout,
+                PipelineCompileMode            compileMode = PipelineCompileMode::blocking
+            );
+            PipelineRasterization(
+                const std::string&  path,
+                Primitive           primitive,
+                const std::string&  vertexFile,
+                const std::string&  tessControlFile,
+                const std::string&  tessEvalutionFile,
+                const std::string&  geometryFile,
+                const std::string&  fragmentFile,
+                PipelineCompileMode compileMode = PipelineCompileMode::blocking
+            );
+            PipelineRasterization(
+                const std::string&             path,
+                Primitive                      primitive,
+                const std::string&             vertexFile,
+                const std::string&             tessControlFile,
+                const std::string&             tessEvalutionFile,
+                const std::string&             geometryFile,
+                const std::string&             fragmentFile,
+                const TransformFeedbackLayout& transformFeedbackLayout,
+                PipelineCompileMode            compileMode = PipelineCompileMode::blocking
+            );
+            PipelineRasterization(
+                Primitive             primitive,
+                PipelineCompiler::Job job
             );
 
             PipelineRasterization           (PipelineRasterization&  pipelineRasterization) = delete;
@@ -90,6 +120,9 @@ namespace glCompact {
           //MULTI SAMPLE
             void setMultisample(bool enable);
 
+          //RASTERIZER DISCARD (e.g. for only capturing vertices via TransformFeedback)
+            void setRasterizerDiscard(bool enable);
+
             //its depricated but still usable, not insert this functionalites?
             //setLineWidth       (float width ); //default 1.0f
             //setLineAntialiasing(bool  enable); //default off
@@ -100,6 +133,7 @@ namespace glCompact {
             void drawIndexedIndirect     (const BufferInterface& parameterbuffer, intptr_t parameterBufferOffset, uint32_t count, uint32_t stride = 20);
             void drawIndirectCount       (const BufferInterface& parameterbuffer, intptr_t parameterBufferOffset, const BufferInterface& countBuffer, intptr_t countBufferOffset, intptr_t maxDrawCount, uint32_t stride = 16);
             void drawIndexedIndirectCount(const BufferInterface& parameterbuffer, intptr_t parameterBufferOffset, const BufferInterface& countBuffer, intptr_t countBufferOffset, intptr_t maxDrawCount, uint32_t stride = 20);
+            void drawTransformFeedback   (const TransformFeedback& transformFeedback, uint32_t instanceCount = 1, uint32_t stream = 0);
 
         //information
             bool hasVertexStage       ()const{return hasShader[0];}
@@ -107,17 +141,24 @@ namespace glCompact {
             bool hasTessEvalutionStage()const{return hasShader[2];}
             bool hasGeometryStage     ()const{return hasShader[3];}
             bool hasFragmentStage     ()const{return hasShader[4];}
+            bool hasTransformFeedbackOutput()const{return transformFeedbackVaryingCount > 0;}
         private:
             virtual std::string getPipelineIdentificationString();
             std::string getPipelineInformationQueryString();
         //LOADING
             bool loadStrings_(
-                const std::string& stringVertex,
-                const std::string& stringTessControl,
-                const std::string& stringTessEvalution,
-                const std::string& stringGeometry,
-                const std::string& stringFragment
+                const std::string&  stringVertex,
+                const std::string&  stringTessControl,
+                const std::string&  stringTessEvalution,
+                const std::string&  stringGeometry,
+                const std::string&  stringFragment,
+                const TransformFeedbackLayout& transformFeedbackLayout,
+                PipelineCompileMode compileMode
             );
+            bool loadResult_();
+            void loadInformation_(const std::vector<char>* programCacheInformation);
+            virtual void loadFinish_();
+            std::string getLoadErrorString();
             void setDefaultValues();
         //SHADER INFORMATION
             //Vertex info
@@ -130,6 +171,8 @@ namespace glCompact {
             void setAttributeLayoutThrow(const std::string& errorMessage);
 
             void collectInformation();
+            void writeInformation(ProgramCacheWriter_& writer) const;
+            void readInformation(ProgramCacheReader_& reader);
 
             bool hasShader[5] = {false};
             const bool loadedFromFiles = false;
@@ -139,6 +182,11 @@ namespace glCompact {
             Primitive geometryOutputPrimitive   = static_cast<Primitive>(-1);
             Primitive geometryInputPrimitive    = static_cast<Primitive>(-1);
 
+            Primitive tessellationOutputPrimitive = static_cast<Primitive>(-1);
+
+            int32_t   transformFeedbackVaryingCount = 0;
+            Primitive getTransformFeedbackPrimitive() const;
+
           //STATES
             PipelineRasterizationStateChange stateChange;
 
@@ -202,6 +250,8 @@ namespace glCompact {
             //Multi sample
             bool multiSample = true; //default enabled, if disabled fill all samples of a texel with the same value!
 
+            bool rasterizerDiscard = false;
+
             //ATTRIBUTE LAYOUT, BUFFERS and INDEX BUFFER
             AttributeLayout_ attributeLayout_;
 
@@ -214,7 +264,10 @@ namespace glCompact {
             IndexType indexType                     = static_cast<IndexType>(0);
             uint32_t  buffer_attribute_index_id     = 0;
             uintptr_t buffer_attribute_index_offset = 0; //this is a glCompact only thing. So it is not part of the state tracker
+             int32_t  vertexArrayCacheIndexHint     = -1; //see Context_::cachedBindVertexArray
 
+            bool hasPendingChanges() const;
+            bool drawBatchPrepare(bool indexed);
             void processPendingChanges();
             void processPendingChangesPipeline();
             void processPendingChangesPipelineRasterization();
@@ -16,7 +16,8 @@ namespace glCompact {
                     stencil:1,
                     depth:1,
                     blend:1,
-                    attributeLayout:1;
+                    attributeLayout:1,
+                    rasterizerDiscard:1;
             };
         };
     };
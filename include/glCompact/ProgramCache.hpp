@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint> //C++11
+#include <string>
+
+namespace glCompact {
+    struct ProgramCacheCounter {
+        uint64_t hit      = 0; //program binary loaded from the cache
+        uint64_t miss     = 0; //no usable binary in the cache, shader got compiled from source
+        uint64_t rejected = 0; //part of miss, a binary was found but the driver refused to load it
+    };
+
+    //Disabled as long as no directory is set. The directory must already exist.
+    void                setProgramCacheDirectory(const std::string& directory);
+    std::string         getProgramCacheDirectory();
+    ProgramCacheCounter getProgramCacheCounter();
+    void                resetProgramCacheCounter();
+}
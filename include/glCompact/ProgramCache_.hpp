@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint> //C++11
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <stdexcept>
+#include <algorithm>
+
+namespace glCompact {
+    /*
+        Used by PipelineRasterization/PipelineCompute while loading. All functions are no-ops returning 0 if the cache is disabled.
+        Next to the program binary the cache stores the serialized reflection data (writeInformation), so a cache hit needs no introspection queries.
+
+            uint64_t key = ProgramCache_::createKey(shaderSrc, 5);
+            std::vector<char> information;
+            id = ProgramCache_::load(key, information);
+            if (id) {
+                ProgramCacheReader_ reader(information);
+                readInformation(reader);
+            } else {
+                //compile, ProgramCache_::setRetrievableHint(id) before linking
+                collectInformation();
+                ProgramCacheWriter_ writer;
+                writeInformation(writer);
+                ProgramCache_::store(key, id, writer.data);
+            }
+    */
+    class ProgramCache_ {
+        public:
+            static bool     isEnabled();
+            static uint64_t createKey(const std::string* const shaderSrc[], uint32_t count);
+            static uint32_t load(uint64_t key, std::vector<char>& information);
+            static void     setRetrievableHint(uint32_t programId);
+            static void     store(uint64_t key, uint32_t programId, const std::vector<char>& information);
+    };
+
+    class ProgramCacheWriter_ {
+        public:
+            std::vector<char> data;
+
+            template<typename T>
+            void write(T value) {
+                static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only arithmetic and enum types can be written directly");
+                const char* p = reinterpret_cast<const char*>(&value);
+                data.insert(data.end(), p, p + sizeof(T));
+            }
+
+            void write(const std::string& s) {
+                write(uint32_t(s.size()));
+                data.insert(data.end(), s.begin(), s.end());
+            }
+    };
+
+    //The content is covered by a hash in the cache file, so running out of data means a bug in readInformation/writeInformation and not a corrupt file.
+    class ProgramCacheReader_ {
+        public:
+            ProgramCacheReader_(const std::vector<char>& data):
+                pos(data.data()),
+                end(data.data() + data.size())
+            {}
+
+            template<typename T>
+            void read(T& value) {
+                static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only arithmetic and enum types can be read directly");
+                check(sizeof(T));
+                std::copy(pos, pos + sizeof(T), reinterpret_cast<char*>(&value));
+                pos += sizeof(T);
+            }
+
+            void read(std::string& s) {
+                uint32_t size = 0;
+                read(size);
+                check(size);
+                s.assign(pos, size);
+                pos += size;
+            }
+
+            template<typename T>
+            T read() {
+                T value;
+                read(value);
+                return value;
+            }
+        private:
+            const char* pos;
+            const char* end;
+
+            void check(size_t size) {
+                if (size_t(end - pos) < size) throw std::runtime_error("Program cache reflection data is shorter than expected!");
+            }
+    };
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "glCompact/config.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace glCompact {
+    /*
+        State categories of the state tracker. Every cached state check is counted as elided (the state already was set) or forwarded (resulted in OpenGL calls).
+    */
+    enum class StatisticsCategory : uint8_t {
+        shader,
+        uniform,
+        attributeLayout,
+        vertexArray,
+        attributeBuffer,
+        indexBuffer,
+        bufferTarget,
+        uniformBuffer,
+        shaderStorageBuffer,
+        texture,
+        sampler,
+        image,
+        frame,
+        viewportScissor,
+        face,
+        depth,
+        stencil,
+        rgbaWriteMask,
+        blend,
+        multiSample,
+        rasterizerDiscard,
+        count
+    };
+
+    struct Statistics {
+        struct StateCheck {
+            uint64_t elided    = 0;
+            uint64_t forwarded = 0;
+        };
+
+        uint64_t glCallCount = 0;
+        std::vector<std::pair<std::string, uint64_t>> glCallCountList; //only functions that got called, highest count first
+        StateCheck stateCheck[uint32_t(StatisticsCategory::count)];
+
+        const StateCheck& operator[](StatisticsCategory category) const {return stateCheck[uint32_t(category)];}
+        static const char* getCategoryName(StatisticsCategory category);
+    };
+
+    //Only collects data if GLCOMPACT_STATISTICS is defined in config.hpp. Otherwise getStatistics() returns an empty Statistics object.
+    Statistics getStatistics();
+    void       resetStatistics();
+}
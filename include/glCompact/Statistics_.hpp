@@ -0,0 +1,31 @@
+#pragma once
+#include "glCompact/config.hpp"
+#include "glCompact/Statistics.hpp"
+#include "glCompact/threadContext_.hpp"
+
+namespace glCompact {
+    /*
+        Wraps the result of a cached state check (e.g. isDiffThenAssign) and counts it as forwarded or elided.
+        Without GLCOMPACT_STATISTICS this only returns the given value.
+
+            if (countStateCheck(StatisticsCategory::depth, isDiffThenAssign(current, pending))) {
+                ...
+            }
+    */
+    inline bool countStateCheck(
+        StatisticsCategory category,
+        bool               forwarded
+    ) {
+        #ifdef GLCOMPACT_STATISTICS
+            Statistics::StateCheck& stateCheck = threadContext_->statistics_stateCheck[uint32_t(category)];
+            if (forwarded) {
+                stateCheck.forwarded++;
+            } else {
+                stateCheck.elided++;
+            }
+        #else
+            (void)category;
+        #endif
+        return forwarded;
+    }
+}
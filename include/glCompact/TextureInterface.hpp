@@ -1,5 +1,6 @@
 #pragma once
 #include "glCompact/SurfaceInterface.hpp"
+#include "glCompact/MipmapFilter.hpp"
 
 #include <glm/fwd.hpp>
 #include <glm/vec3.hpp>
@@ -18,6 +19,9 @@ namespace glCompact {
             void setMipmapBaseLevel(uint32_t level);
             uint32_t getMipmapBaseLevel() const {return mipmapBaseLevel;}
             void generateMipmaps();
+            void generateMipmaps(MipmapFilter mipmapFilter);
+            void generateMipmapsViaPipelineCompute(MipmapFilter mipmapFilter = MipmapFilter::box);
+            bool isGenerateMipmapsViaPipelineComputeSupported() const;
 
             void clear(uint32_t mipmapLevel);
             void clear(uint32_t mipmapLevel, MemorySurfaceFormat memorySurfaceFormat, const BufferInterface* buffer, const void* ptr);
@@ -0,0 +1,88 @@
+#pragma once
+#include "glCompact/BufferStaging.hpp"
+#include "glCompact/Fence.hpp"
+#include "glCompact/MemorySurfaceFormat.hpp"
+
+#include <cstdint> //C++11
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <glm/vec3.hpp>
+
+namespace glCompact {
+    struct TextureUploaderStatistics {
+        uint32_t  queuedCount         = 0; //uploads waiting for ring space or budget
+        uintptr_t queuedBytes         = 0;
+        uint32_t  batchesInFlight     = 0; //batches whose fence did not signal yet
+        uintptr_t ringUsed            = 0; //byte, including alignment padding
+        uint64_t  uploadedCount       = 0; //since construction or resetStatistics()
+        uint64_t  uploadedBytes       = 0;
+        uint64_t  budgetLimitedFrames = 0; //update() calls that left uploads in the queue because of the frame byte budget
+        uint64_t  ringLimitedFrames   = 0; //update() calls that left uploads in the queue because the ring was full
+        double    bytesPerSecond      = 0.0; //uploadedBytes divided by the wall time since construction or resetStatistics()
+    };
+
+    class TextureInterface;
+    class TextureUploader {
+        public:
+            TextureUploader(uintptr_t ringSize, uintptr_t frameByteBudget = 0);
+            TextureUploader           (const TextureUploader&) = delete;
+            TextureUploader& operator=(const TextureUploader&) = delete;
+            ~TextureUploader() = default;
+
+            void upload(TextureInterface& texture, const void* mem, uintptr_t size, MemorySurfaceFormat memorySurfaceFormat, uint32_t mipmapLevel, glm::ivec3 texOffset, glm::ivec3 texSize);
+            void upload(TextureInterface& texture, std::vector<uint8_t> data,       MemorySurfaceFormat memorySurfaceFormat, uint32_t mipmapLevel, glm::ivec3 texOffset, glm::ivec3 texSize);
+            void cancel(const TextureInterface& texture);
+
+            void update();
+            void finish();
+
+            void      setFrameByteBudget(uintptr_t frameByteBudget) {this->frameByteBudget = frameByteBudget;}
+            uintptr_t getFrameByteBudget() const {return frameByteBudget;}
+            uintptr_t getRingSize       () const {return ring.getSize();}
+
+            TextureUploaderStatistics getStatistics() const;
+            void                      resetStatistics();
+        private:
+            struct Upload {
+                Upload(TextureInterface* texture, MemorySurfaceFormat memorySurfaceFormat, uint32_t mipmapLevel, glm::ivec3 texOffset, glm::ivec3 texSize, uintptr_t size) :
+                    texture(texture), memorySurfaceFormat(memorySurfaceFormat), mipmapLevel(mipmapLevel), texOffset(texOffset), texSize(texSize), size(size) {}
+                TextureInterface*    texture; //0 if canceled after it was already written into the ring
+                MemorySurfaceFormat  memorySurfaceFormat;
+                uint32_t             mipmapLevel;
+                glm::ivec3           texOffset;
+                glm::ivec3           texSize;
+                uintptr_t            size;
+                std::vector<uint8_t> data;             //only used while the upload is not in the ring yet
+                bool                 inRing    = false;
+                uintptr_t            offset    = 0;    //ring offset
+                uintptr_t            ringBytes = 0;    //ring bytes taken, including padding
+            };
+            struct Batch {
+                Fence     fence;
+                uintptr_t end  = 0; //ring head after this batch
+                uintptr_t used = 0; //ring bytes of this batch, including padding
+            };
+
+            BufferStaging      ring;
+            uintptr_t          frameByteBudget;
+            uintptr_t          head     = 0;
+            uintptr_t          tail     = 0;
+            uintptr_t          ringUsed = 0;
+            std::deque<Upload> queue;
+            uintptr_t          queuedBytes = 0;
+            std::deque<Batch>  batch; //deque, because Fence must not be moved
+
+            uint64_t uploadedCount       = 0;
+            uint64_t uploadedBytes       = 0;
+            uint64_t budgetLimitedFrames = 0;
+            uint64_t ringLimitedFrames   = 0;
+            std::chrono::steady_clock::time_point statisticsStart;
+
+            void enqueue     (TextureInterface& texture, const void* mem, std::vector<uint8_t>* data, uintptr_t size, MemorySurfaceFormat memorySurfaceFormat, uint32_t mipmapLevel, glm::ivec3 texOffset, glm::ivec3 texSize);
+            bool writeToRing (Upload& u, const void* mem);
+            bool reclaim     (bool wait);
+            void issue       (bool limitByBudget);
+            bool ringAllocate(uintptr_t size, uintptr_t& offset);
+    };
+}
@@ -53,19 +53,77 @@
     Date source by highest preference: geometry shader, tessellation shader, vertex shader, draw command type (the last two !?)
  */
 
-#include "glCompact/ContextInternal.hpp"
+#include "glCompact/config.hpp"
+#include "glCompact/Primitive.hpp"
+
+#include <cstdint> //C++11
+#include <string>
+#include <vector>
 
 namespace glCompact {
-    class TransformFeedback {
-        //friend class ContextInterface;
-    };
+    class BufferInterface;
+    class PipelineRasterization;
 
     class TransformFeedbackLayout {
-        //friend class ContextInterface;
-        void addBufferIndex();
-        void addOutputType(int index, GLenum type);
-        void finalize();
+            friend class PipelineRasterization;
+        public:
+            void addOutput    (const std::string& name);
+            void addSkip      (uint32_t componentCount);
+            void addNextBuffer();
+            void clear();
+
+            bool     isEmpty       () const {return varying.empty();}
+            uint32_t getBufferCount() const {return varying.empty() ? 0 : bufferCount;}
+        private:
+            std::vector<std::string> varying;
+            uint32_t bufferCount            = 1;
+            bool     needsTransformFeedback3 = false; //gl_NextBuffer and gl_SkipComponents*
+    };
 
-        void clear();
+    class TransformFeedback {
+            friend class PipelineRasterization;
+        public:
+            TransformFeedback() = default;
+            TransformFeedback           (const TransformFeedback&) = delete;
+            TransformFeedback& operator=(const TransformFeedback&) = delete;
+            ~TransformFeedback();
+            void free();
+
+            void setBuffer(uint32_t slot, BufferInterface& buffer, uintptr_t offset = 0);
+            void setBuffer(uint32_t slot, BufferInterface& buffer, uintptr_t offset, uintptr_t size);
+            void setBuffer(uint32_t slot);
+            void setBuffer();
+
+            void begin(PipelineRasterization& pipeline);
+            void pause();
+            void resume();
+            void end();
+
+            bool isActive  () const {return pipeline != 0;}
+            bool isPaused  () const {return paused;}
+            bool hasCapture() const {return captured;}
+
+            static uint32_t getMaxBufferCount();
+
+            class Scope {
+                public:
+                    Scope(TransformFeedback& transformFeedback, PipelineRasterization& pipeline):transformFeedback(transformFeedback){transformFeedback.begin(pipeline);}
+                    Scope           (const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+                    ~Scope(){transformFeedback.end();}
+                private:
+                    TransformFeedback& transformFeedback;
+            };
+        private:
+            uint32_t  id = 0;
+            uint32_t  buffer_id    [config::MAX_TRANSFORM_FEEDBACK_BUFFERS] = {};
+            uintptr_t buffer_offset[config::MAX_TRANSFORM_FEEDBACK_BUFFERS] = {};
+            uintptr_t buffer_size  [config::MAX_TRANSFORM_FEEDBACK_BUFFERS] = {};
+            bool      bufferChanged = false; //buffer bindings are state of the GL transform feedback object, they are only set in begin()
+
+            PipelineRasterization* pipeline  = 0; //capturing pipeline between begin() and end()
+            Primitive              primitive = static_cast<Primitive>(-1);
+            bool                   paused    = false;
+            bool                   captured  = false; //end() got called at last once, so drawTransformFeedback() can use it
     };
 }
@@ -0,0 +1,85 @@
+#pragma once
+#include "glCompact/BufferRing.hpp"
+#include "glCompact/PipelineInterface.hpp"
+#include "glCompact/cppTypeToGlType.hpp"
+#include "glCompact/HashedName.hpp"
+
+#include <cstdint> //C++11
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+namespace glCompact {
+    class UniformBlockLayout {
+        private:
+            struct MemberInfo {
+                uint32_t offset       = 0;
+                uint32_t arraySize    = 0; //elements left from offset on, 0 for a member that is not part of the block (operator[] outside of the array)
+                uint32_t arrayStride  = 0;
+                uint32_t matrixStride = 0;
+                uint32_t size         = 0; //sizeof of the C++ type
+                uint8_t  columns      = 0; //0 for all non matrix types
+                uint8_t  rows         = 0;
+                uint8_t  scalarSize   = 0;
+                bool     rowMajor     = false;
+            };
+        public:
+            UniformBlockLayout(PipelineInterface& pipeline, HashedName blockName);
+            UniformBlockLayout           (const UniformBlockLayout&) = delete;
+            UniformBlockLayout& operator=(const UniformBlockLayout&) = delete;
+
+            /** Member
+                \brief class template to write a member of the uniform block into block memory
+                \tparam T type must fit to the type used in the shader
+
+                \details The offset, array stride, matrix stride and matrix order are taken from the reflection of the pipeline once,
+                write() only copies the value into place.
+            */
+            template<typename T>
+            class Member {
+                public:
+                    Member(UniformBlockLayout* const pParent, HashedName memberName) {
+                        static_assert(cppTypeToGlType<T>() != 0, "Not a valid template type for UniformBlockLayout::Member");
+                        static_assert(sizeof(T) % 4 == 0, "GLSL bool types take 4 byte per component in uniform blocks, use uint types in GLSL and C++ instead");
+                        pParent->lookup(memberName, cppTypeToGlType<T>(), sizeof(T), info);
+                    }
+                    void write(void* block, const T& value) const {
+                        writeMember(info, block, &value, 1);
+                    }
+                    void write(void* block, std::initializer_list<T> valueList) const {
+                        writeMember(info, block, valueList.begin(), uint32_t(valueList.size()));
+                    }
+                    Member<T> operator[](uint32_t i) const {
+                        MemberInfo element = info;
+                        if (i < info.arraySize) {
+                            element.offset    += i * info.arrayStride;
+                            element.arraySize -= i;
+                        } else {
+                            element.arraySize  = 0;
+                        }
+                        return Member<T>(element);
+                    }
+                private:
+                    MemberInfo info;
+                    Member(const MemberInfo& info): info(info) {}
+            };
+
+            const std::string& getName   () const {return name;}
+             int32_t           getBinding() const {return binding;}
+            uint32_t           getSize   () const {return size;}
+
+            BufferRing::Allocation allocate(BufferRing& bufferRing) const;
+            void* getBlockPtr(const BufferRing::Allocation& allocation) const;
+            void* getBlockPtr(BufferStaging& bufferStaging, uintptr_t offset) const;
+            void  setUniformBuffer(PipelineInterface& pipeline, const BufferRing& bufferRing, const BufferRing::Allocation& allocation) const;
+        private:
+            std::string name;
+             int32_t    binding = 0;
+            uint32_t    size    = 0;
+            std::vector<PipelineInterface::UniformBlockUniform> reflection; //copy, so the layout does not depend on the lifetime of the pipeline
+            std::vector<PipelineInterface::NameIndexEntry>      reflectionNameIndex;
+
+            void lookup(HashedName memberName, int32_t type, uint32_t cppSize, MemberInfo& info);
+            static void writeMember(const MemberInfo& info, void* block, const void* value, uint32_t count);
+    };
+}
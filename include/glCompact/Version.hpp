@@ -8,6 +8,7 @@ namespace glCompact {
     struct Version {
         std::string versionString;
         std::string shadingLanguageVersionString;
+        std::string rendererString;
 
         GlVersion   gl;
         GlesVersion gles;
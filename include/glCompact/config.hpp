@@ -66,6 +66,7 @@ namespace glCompact {
         //vec3/vec4/mat3x?/mat4x? double types can (but not must) use up two times the amount of locations!
         constexpr int MAX_ATTRIBUTES                     = 32;
         constexpr int MAX_RGBA_ATTACHMENTS               = 8; //basically MAX_COLOR_ATTACHMENTS, but prefer to use the RGBA naming cheme
+        constexpr int MAX_TRANSFORM_FEEDBACK_BUFFERS     = 4; //GL_MAX_TRANSFORM_FEEDBACK_BUFFERS is min. 4 with GL_ARB_transform_feedback3
 
         namespace Workarounds {
             //r290 win10 blob (adrenalin-edition-18.6.1-june13) driver bug! (e.g. Mesa works fine!)
@@ -81,5 +82,9 @@ namespace glCompact {
         //The OpenGL Standard defines that function without an active context on the calling thread have no effect.
         //This enables an assert check to catch this in glCompact functions.
         #define GLCOMPACT_DEBUG_ASSERT_THREAD_HAS_ACTIVE_CONTEXT
+
+        //Counts every OpenGL call issued by glCompact and how many cached state checks were elided versus forwarded to OpenGL, per state category.
+        //Read and reset via getStatistics()/resetStatistics() (Statistics.hpp). Adds overhead to every OpenGL call, leave this undefined for release builds.
+        //#define GLCOMPACT_STATISTICS
     }
 }
@@ -0,0 +1,56 @@
+#pragma once
+#include <glm/fwd.hpp>
+
+#include <cstdint> //C++11
+#include <type_traits>
+
+namespace glCompact {
+    /**
+        @brief: OpenGL type constant of the GLSL type that fits the C++ type T, 0 if there is none.
+
+        Used to check UniformSetter and uniform/storage block members against the shader reflection.
+    */
+    template<typename T>
+    constexpr int32_t cppTypeToGlType() {
+        return
+            std::is_same<T, float       >::value ? 0x1406 : //GL_FLOAT
+            std::is_same<T, glm::vec2   >::value ? 0x8B50 : //GL_FLOAT_VEC2
+            std::is_same<T, glm::vec3   >::value ? 0x8B51 : //GL_FLOAT_VEC3
+            std::is_same<T, glm::vec4   >::value ? 0x8B52 : //GL_FLOAT_VEC4
+            std::is_same<T, double      >::value ? 0x140A : //GL_DOUBLE
+            std::is_same<T, glm::dvec2  >::value ? 0x8FFC : //GL_DOUBLE_VEC2
+            std::is_same<T, glm::dvec3  >::value ? 0x8FFD : //GL_DOUBLE_VEC3
+            std::is_same<T, glm::dvec4  >::value ? 0x8FFE : //GL_DOUBLE_VEC4
+            std::is_same<T, int32_t     >::value ? 0x1404 : //GL_INT
+            std::is_same<T, glm::ivec2  >::value ? 0x8B53 : //GL_INT_VEC2
+            std::is_same<T, glm::ivec3  >::value ? 0x8B54 : //GL_INT_VEC3
+            std::is_same<T, glm::ivec4  >::value ? 0x8B55 : //GL_INT_VEC4
+            std::is_same<T, uint32_t    >::value ? 0x1405 : //GL_UNSIGNED_INT
+            std::is_same<T, glm::uvec2  >::value ? 0x8DC6 : //GL_UNSIGNED_INT_VEC2
+            std::is_same<T, glm::uvec3  >::value ? 0x8DC7 : //GL_UNSIGNED_INT_VEC3
+            std::is_same<T, glm::uvec4  >::value ? 0x8DC8 : //GL_UNSIGNED_INT_VEC4
+            std::is_same<T, bool        >::value ? 0x8B56 : //GL_BOOL
+            std::is_same<T, glm::bvec2  >::value ? 0x8B57 : //GL_BOOL_VEC2
+            std::is_same<T, glm::bvec3  >::value ? 0x8B58 : //GL_BOOL_VEC3
+            std::is_same<T, glm::bvec4  >::value ? 0x8B59 : //GL_BOOL_VEC4
+            std::is_same<T, glm::mat2x2 >::value ? 0x8B5A : //GL_FLOAT_MAT2
+            std::is_same<T, glm::mat2x3 >::value ? 0x8B65 : //GL_FLOAT_MAT2x3
+            std::is_same<T, glm::mat2x4 >::value ? 0x8B66 : //GL_FLOAT_MAT2x4
+            std::is_same<T, glm::mat3x2 >::value ? 0x8B67 : //GL_FLOAT_MAT3x2
+            std::is_same<T, glm::mat3x3 >::value ? 0x8B5B : //GL_FLOAT_MAT3
+            std::is_same<T, glm::mat3x4 >::value ? 0x8B68 : //GL_FLOAT_MAT3x4
+            std::is_same<T, glm::mat4x2 >::value ? 0x8B69 : //GL_FLOAT_MAT4x2
+            std::is_same<T, glm::mat4x3 >::value ? 0x8B6A : //GL_FLOAT_MAT4x3
+            std::is_same<T, glm::mat4x4 >::value ? 0x8B5C : //GL_FLOAT_MAT4
+            std::is_same<T, glm::dmat2x2>::value ? 0x8F46 : //GL_DOUBLE_MAT2
+            std::is_same<T, glm::dmat2x3>::value ? 0x8F49 : //GL_DOUBLE_MAT2x3
+            std::is_same<T, glm::dmat2x4>::value ? 0x8F4A : //GL_DOUBLE_MAT2x4
+            std::is_same<T, glm::dmat3x2>::value ? 0x8F4B : //GL_DOUBLE_MAT3x2
+            std::is_same<T, glm::dmat3x3>::value ? 0x8F47 : //GL_DOUBLE_MAT3
+            std::is_same<T, glm::dmat3x4>::value ? 0x8F4C : //GL_DOUBLE_MAT3x4
+            std::is_same<T, glm::dmat4x2>::value ? 0x8F4D : //GL_DOUBLE_MAT4x2
+            std::is_same<T, glm::dmat4x3>::value ? 0x8F4E : //GL_DOUBLE_MAT4x3
+            std::is_same<T, glm::dmat4x4>::value ? 0x8F48 : //GL_DOUBLE_MAT4
+            0;
+    }
+}
@@ -7,6 +7,9 @@
 #include "glCompact/BufferGpu.hpp"
 #include "glCompact/BufferGpuSparse.hpp"
 #include "glCompact/BufferStaging.hpp"
+#include "glCompact/BufferRing.hpp"
+#include "glCompact/BufferGpuAllocator.hpp"
+#include "glCompact/BufferReadback.hpp"
 
 #include "glCompact/RenderBuffer2d.hpp"
 #include "glCompact/RenderBuffer2dMultisample.hpp"
@@ -19,13 +22,26 @@
 #include "glCompact/Texture3d.hpp"
 #include "glCompact/TextureCubemap.hpp"
 #include "glCompact/TextureCubemapArray.hpp"
+#include "glCompact/TextureUploader.hpp"
+#include "glCompact/DepthPyramid.hpp"
 
 #include "glCompact/Sampler.hpp"
 #include "glCompact/AttributeLayout.hpp"
 #include "glCompact/PipelineRasterization.hpp"
+#include "glCompact/TransformFeedback.hpp"
 #include "glCompact/PipelineCompute.hpp"
+#include "glCompact/PipelineComputeCulling.hpp"
+#include "glCompact/PipelineCompiler.hpp"
+#include "glCompact/UniformBlockLayout.hpp"
+#include "glCompact/BlockLayout.hpp"
+#include "glCompact/CommandList.hpp"
+#include "glCompact/DrawQueue.hpp"
 #include "glCompact/Frame.hpp"
 #include "glCompact/Fence.hpp"
+#include "glCompact/GpuTimer.hpp"
+#include "glCompact/OcclusionQuery.hpp"
+#include "glCompact/Statistics.hpp"
+#include "glCompact/ProgramCache.hpp"
 #include "glCompact/MemoryBarrier.hpp"
 
 namespace glCompact {
@@ -35,6 +51,12 @@ namespace glCompact {
     void   setDisplayFrameSize(uint32_t x, uint32_t y);
     Frame& getDisplayFrame    ();
 
+    void   setDrawBatching    (bool enabled);
+    bool   getDrawBatching    ();
+
+    void     setVertexArrayCache(uint32_t maxVertexArrayCount);
+    uint32_t getVertexArrayCache();
+
     //TODO: Add unbind all buffers/surfaces to cleanly move them to other threads
 
     void flush();
@@ -155,8 +155,8 @@ namespace glCompact {
     }
 
     bool AttributeLayout::operator==(const AttributeLayout& rhs) const {
-        int8_t uppermostActiveBufferIndex = maximum(uppermostActiveBufferIndex, rhs.uppermostActiveBufferIndex);
-        int8_t uppermostActiveLocation    = maximum(uppermostActiveLocation,    rhs.uppermostActiveLocation);
+        int8_t uppermostActiveBufferIndex = maximum(this->uppermostActiveBufferIndex, rhs.uppermostActiveBufferIndex);
+        int8_t uppermostActiveLocation    = maximum(this->uppermostActiveLocation,    rhs.uppermostActiveLocation);
         for (int i = 0; i <= uppermostActiveBufferIndex; ++i) if (bufferIndexStride      [i] != rhs.bufferIndexStride      [i]) return false;
         for (int i = 0; i <= uppermostActiveBufferIndex; ++i) if (bufferIndexInstancing  [i] != rhs.bufferIndexInstancing  [i]) return false;
         for (int i = 0; i <= uppermostActiveLocation;    ++i) if (locationAttributeFormat[i] != rhs.locationAttributeFormat[i]) return false;
@@ -0,0 +1,295 @@
+#include "glCompact/BufferGpuAllocator.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace glCompact {
+    //value must not be 0
+    static uint32_t findFirstSet(
+        uint64_t value
+    ) {
+        #if defined(__GNUC__) || defined(__clang__)
+            return uint32_t(__builtin_ctzll(value));
+        #else
+            uint32_t i = 0;
+            while (!(value & 1)) {value >>= 1; ++i;}
+            return i;
+        #endif
+    }
+
+    //value must not be 0
+    static uint32_t floorLog2(
+        uint64_t value
+    ) {
+        #if defined(__GNUC__) || defined(__clang__)
+            return uint32_t(63 - __builtin_clzll(value));
+        #else
+            uint32_t i = 0;
+            while (value >>= 1) ++i;
+            return i;
+        #endif
+    }
+
+    /**
+        \ingroup API
+        \class glCompact::BufferGpuAllocator
+
+        \brief Sub-allocates ranges out of a few big BufferGpu blocks
+
+        \details Many small meshes can share the same buffer objects this way. Draws of different meshes then only differ in their
+        firstVertex/vertexOffset/firstIndex, instead of needing different attribute or index buffer bindings. That makes them cheaper
+        for the state tracker and lets consecutive draws get batched (see setDrawBatching).
+
+        \code{.cpp}
+            BufferGpuAllocator allocator;
+            auto vertices = allocator.allocate(sizeof(meshVertices), sizeof(Vertex));
+            allocator.getBuffer(vertices).copyFromMemory(meshVertices, vertices.offset, sizeof(meshVertices));
+            pipeline.setAttributeBuffer(0, allocator.getBuffer(vertices));
+            pipeline.draw(vertexCount, 1, vertices.offset / sizeof(Vertex), 0);
+            ...
+            allocator.free(vertices);
+        \endcode
+
+        Uses a TLSF (two level segregated fit) allocator, allocate() and free() are O(1). Neighbouring free ranges are merged on free().
+        A new block is created when no free range is big enough. Blocks are never released until the allocator is destroyed.
+
+        \param blockSize            Size of each BufferGpu block in byte. Allocations bigger than this get their own block.
+        \param clientMemoryCopyable Passed on to the BufferGpu blocks, needed for BufferInterface::copyFromMemory()
+    */
+    BufferGpuAllocator::BufferGpuAllocator(
+        uintptr_t blockSize,
+        bool      clientMemoryCopyable
+    ) :
+        blockSize           (alignTo<uintptr_t>(blockSize ? blockSize : granularity, granularity)),
+        clientMemoryCopyable(clientMemoryCopyable)
+    {
+        for (auto& flHead : freeHead)
+            for (auto& head : flHead)
+                head = invalidIndex;
+    }
+
+    /**
+        \brief Allocate a range of at last size bytes
+
+        \param alignment Alignment of the offset, e.g. the vertex stride so that offset / stride can be used as firstVertex. Does not need to be a power of two.
+    */
+    BufferGpuAllocator::Allocation BufferGpuAllocator::allocate(
+        uintptr_t size,
+        uintptr_t alignment
+    ) {
+        UNLIKELY_IF (size == 0)
+            throw runtime_error("BufferGpuAllocator can not allocate 0 byte!");
+        UNLIKELY_IF (alignment == 0)
+            throw runtime_error("BufferGpuAllocator alignment must not be 0!");
+
+        //All offsets are a multiple of granularity, so the alignment is raised to the least common multiple of both
+        uintptr_t offsetAlignment = alignment;
+        while (offsetAlignment % granularity) offsetAlignment += alignment;
+        size = alignTo<uintptr_t>(size, granularity);
+        const uintptr_t searchSize = size + offsetAlignment - granularity;
+
+        uint32_t i = findFree(searchSize);
+        if (i == invalidIndex) {
+            addBlock(searchSize);
+            i = findFree(searchSize);
+        }
+        removeFree(i);
+
+        const uintptr_t padding = alignTo(node[i].offset, offsetAlignment) - node[i].offset;
+        if (padding) {
+            const uint32_t p = newNode();
+            node[p].offset       = node[i].offset;
+            node[p].size         = padding;
+            node[p].block        = node[i].block;
+            node[p].prevPhysical = node[i].prevPhysical;
+            node[p].nextPhysical = i;
+            if (node[i].prevPhysical != invalidIndex) node[node[i].prevPhysical].nextPhysical = p;
+            node[i].prevPhysical = p;
+            node[i].offset      += padding;
+            node[i].size        -= padding;
+            insertFree(p);
+        }
+        if (node[i].size > size) {
+            const uint32_t r = newNode();
+            node[r].offset       = node[i].offset + size;
+            node[r].size         = node[i].size - size;
+            node[r].block        = node[i].block;
+            node[r].prevPhysical = i;
+            node[r].nextPhysical = node[i].nextPhysical;
+            if (node[i].nextPhysical != invalidIndex) node[node[i].nextPhysical].prevPhysical = r;
+            node[i].nextPhysical = r;
+            node[i].size         = size;
+            insertFree(r);
+        }
+
+        usedSize += size;
+        allocationCount++;
+
+        Allocation allocation;
+        allocation.block  = node[i].block;
+        allocation.node   = i;
+        allocation.offset = node[i].offset;
+        allocation.size   = size;
+        return allocation;
+    }
+
+    /**
+        \brief Give the range back to the allocator and reset the allocation handle
+
+        \details The range must not be used by any pending GPU commands anymore.
+    */
+    void BufferGpuAllocator::free(
+        Allocation& allocation
+    ) {
+        UNLIKELY_IF (!allocation.isValid()
+        ||  allocation.node >= node.size()
+        ||  node[allocation.node].block  != allocation.block
+        ||  node[allocation.node].offset != allocation.offset
+        ||  node[allocation.node].isFree)
+            throw runtime_error("BufferGpuAllocator::free() called with an invalid or already freed allocation!");
+
+        uint32_t i = allocation.node;
+        usedSize -= node[i].size;
+        allocationCount--;
+
+        const uint32_t prev = node[i].prevPhysical;
+        if (prev != invalidIndex && node[prev].isFree) {
+            removeFree(prev);
+            node[prev].size        += node[i].size;
+            node[prev].nextPhysical = node[i].nextPhysical;
+            if (node[i].nextPhysical != invalidIndex) node[node[i].nextPhysical].prevPhysical = prev;
+            releaseNode(i);
+            i = prev;
+        }
+        const uint32_t next = node[i].nextPhysical;
+        if (next != invalidIndex && node[next].isFree) {
+            removeFree(next);
+            node[i].size        += node[next].size;
+            node[i].nextPhysical = node[next].nextPhysical;
+            if (node[next].nextPhysical != invalidIndex) node[node[next].nextPhysical].prevPhysical = i;
+            releaseNode(next);
+        }
+        insertFree(i);
+
+        allocation = Allocation();
+    }
+
+    BufferGpuAllocatorStatistics BufferGpuAllocator::getStatistics() const {
+        BufferGpuAllocatorStatistics statistics;
+        statistics.blockCount      = uint32_t(block.size());
+        for (auto& b : block) statistics.capacity += b.getSize();
+        statistics.usedSize        = usedSize;
+        statistics.freeSize        = statistics.capacity - usedSize;
+        statistics.allocationCount = allocationCount;
+        for (auto& n : node) {
+            if (n.block == invalidIndex || !n.isFree) continue;
+            statistics.freeRangeCount++;
+            if (n.size > statistics.largestFreeRange) statistics.largestFreeRange = n.size;
+        }
+        return statistics;
+    }
+
+    void BufferGpuAllocator::mapping(
+        uintptr_t size,
+        uint32_t& fl,
+        uint32_t& sl
+    ) {
+        if (size < (uintptr_t(1) << smallSizeLog2)) {
+            fl = 0;
+            sl = uint32_t(size / granularity);
+        } else {
+            const uint32_t log2 = floorLog2(size);
+            fl = log2 - smallSizeLog2 + 1;
+            sl = uint32_t(size >> (log2 - slBits)) - slCount;
+        }
+    }
+
+    //Returns a free node with at last size bytes or invalidIndex
+    uint32_t BufferGpuAllocator::findFree(
+        uintptr_t size
+    ) {
+        //round up to the next list start, so every range in the found list is big enough
+        if (size >= (uintptr_t(1) << smallSizeLog2)) size += (uintptr_t(1) << (floorLog2(size) - slBits)) - 1;
+        uint32_t fl, sl;
+        mapping(size, fl, sl);
+
+        uint32_t slMap = slBitmap[fl] & (~uint32_t(0) << sl);
+        if (!slMap) {
+            const uint64_t flMap = fl + 1 < 64 ? flBitmap & (~uint64_t(0) << (fl + 1)) : 0;
+            if (!flMap) return invalidIndex;
+            fl    = findFirstSet(flMap);
+            slMap = slBitmap[fl];
+        }
+        sl = findFirstSet(slMap);
+        return freeHead[fl][sl];
+    }
+
+    void BufferGpuAllocator::insertFree(
+        uint32_t nodeIndex
+    ) {
+        uint32_t fl, sl;
+        mapping(node[nodeIndex].size, fl, sl);
+        Node& n = node[nodeIndex];
+        n.isFree   = true;
+        n.prevFree = invalidIndex;
+        n.nextFree = freeHead[fl][sl];
+        if (n.nextFree != invalidIndex) node[n.nextFree].prevFree = nodeIndex;
+        freeHead[fl][sl] = nodeIndex;
+        flBitmap     |= uint64_t(1) << fl;
+        slBitmap[fl] |= uint32_t(1) << sl;
+    }
+
+    void BufferGpuAllocator::removeFree(
+        uint32_t nodeIndex
+    ) {
+        uint32_t fl, sl;
+        mapping(node[nodeIndex].size, fl, sl);
+        Node& n = node[nodeIndex];
+        if (n.prevFree != invalidIndex) {
+            node[n.prevFree].nextFree = n.nextFree;
+        } else {
+            freeHead[fl][sl] = n.nextFree;
+            if (n.nextFree == invalidIndex) {
+                slBitmap[fl] &= ~(uint32_t(1) << sl);
+                if (!slBitmap[fl]) flBitmap &= ~(uint64_t(1) << fl);
+            }
+        }
+        if (n.nextFree != invalidIndex) node[n.nextFree].prevFree = n.prevFree;
+        n.isFree   = false;
+        n.prevFree = invalidIndex;
+        n.nextFree = invalidIndex;
+    }
+
+    uint32_t BufferGpuAllocator::newNode() {
+        if (!unusedNode.empty()) {
+            const uint32_t i = unusedNode.back();
+            unusedNode.pop_back();
+            return i;
+        }
+        node.emplace_back();
+        return uint32_t(node.size() - 1);
+    }
+
+    void BufferGpuAllocator::releaseNode(
+        uint32_t nodeIndex
+    ) {
+        node[nodeIndex] = Node();
+        unusedNode.push_back(nodeIndex);
+    }
+
+    void BufferGpuAllocator::addBlock(
+        uintptr_t minimumSize
+    ) {
+        const uintptr_t size = minimumSize > blockSize ? alignTo<uintptr_t>(minimumSize, granularity) : blockSize;
+        block.emplace_back(clientMemoryCopyable, size);
+
+        const uint32_t i = newNode();
+        node[i].offset = 0;
+        node[i].size   = size;
+        node[i].block  = uint32_t(block.size() - 1);
+        insertFree(i);
+    }
+}
@@ -111,6 +111,7 @@ namespace glCompact {
         uintptr_t size,
         bool      commit
     ) {
+        threadContext_->flushDrawBatch();
         if (threadContextGroup_->extensions.GL_ARB_direct_state_access) {
             threadContextGroup_->functions.glNamedBufferPageCommitmentARB(id, offset, size, commit);
         } else {
@@ -122,6 +123,7 @@ namespace glCompact {
     void BufferGpuSparse::copyCommitment(
         const BufferGpuSparse& buffer
     ) {
+        threadContext_->flushDrawBatch();
         int currentPos = 0;
         int endPos = buffer.size / pageSize;
 
@@ -140,6 +142,7 @@ namespace glCompact {
     void BufferGpuSparse::copyFromBufferCommitmentRegionOnly(
         const BufferGpuSparse& buffer
     ) {
+        threadContext_->flushDrawBatch();
         int currentPos = 0;
         int endPos = buffer.size / pageSize;
 
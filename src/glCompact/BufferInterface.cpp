@@ -35,6 +35,7 @@ namespace glCompact {
         uintptr_t              dstOffset,
         uintptr_t              copySize
     ) {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         auto throwWithInfo = [&](string error) {
             throw runtime_error(string() + "Error in\n"
@@ -190,6 +191,7 @@ void main() {
         uintptr_t   thisOffset,
         uintptr_t   copySize
     ) {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         auto throwWithInfo = [&](string error) {
             throw runtime_error(string() + "Error in\n"
@@ -227,6 +229,7 @@ void main() {
         uintptr_t thisOffset,
         uintptr_t copySize
     ) const {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         auto throwWithInfo = [&](string error) {
             throw runtime_error(string() + "Error in\n"
@@ -256,6 +259,7 @@ void main() {
         \brief Set the whole buffer content to the value 0
     */
     void BufferInterface::clear() {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         //glClearBufferData -> If data is NULL , then the pointer is ignored and the sub-range of the buffer is filled with zeros.
         //Not sure if standard needs parameters when pointer is 0, but some drivers may fuck around otherwise!
@@ -279,6 +283,7 @@ void main() {
         uintptr_t offset,
         uintptr_t size
     ) {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         clear(offset, size, 1, 0);
     }
@@ -306,6 +311,7 @@ void main() {
         uintptr_t   fillValueSize,
         const void* fillValue
     ) {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         auto throwWithInfo = [&](string error) {
             throw runtime_error(string() + "Error in\n"
@@ -401,6 +407,7 @@ void main() {
         After this the content of the buffer is undefined until something is written to it.
     */
     void BufferInterface::invalidate() {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         if (threadContextGroup_->extensions.GL_ARB_invalidate_subdata) {
             threadContextGroup_->functions.glInvalidateBufferData(id);
@@ -423,6 +430,7 @@ void main() {
         uintptr_t offset,
         uintptr_t invalidateSize
     ) {
+        threadContext_->flushDrawBatch();
         Debug::assertThreadHasActiveGlContext();
         if (threadContextGroup_->extensions.GL_ARB_invalidate_subdata) {
             threadContextGroup_->functions.glInvalidateBufferSubData(id, offset, invalidateSize);
@@ -508,7 +516,10 @@ void main() {
                 UNLIKELY_IF (!threadContextGroup_->functions.glGetString(GL_VERSION)) crash("glCompact::Buffer destructor called but thread has no active OpenGL context! glDeleteBuffers without effect! Leaking OpenGL object!");
             #endif
 
-            if (threadContext_) threadContext_->forgetBufferId(id);
+            if (threadContext_) {
+                threadContext_->flushDrawBatch();
+                threadContext_->forgetBufferId(id);
+            }
             threadContextGroup_->functions.glDeleteBuffers(1, &id);
 
             id    = 0;
@@ -0,0 +1,269 @@
+#include "glCompact/BufferReadback.hpp"
+#include "glCompact/TextureInterface.hpp"
+#include "glCompact/Frame.hpp"
+#include "glCompact/MemorySurfaceFormatDetail.hpp"
+#include "glCompact/gl/Constants.hpp"
+#include "glCompact/Context_.hpp"
+#include "glCompact/threadContext_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::BufferReadbackPool
+
+        \brief Reads back buffer, texture and frame content without stalling the CPU until the GPU catches up
+
+        \details BufferInterface::copyToMemory(), TextureInterface::copyConvertToMemory() and Frame::copyConvert*ToMemory() have to wait until all commands
+        that write to the source are executed. The readback functions instead queue a copy into a persistently mapped BufferStaging (bound as pixel pack buffer
+        for texture and frame readbacks), put a Fence behind it and return a BufferReadback handle.
+        The data can be accessed via the handle once the GPU is done, usually a frame or two later.
+
+        \code{.cpp}
+            BufferReadbackPool readbackPool;
+            std::deque<BufferReadback> pending;
+            //each frame
+            MemoryBarrier::bufferCreateClearCopyInvalidate(); //if the buffer got written by shaders
+            pending.push_back(readbackPool.readback(pickingResultBuffer, 0, sizeof(PickingResult)));
+            while (!pending.empty() && pending.front().isReady()) {
+                const PickingResult* result = pending.front().getPtr();
+                ...
+                pending.pop_front();
+            }
+        \endcode
+
+        For video capture keep N handles in flight and consume the oldest one each frame:
+        \code{.cpp}
+            pending.push_back(readbackPool.readbackRgba(getDisplayFrame(), 0, MemorySurfaceFormat::R8G8B8A8_UNORM, {0, 0}, frameSize));
+            if (pending.size() > 3) {
+                encoder.addFrame(pending.front().getPtr(), pending.front().getRowStride());
+                pending.pop_front();
+            }
+        \endcode
+
+        Staging buffers are reused after their handle got released or destroyed. Their sizes are rounded up to a power of two (at last 256 byte),
+        so readbacks of varying size can share them. The pool only grows and must outlive all handles created by it.
+
+        Depends on BufferStaging and therefore GL_ARB_buffer_storage (Core since 4.4)
+    */
+
+    /**
+        \brief Queue a copy of size bytes starting at srcOffset of srcBuffer and return a handle to the data
+    */
+    BufferReadback BufferReadbackPool::readback(
+        const BufferInterface& srcBuffer,
+        uintptr_t              srcOffset,
+        uintptr_t              size
+    ) {
+        UNLIKELY_IF (size == 0)
+            throw runtime_error("BufferReadbackPool can not read back 0 byte!");
+        const uint32_t i = acquire(size);
+        entry[i].buffer.copyFromBuffer(srcBuffer, srcOffset, 0, size);
+        return submit(i, size, 0);
+    }
+
+    /**
+        \brief Queue a copy of a texture region, converted to memorySurfaceFormat (like TextureInterface::copyConvertToMemory)
+
+        \details Rows are padded to 4 byte (the default GL_PACK_ALIGNMENT), see BufferReadback::getRowStride()
+    */
+    BufferReadback BufferReadbackPool::readback(
+        const TextureInterface& texture,
+        MemorySurfaceFormat     memorySurfaceFormat,
+        uint32_t                mipmapLevel,
+        glm::ivec3              texOffset,
+        glm::ivec3              texSize
+    ) {
+        UNLIKELY_IF (memorySurfaceFormat.detail().isCompressed)
+            throw runtime_error("BufferReadbackPool can not read back into compressed memory surface formats!");
+        UNLIKELY_IF (texSize.x < 1 || texSize.y < 1 || texSize.z < 1)
+            throw runtime_error("BufferReadbackPool texture readback size must be at last 1 in all dimensions!");
+        const uintptr_t rowStride = getRowStride(memorySurfaceFormat, texSize.x);
+        const uintptr_t size      = rowStride * uintptr_t(texSize.y) * uintptr_t(texSize.z);
+        const uint32_t  i         = acquire(size);
+        texture.copyConvertToBuffer(entry[i].buffer, 0, uint32_t(entry[i].buffer.getSize()), memorySurfaceFormat, mipmapLevel, texOffset, texSize);
+        return submit(i, size, rowStride);
+    }
+
+    /**
+        \brief Queue a copy of a region of an RGBA attachment of frame, converted to memorySurfaceFormat (like Frame::copyConvertRgbaToMemory)
+
+        \details Rows are padded to 4 byte (the default GL_PACK_ALIGNMENT), see BufferReadback::getRowStride()
+    */
+    BufferReadback BufferReadbackPool::readbackRgba(
+        Frame&              frame,
+        uint32_t            rgbaSlot,
+        MemorySurfaceFormat memorySurfaceFormat,
+        glm::ivec2          offset,
+        glm::ivec2          size
+    ) {
+        UNLIKELY_IF (size.x < 1 || size.y < 1)
+            throw runtime_error("BufferReadbackPool frame readback size must be at last 1 in all dimensions!");
+        const uintptr_t rowStride = getRowStride(memorySurfaceFormat, size.x);
+        const uintptr_t byteSize  = rowStride * uintptr_t(size.y);
+        const uint32_t  i         = acquire(byteSize);
+        frame.copyConvertRgbaToBuffer(rgbaSlot, entry[i].buffer, 0, entry[i].buffer.getSize(), memorySurfaceFormat, offset, size);
+        return submit(i, byteSize, rowStride);
+    }
+
+    /**
+        \brief Queue a copy of a region of the depth attachment of frame, converted to memorySurfaceFormat (like Frame::copyConvertDepthToMemory)
+
+        \details Rows are padded to 4 byte (the default GL_PACK_ALIGNMENT), see BufferReadback::getRowStride()
+    */
+    BufferReadback BufferReadbackPool::readbackDepth(
+        Frame&              frame,
+        MemorySurfaceFormat memorySurfaceFormat,
+        glm::ivec2          offset,
+        glm::ivec2          size
+    ) {
+        UNLIKELY_IF (size.x < 1 || size.y < 1)
+            throw runtime_error("BufferReadbackPool frame readback size must be at last 1 in all dimensions!");
+        const uintptr_t rowStride = getRowStride(memorySurfaceFormat, size.x);
+        const uintptr_t byteSize  = rowStride * uintptr_t(size.y);
+        const uint32_t  i         = acquire(byteSize);
+        frame.copyConvertDepthToBuffer(entry[i].buffer, 0, entry[i].buffer.getSize(), memorySurfaceFormat, offset, size);
+        return submit(i, byteSize, rowStride);
+    }
+
+    /**
+        \brief Size of all staging buffers of this pool together in byte
+    */
+    uintptr_t BufferReadbackPool::getPoolSize() const {
+        uintptr_t poolSize = 0;
+        for (auto& e : entry) poolSize += e.buffer.getSize();
+        return poolSize;
+    }
+
+    //Returns the smallest unused entry with at last size bytes, or a new one
+    uint32_t BufferReadbackPool::acquire(
+        uintptr_t size
+    ) {
+        uint32_t best = uint32_t(entry.size());
+        LOOPI(entry.size()) {
+            if (entry[i].inUse || entry[i].buffer.getSize() < size) continue;
+            if (best == entry.size() || entry[i].buffer.getSize() < entry[best].buffer.getSize()) best = uint32_t(i);
+        }
+        if (best == entry.size()) {
+            uintptr_t bufferSize = 256;
+            while (bufferSize < size) bufferSize *= 2;
+            entry.emplace_back(bufferSize);
+        }
+        //pending barriers (e.g. MemoryBarrier::bufferCreateClearCopyInvalidate) must be executed before the copy
+        threadContext_->processPendingChangesMemoryBarriers();
+        return best;
+    }
+
+    //Called after the copy into the entry buffer got issued
+    BufferReadback BufferReadbackPool::submit(
+        uint32_t  entryIndex,
+        uintptr_t size,
+        uintptr_t rowStride
+    ) {
+        //the mapping is not coherent, without this barrier the CPU may not see the copied data even after the fence got signaled
+        threadContext_->memoryBarrierMask |= GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT;
+        threadContext_->processPendingChangesMemoryBarriers();
+        entry[entryIndex].fence.insert();
+        entry[entryIndex].inUse = true;
+
+        BufferReadback handle;
+        handle.pool      = this;
+        handle.entry     = entryIndex;
+        handle.size      = size;
+        handle.rowStride = rowStride;
+        return handle;
+    }
+
+    uintptr_t BufferReadbackPool::getRowStride(
+        MemorySurfaceFormat memorySurfaceFormat,
+        int32_t             width
+    ) {
+        return alignTo<uintptr_t>(uintptr_t(memorySurfaceFormat.detail().bytePerPixelOrBlock) * uintptr_t(width), 4);
+    }
+
+    /**
+        \ingroup API
+        \class glCompact::BufferReadback
+
+        \brief Handle to a pending or finished readback of a BufferReadbackPool
+
+        \details Move only. The staging buffer goes back to the pool when the handle gets released or destroyed.
+    */
+    BufferReadback::BufferReadback(
+        BufferReadback&& readback
+    ) {
+        pool      = readback.pool;
+        entry     = readback.entry;
+        size      = readback.size;
+        rowStride = readback.rowStride;
+        ready     = readback.ready;
+        readback.pool      = 0;
+        readback.size      = 0;
+        readback.rowStride = 0;
+        readback.ready     = false;
+    }
+
+    BufferReadback& BufferReadback::operator=(
+        BufferReadback&& readback
+    ) {
+        UNLIKELY_IF (&readback == this) return *this;
+        release();
+        return *new(this)BufferReadback(move(readback));
+    }
+
+    BufferReadback::~BufferReadback() {
+        release();
+    }
+
+    /**
+        \brief Returns true if the GPU finished the copy. Does not wait.
+    */
+    bool BufferReadback::isReady() {
+        UNLIKELY_IF (!pool)
+            throw runtime_error("BufferReadback::isReady() called on an empty handle!");
+        if (!ready) ready = pool->entry[entry].fence.isSignaled();
+        return ready;
+    }
+
+    /**
+        \brief Wait a maximum of timeoutInNanoseconds for the GPU to finish the copy
+
+        @return true if the data is ready
+    */
+    bool BufferReadback::wait(
+        uint64_t timeoutInNanoseconds
+    ) {
+        UNLIKELY_IF (!pool)
+            throw runtime_error("BufferReadback::wait() called on an empty handle!");
+        if (!ready) ready = pool->entry[entry].fence.isSignaledOrWait(timeoutInNanoseconds);
+        return ready;
+    }
+
+    /**
+        \brief Pointer to the read back data, valid until the handle gets released. Waits for the GPU if the data is not ready yet.
+    */
+    CastAnyPtr BufferReadback::getPtr() {
+        wait();
+        return pool->entry[entry].buffer.getPtr();
+    }
+
+    /**
+        \brief Hand the staging buffer back to the pool. The handle is empty afterwards.
+    */
+    void BufferReadback::release() {
+        if (!pool) return;
+        pool->entry[entry].inUse = false;
+        pool      = 0;
+        size      = 0;
+        rowStride = 0;
+        ready     = false;
+    }
+}
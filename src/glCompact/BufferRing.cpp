@@ -0,0 +1,161 @@
+#include "glCompact/BufferRing.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::BufferRing
+
+        \brief Streaming buffer for dynamic per frame data (vertices, indices, uniform and shader storage blocks)
+
+        \details Wraps one persistently mapped BufferStaging that is split into segments. Allocations are taken linear from the current segment
+        and written directly by the CPU, without driver copies or implicit synchronisation like BufferInterface::copyFromMemory.
+
+        nextSegment() puts a Fence behind all commands that used the current segment and moves on to the next one, typically once per frame.
+        When the ring wraps around into a segment that the GPU is still reading from, the CPU waits for its Fence. This is counted in
+        getStallCount()/getStallNanoseconds(). If this happens regularly more or bigger segments are needed.
+
+        If an allocation does not fit into the rest of the current segment, it continues in the next segment without a Fence, because the commands
+        reading the earlier allocations may not be issued yet. The following nextSegment() guards all segments used since the last call with a Fence.
+        Allocations between two nextSegment() calls that do not fit into the whole ring throw an exception.
+
+        \code{.cpp}
+            BufferRing bufferRing(1024 * 1024);
+            //each frame
+            auto allocation = bufferRing.allocateUniform(sizeof(MyUniformBlock));
+            new (allocation.getPtr()) MyUniformBlock(...);
+            bufferRing.flushWrites();
+            pipeline.setUniformBuffer(0, bufferRing.getBuffer(), allocation.offset, allocation.size);
+            pipeline.draw(...);
+            bufferRing.nextSegment();
+        \endcode
+
+        Depends on BufferStaging and therefore GL_ARB_buffer_storage (Core since 4.4)
+
+        \param segmentSize  Size of one segment in byte, rounded up to a multiple of 256. This is the upper limit of a single allocation.
+        \param segmentCount Number of segments, must be at last 2. Usually the amount of frames the GPU may lag behind the CPU plus one.
+    */
+    BufferRing::BufferRing(
+        uintptr_t segmentSize,
+        uint32_t  segmentCount
+    ) :
+        segmentSize((segmentSize + 255) & ~uintptr_t(255)),
+        buffer     (this->segmentSize * segmentCount),
+        segment    (segmentCount)
+    {
+        UNLIKELY_IF (segmentCount < 2)
+            throw runtime_error("BufferRing needs at last 2 segments!");
+    }
+
+    /**
+        \brief Allocate size bytes from the current segment
+
+        \param alignment byte alignment of the allocation offset inside of the buffer
+    */
+    BufferRing::Allocation BufferRing::allocate(
+        uintptr_t size,
+        uintptr_t alignment
+    ) {
+        UNLIKELY_IF (size > segmentSize)
+            throw runtime_error("BufferRing allocation of " + to_string(size) + " byte is bigger then the segment size of " + to_string(segmentSize) + " byte!");
+        UNLIKELY_IF (alignment == 0 || alignment > 256)
+            throw runtime_error("BufferRing allocation alignment must be between 1 and 256!");
+
+        uintptr_t offset = (head + alignment - 1) / alignment * alignment;
+        if (offset + size > segmentBegin() + segmentSize) {
+            UNLIKELY_IF ((segmentIndex + 1) % segment.size() == frameSegmentIndex)
+                throw runtime_error("BufferRing allocations since the last nextSegment() do not fit into all " + to_string(segment.size()) + " segments!");
+            flushWrites();
+            advanceSegment();
+            offset = head;
+        }
+        head = offset + size;
+
+        Allocation allocation;
+        allocation.offset = offset;
+        allocation.size   = size;
+        allocation.mem    = static_cast<char*>(buffer.getPtr()) + offset;
+        return allocation;
+    }
+
+    /**
+        \brief Allocate size bytes aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, for use with setUniformBuffer()
+    */
+    BufferRing::Allocation BufferRing::allocateUniform(
+        uintptr_t size
+    ) {
+        return allocate(size, uintptr_t(max(threadContextGroup_->values.GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, 1)));
+    }
+
+    /**
+        \brief Allocate size bytes aligned to GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, for use with setShaderStorageBuffer()
+    */
+    BufferRing::Allocation BufferRing::allocateShaderStorage(
+        uintptr_t size
+    ) {
+        return allocate(size, uintptr_t(max(threadContextGroup_->values.GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, 1)));
+    }
+
+    /**
+        \brief Make all writes to allocations since the last call visible to the GPU
+
+        \details Must be called after writing the data and before issuing the commands that read it.
+    */
+    void BufferRing::flushWrites() {
+        if (head == flushBegin) return;
+        buffer.bufferStagingFlushWrites(flushBegin, head - flushBegin);
+        flushBegin = head;
+    }
+
+    /**
+        \brief Guard the current segment with a Fence and continue with the next one. Waits if the GPU did not finish reading the next segment yet.
+
+        \details Must be called after issuing all commands that read the allocations since the last call, typically once per frame.
+        Segments that got filled up by allocations in between are guarded by a Fence here, too.
+    */
+    void BufferRing::nextSegment() {
+        flushWrites();
+        for (uint32_t i = frameSegmentIndex;; i = (i + 1) % segment.size()) {
+            segment[i].fence.insert();
+            segment[i].inUse = true;
+            if (i == segmentIndex) break;
+        }
+        advanceSegment();
+        frameSegmentIndex = segmentIndex;
+    }
+
+    void BufferRing::resetStallCounter() {
+        stallCount       = 0;
+        stallNanoseconds = 0;
+    }
+
+    void BufferRing::advanceSegment() {
+        segmentIndex = (segmentIndex + 1) % segment.size();
+        waitForSegment(segment[segmentIndex]);
+        head       = segmentBegin();
+        flushBegin = head;
+    }
+
+    void BufferRing::waitForSegment(
+        Segment& s
+    ) {
+        if (!s.inUse) return;
+        if (!s.fence.isSignaled()) {
+            auto start = chrono::steady_clock::now();
+            s.fence.isSignaledOrWait();
+            auto end   = chrono::steady_clock::now();
+            stallCount++;
+            stallNanoseconds += uint64_t(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+        }
+        s.fence.free();
+        s.inUse = false;
+    }
+}
@@ -0,0 +1,442 @@
+#include "glCompact/CommandList.hpp"
+#include "glCompact/PipelineRasterization.hpp"
+#include "glCompact/PipelineCompute.hpp"
+#include "glCompact/TextureInterface.hpp"
+#include "glCompact/BufferInterface.hpp"
+#include "glCompact/Sampler.hpp"
+#include "glCompact/Tools_.hpp"
+
+/*
+    Recording only writes into the byte stream and never touches OpenGL or the thread context, so it can happen on any thread.
+    Replaying calls the normal pipeline functions, so the usual state tracking and processPendingChanges apply and nothing is sent to OpenGL that a direct call would not send.
+
+    Commands are stored back to back, each one is a CommandHeader followed by its payload and padded to 8 bytes.
+    All referenced objects are stored as pointers. They must still exist and must not be changed by other threads while replay() runs.
+*/
+
+using namespace std;
+
+namespace glCompact {
+    namespace {
+        struct TextureCommand {
+            PipelineInterface*      pipeline;
+            const TextureInterface* texture;
+            uint32_t                slot;
+        };
+
+        struct SamplerCommand {
+            PipelineInterface* pipeline;
+            const Sampler*     sampler;
+            uint32_t           slot;
+        };
+
+        struct SlotCommand {
+            PipelineInterface* pipeline;
+            uint32_t           slot;
+        };
+
+        struct BufferCommand {
+            PipelineInterface*     pipeline;
+            const BufferInterface* buffer;
+            uintptr_t              offset;
+            uintptr_t              size;
+            uint32_t               slot;
+        };
+
+        struct IndexBufferCommand {
+            PipelineRasterization* pipeline;
+            const BufferInterface* buffer;
+            uintptr_t              offset;
+            IndexType              indexType;
+        };
+
+        struct DrawCommand {
+            PipelineRasterization* pipeline;
+            uint32_t               count;
+            uint32_t               instanceCount;
+            uint32_t               first;
+             int32_t               vertexOffset;
+            uint32_t               firstInstance;
+        };
+
+        struct DrawIndirectCommand {
+            PipelineRasterization* pipeline;
+            const BufferInterface* parameterBuffer;
+            intptr_t               parameterBufferOffset;
+            uint32_t               count;
+            uint32_t               stride;
+        };
+
+        struct DispatchCommand {
+            PipelineCompute* pipeline;
+            uint32_t         groupCount[3];
+        };
+
+        struct DispatchIndirectCommand {
+            PipelineCompute*       pipeline;
+            const BufferInterface* buffer;
+            uintptr_t              offset;
+        };
+
+        //uintptr_t(-1) marks setUniformBuffer without size, that binds from offset to the end of the buffer
+        const uintptr_t wholeBuffer = ~uintptr_t(0);
+    }
+
+    /**
+        \ingroup API
+        \class glCompact::CommandList
+
+        \brief Records pipeline bindings, uniform values, draws and dispatches on any thread to replay them later on the thread of the context
+
+        \details The commands are written into one linear block of memory. clear() keeps that memory, so once a CommandList did grow to its working size
+        recording does not allocate anymore. reserveByteSize can be used to skip that warmup.
+
+        One CommandList must only be used by one thread at a time. Recording several lists on different threads and replaying them one after another
+        on the context thread is the intended use.
+
+            //on a worker thread
+            commandList.clear();
+            commandList.setTexture(myPipeline, 0, object.texture);
+            commandList.setUniform(myPipeline.modelMatrix, object.modelMatrix);
+            commandList.drawIndexed(myPipeline, object.indexCount, 1, object.firstIndex, 0, 0);
+
+            //on the context thread, after the worker is done
+            commandList.replay();
+
+        Replaying does the same as calling the functions directly, including all state change elision.
+        Everything referenced by the list (pipelines, textures, buffers, UniformSetter) must outlive the replay.
+    */
+    CommandList::CommandList(
+        std::size_t reserveByteSize
+    ) {
+        data.reserve(reserveByteSize);
+    }
+
+    char* CommandList::allocate(
+        CommandType type,
+        uint32_t    payloadSize
+    ) {
+        uint32_t size = (uint32_t(sizeof(CommandHeader)) + payloadSize + alignment - 1) & ~(alignment - 1);
+        size_t offset = data.size();
+        data.resize(offset + size);
+        char* p = &data[offset];
+        CommandHeader* header = new (p) CommandHeader;
+        header->type = type;
+        header->size = size;
+        commandCount++;
+        return p + sizeof(CommandHeader);
+    }
+
+    template<typename T>
+    T* CommandList::allocate(
+        CommandType type
+    ) {
+        static_assert(std::is_trivially_copyable<T>::value, "command payload must be trivially copyable");
+        static_assert(alignof(T) <= alignment, "command payload alignment too big");
+        return new (allocate(type, sizeof(T))) T;
+    }
+
+    void CommandList::setTexture(
+        PipelineInterface&      pipeline,
+        uint32_t                slot,
+        const TextureInterface& texture
+    ) {
+        auto c = allocate<TextureCommand>(CommandType::setTexture);
+        c->pipeline = &pipeline;
+        c->texture  = &texture;
+        c->slot     = slot;
+    }
+
+    void CommandList::setTexture(
+        PipelineInterface& pipeline,
+        uint32_t           slot
+    ) {
+        auto c = allocate<SlotCommand>(CommandType::setTextureNone);
+        c->pipeline = &pipeline;
+        c->slot     = slot;
+    }
+
+    void CommandList::setSampler(
+        PipelineInterface& pipeline,
+        uint32_t           slot,
+        const Sampler&     sampler
+    ) {
+        auto c = allocate<SamplerCommand>(CommandType::setSampler);
+        c->pipeline = &pipeline;
+        c->sampler  = &sampler;
+        c->slot     = slot;
+    }
+
+    void CommandList::setSampler(
+        PipelineInterface& pipeline,
+        uint32_t           slot
+    ) {
+        auto c = allocate<SlotCommand>(CommandType::setSamplerNone);
+        c->pipeline = &pipeline;
+        c->slot     = slot;
+    }
+
+    void CommandList::setUniformBuffer(
+        PipelineInterface&     pipeline,
+        uint32_t               slot,
+        const BufferInterface& buffer,
+        uintptr_t              offset
+    ) {
+        setUniformBuffer(pipeline, slot, buffer, offset, wholeBuffer);
+    }
+
+    void CommandList::setUniformBuffer(
+        PipelineInterface&     pipeline,
+        uint32_t               slot,
+        const BufferInterface& buffer,
+        uintptr_t              offset,
+        uintptr_t              size
+    ) {
+        auto c = allocate<BufferCommand>(CommandType::setUniformBuffer);
+        c->pipeline = &pipeline;
+        c->buffer   = &buffer;
+        c->offset   = offset;
+        c->size     = size;
+        c->slot     = slot;
+    }
+
+    void CommandList::setUniformBuffer(
+        PipelineInterface& pipeline,
+        uint32_t           slot
+    ) {
+        auto c = allocate<SlotCommand>(CommandType::setUniformBufferNone);
+        c->pipeline = &pipeline;
+        c->slot     = slot;
+    }
+
+    void CommandList::setAttributeBuffer(
+        PipelineRasterization& pipeline,
+        uint32_t               slot,
+        const BufferInterface& buffer,
+        uintptr_t              offset
+    ) {
+        auto c = allocate<BufferCommand>(CommandType::setAttributeBuffer);
+        c->pipeline = &pipeline;
+        c->buffer   = &buffer;
+        c->offset   = offset;
+        c->size     = 0;
+        c->slot     = slot;
+    }
+
+    void CommandList::setAttributeBuffer(
+        PipelineRasterization& pipeline,
+        uint32_t               slot
+    ) {
+        auto c = allocate<SlotCommand>(CommandType::setAttributeBufferNone);
+        c->pipeline = &pipeline;
+        c->slot     = slot;
+    }
+
+    void CommandList::setAttributeIndexBuffer(
+        PipelineRasterization& pipeline,
+        IndexType              indexType,
+        const BufferInterface& buffer,
+        uintptr_t              offset
+    ) {
+        auto c = allocate<IndexBufferCommand>(CommandType::setAttributeIndexBuffer);
+        c->pipeline  = &pipeline;
+        c->buffer    = &buffer;
+        c->offset    = offset;
+        c->indexType = indexType;
+    }
+
+    void CommandList::setAttributeIndexBuffer(
+        PipelineRasterization& pipeline
+    ) {
+        auto c = allocate<SlotCommand>(CommandType::setAttributeIndexBufferNone);
+        c->pipeline = &pipeline;
+        c->slot     = 0;
+    }
+
+    void CommandList::draw(
+        PipelineRasterization& pipeline,
+        uint32_t               vertexCount,
+        uint32_t               instanceCount,
+        uint32_t               firstVertex,
+        uint32_t               firstInstance
+    ) {
+        auto c = allocate<DrawCommand>(CommandType::draw);
+        c->pipeline      = &pipeline;
+        c->count         = vertexCount;
+        c->instanceCount = instanceCount;
+        c->first         = firstVertex;
+        c->vertexOffset  = 0;
+        c->firstInstance = firstInstance;
+    }
+
+    void CommandList::drawIndexed(
+        PipelineRasterization& pipeline,
+        uint32_t               indexCount,
+        uint32_t               instanceCount,
+        uint32_t               firstIndex,
+        int32_t                vertexOffset,
+        uint32_t               firstInstance
+    ) {
+        auto c = allocate<DrawCommand>(CommandType::drawIndexed);
+        c->pipeline      = &pipeline;
+        c->count         = indexCount;
+        c->instanceCount = instanceCount;
+        c->first         = firstIndex;
+        c->vertexOffset  = vertexOffset;
+        c->firstInstance = firstInstance;
+    }
+
+    void CommandList::drawIndirect(
+        PipelineRasterization& pipeline,
+        const BufferInterface& parameterBuffer,
+        intptr_t               parameterBufferOffset,
+        uint32_t               count,
+        uint32_t               stride
+    ) {
+        auto c = allocate<DrawIndirectCommand>(CommandType::drawIndirect);
+        c->pipeline              = &pipeline;
+        c->parameterBuffer       = &parameterBuffer;
+        c->parameterBufferOffset = parameterBufferOffset;
+        c->count                 = count;
+        c->stride                = stride;
+    }
+
+    void CommandList::drawIndexedIndirect(
+        PipelineRasterization& pipeline,
+        const BufferInterface& parameterBuffer,
+        intptr_t               parameterBufferOffset,
+        uint32_t               count,
+        uint32_t               stride
+    ) {
+        auto c = allocate<DrawIndirectCommand>(CommandType::drawIndexedIndirect);
+        c->pipeline              = &pipeline;
+        c->parameterBuffer       = &parameterBuffer;
+        c->parameterBufferOffset = parameterBufferOffset;
+        c->count                 = count;
+        c->stride                = stride;
+    }
+
+    void CommandList::dispatch(
+        PipelineCompute& pipeline,
+        uint32_t         groupCountX,
+        uint32_t         groupCountY,
+        uint32_t         groupCountZ
+    ) {
+        auto c = allocate<DispatchCommand>(CommandType::dispatch);
+        c->pipeline      = &pipeline;
+        c->groupCount[0] = groupCountX;
+        c->groupCount[1] = groupCountY;
+        c->groupCount[2] = groupCountZ;
+    }
+
+    void CommandList::dispatchIndirect(
+        PipelineCompute&       pipeline,
+        const BufferInterface& buffer,
+        uintptr_t              offset
+    ) {
+        auto c = allocate<DispatchIndirectCommand>(CommandType::dispatchIndirect);
+        c->pipeline = &pipeline;
+        c->buffer   = &buffer;
+        c->offset   = offset;
+    }
+
+    /**
+        \brief Executes all recorded commands in order. Must be called on the thread of the context. The list is not cleared and can be replayed again.
+    */
+    void CommandList::replay() const {
+        replay(0, data.size());
+    }
+
+    //Replays the commands in the byte range [byteBegin, byteEnd), both must be command boundaries (getByteSize() at recording time)
+    void CommandList::replay(
+        std::size_t byteBegin,
+        std::size_t byteEnd
+    ) const {
+        const char* p   = data.data() + byteBegin;
+        const char* end = data.data() + byteEnd;
+        while (p != end) {
+            const CommandHeader* header  = reinterpret_cast<const CommandHeader*>(p);
+            const char*          payload = p + sizeof(CommandHeader);
+            switch (header->type) {
+                case CommandType::setTexture: {
+                    auto c = reinterpret_cast<const TextureCommand*>(payload);
+                    c->pipeline->setTexture(c->slot, *c->texture);
+                } break;
+                case CommandType::setTextureNone: {
+                    auto c = reinterpret_cast<const SlotCommand*>(payload);
+                    c->pipeline->setTexture(c->slot);
+                } break;
+                case CommandType::setSampler: {
+                    auto c = reinterpret_cast<const SamplerCommand*>(payload);
+                    c->pipeline->setSampler(c->slot, *c->sampler);
+                } break;
+                case CommandType::setSamplerNone: {
+                    auto c = reinterpret_cast<const SlotCommand*>(payload);
+                    c->pipeline->setSampler(c->slot);
+                } break;
+                case CommandType::setUniformBuffer: {
+                    auto c = reinterpret_cast<const BufferCommand*>(payload);
+                    if (c->size == wholeBuffer) c->pipeline->setUniformBuffer(c->slot, *c->buffer, c->offset);
+                    else                        c->pipeline->setUniformBuffer(c->slot, *c->buffer, c->offset, c->size);
+                } break;
+                case CommandType::setUniformBufferNone: {
+                    auto c = reinterpret_cast<const SlotCommand*>(payload);
+                    c->pipeline->setUniformBuffer(c->slot);
+                } break;
+                case CommandType::setAttributeBuffer: {
+                    auto c = reinterpret_cast<const BufferCommand*>(payload);
+                    static_cast<PipelineRasterization*>(c->pipeline)->setAttributeBuffer(c->slot, *c->buffer, c->offset);
+                } break;
+                case CommandType::setAttributeBufferNone: {
+                    auto c = reinterpret_cast<const SlotCommand*>(payload);
+                    static_cast<PipelineRasterization*>(c->pipeline)->setAttributeBuffer(c->slot);
+                } break;
+                case CommandType::setAttributeIndexBuffer: {
+                    auto c = reinterpret_cast<const IndexBufferCommand*>(payload);
+                    c->pipeline->setAttributeIndexBuffer(c->indexType, *c->buffer, c->offset);
+                } break;
+                case CommandType::setAttributeIndexBufferNone: {
+                    auto c = reinterpret_cast<const SlotCommand*>(payload);
+                    static_cast<PipelineRasterization*>(c->pipeline)->setAttributeIndexBuffer();
+                } break;
+                case CommandType::setUniform: {
+                    auto c = reinterpret_cast<const UniformHeader*>(payload);
+                    c->apply(c->uniformSetter, payload + sizeof(UniformHeader));
+                } break;
+                case CommandType::draw: {
+                    auto c = reinterpret_cast<const DrawCommand*>(payload);
+                    c->pipeline->draw(c->count, c->instanceCount, c->first, c->firstInstance);
+                } break;
+                case CommandType::drawIndexed: {
+                    auto c = reinterpret_cast<const DrawCommand*>(payload);
+                    c->pipeline->drawIndexed(c->count, c->instanceCount, c->first, c->vertexOffset, c->firstInstance);
+                } break;
+                case CommandType::drawIndirect: {
+                    auto c = reinterpret_cast<const DrawIndirectCommand*>(payload);
+                    c->pipeline->drawIndirect(*c->parameterBuffer, c->parameterBufferOffset, c->count, c->stride);
+                } break;
+                case CommandType::drawIndexedIndirect: {
+                    auto c = reinterpret_cast<const DrawIndirectCommand*>(payload);
+                    c->pipeline->drawIndexedIndirect(*c->parameterBuffer, c->parameterBufferOffset, c->count, c->stride);
+                } break;
+                case CommandType::dispatch: {
+                    auto c = reinterpret_cast<const DispatchCommand*>(payload);
+                    c->pipeline->dispatch(c->groupCount[0], c->groupCount[1], c->groupCount[2]);
+                } break;
+                case CommandType::dispatchIndirect: {
+                    auto c = reinterpret_cast<const DispatchIndirectCommand*>(payload);
+                    c->pipeline->dispatchIndirect(*c->buffer, c->offset);
+                } break;
+            }
+            p += header->size;
+        }
+    }
+
+    /**
+        \brief Removes all recorded commands but keeps the memory
+    */
+    void CommandList::clear() {
+        data.clear();
+        commandCount = 0;
+    }
+}
@@ -119,6 +119,8 @@ namespace glCompact {
             crash("glGetString(GL_VERSION) and/or glGetString(GL_SHADING_LANGUAGE_VERSION) returned 0! No active OpenGL 2.1+ context in this thread? Can not initalize without one!");
         version.versionString                = string(versionStringPtr);
         version.shadingLanguageVersionString = string(shadingLanguageVersionStringPtr);
+        const char* rendererStringPtr        = reinterpret_cast<const char*>(functions.glGetString(GL_RENDERER));
+        if (rendererStringPtr) version.rendererString = string(rendererStringPtr);
 
         bool glesOnly = version.versionString.find("OpenGL ES ") != string::npos;
 
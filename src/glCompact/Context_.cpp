@@ -6,8 +6,12 @@
 #include "glCompact/Debug.hpp"
 #include "glCompact/Frame.hpp"
 #include "glCompact/PipelineInterface.hpp"
+#include "glCompact/PipelineComputeMipmap_.hpp"
 #include "glCompact/multiMalloc.h"
 #include "glCompact/isDiffThenAssign.hpp"
+#include "glCompact/Statistics_.hpp"
+#include "glCompact/GpuTimer.hpp"
+#include "glCompact/minimumMaximum.hpp"
 
 #include <exception>
 #include <stdexcept>
@@ -57,6 +61,10 @@ namespace glCompact {
         };
         multiMallocPtr = multiMalloc(md, sizeof(md));
 
+        #ifdef GLCOMPACT_STATISTICS
+            statistics_glCallCount.resize(gl::functionCount);
+        #endif
+
         queryDisplayFramebufferFormat();
 
         contextId = nextContextId.fetch_add(1);
@@ -91,6 +99,11 @@ namespace glCompact {
     }
 
     Context_::~Context_() {
+        flushDrawBatch();
+        for (auto pipeline : pipelineComputeMipmap) delete pipeline;
+        if (drawBatchBufferId) threadContextGroup_->functions.glDeleteBuffers(1, &drawBatchBufferId);
+        vertexArrayBindDefault();
+        vertexArrayCacheClear();
         if (defaultVaoId) threadContextGroup_->functions.glDeleteVertexArrays(1, &defaultVaoId);
         threadContextGroup_->functions.glFinish(); //TODO: not sure if I need this here
         free(multiMallocPtr);
@@ -102,6 +115,7 @@ namespace glCompact {
 
     //TODO: maybe also use a bool that enables brute force setting all values to known, just in case any other libs fuck up?!
     void Context_::defaultStatesActivate() {
+        flushDrawBatch();
         threadContextGroup_->functions.glBindVertexArray(defaultVaoId);
         if (threadContextGroup_->extensions.GL_ARB_compatibility) {
             //TODO: set everything to default, or set the state tracker to all unknown for the default VAO states
@@ -115,6 +129,8 @@ namespace glCompact {
     }
 
     void Context_::defaultStatesDeactivate() {
+        flushDrawBatch();
+        vertexArrayBindDefault();
         if (threadContextGroup_->extensions.GL_ARB_compatibility) {
             //TODO: set all attribute values to default? Maybe just disable them?
         } else {
@@ -123,6 +139,8 @@ namespace glCompact {
 
         if (threadContextGroup_->extensions.GL_ARB_ES3_compatibility) threadContextGroup_->functions.glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
         cachedScissorEnabled(false);
+        cachedRasterizerDiscard(false);
+        stateChange.rasterizerDiscard = true;
 
         //we may have changed this values and therefore we set them back to default
         threadContextGroup_->functions.glBindBuffer (GL_PIXEL_PACK_BUFFER,   0);
@@ -166,7 +184,7 @@ namespace glCompact {
     }
 
     void Context_::forgetBufferId(uint32_t bufferId) {
-        LOOPI(buffer_attribute_getHighestIndexNonNull()) if (buffer_attribute_id[i] == bufferId) {
+        LOOPI(buffer_attribute_getHighestIndexNonNull() + 1) if (buffer_attribute_id[i] == bufferId) {
             buffer_attribute_id    [i] = 0;
             buffer_attribute_offset[i] = 0;
         }
@@ -194,6 +212,125 @@ namespace glCompact {
         if (buffer_copyWriteId          == bufferId) buffer_copyWriteId          = 0;
 
         if (boundArrayBuffer            == bufferId) boundArrayBuffer            = 0;
+
+        //glDeleteBuffers only detaches the buffer from the bound VAO, every other cached VAO that uses it would keep it alive
+        LOOPI(vertexArrayCache.size()) {
+            VertexArrayState& vertexArray = vertexArrayCache[i];
+            if (i == vertexArrayCurrent || !vertexArray.id) continue;
+            bool usesBuffer = vertexArray.buffer_attribute_index_id == bufferId;
+            LOOPJ(vertexArray.buffer_attribute_highestIndexNonNull + 1) usesBuffer |= vertexArray.buffer_attribute_id[j] == bufferId;
+            if (usesBuffer) {
+                threadContextGroup_->functions.glDeleteVertexArrays(1, &vertexArray.id);
+                vertexArray = VertexArrayState();
+            }
+        }
+    }
+
+    /*
+        VAO cache (setVertexArrayCache): Binds the VAO for attributeLayout. If there is none, the VAO of the least recently used layout is taken over
+        (or a new one is created while the cache is not full) and gets respecified by PipelineRasterization::processPendingChangesAttributeLayoutAndBuffers.
+        Returns true if a different VAO got bound, the caller then must check all its attribute buffers against the ones of this VAO.
+        indexHint is the cache index the caller found its VAO at the last time, it only saves the search if it still fits.
+
+        Only used with GL_ARB_vertex_attrib_binding, where the attribute formats and the attribute buffers of a VAO are independent of each other.
+        The lookup is linear, the cache is meant for a few dozen layouts at most.
+    */
+    bool Context_::cachedBindVertexArray(
+        const AttributeLayout_& attributeLayout,
+        int32_t&                indexHint
+    ) {
+        int32_t index     = -1;
+        bool    respecify = false;
+        if (indexHint >= 0 && indexHint < int32_t(vertexArrayCache.size()) && vertexArrayCache[indexHint].id && vertexArrayCache[indexHint].attributeLayout_ == attributeLayout) {
+            index = indexHint;
+        } else {
+            LOOPI(vertexArrayCache.size()) {
+                if (vertexArrayCache[i].id && vertexArrayCache[i].attributeLayout_ == attributeLayout) {
+                    index = i;
+                    break;
+                }
+            }
+        }
+        if (index < 0) {
+            respecify = true;
+            if (vertexArrayCache.size() < vertexArrayCacheSize) {
+                vertexArrayCache.emplace_back();
+                index = int32_t(vertexArrayCache.size()) - 1;
+            } else {
+                LOOPI(vertexArrayCache.size())
+                    if (index < 0 || vertexArrayCache[i].lastUse < vertexArrayCache[index].lastUse) index = i;
+            }
+        }
+        VertexArrayState& vertexArray = vertexArrayCache[index];
+        vertexArray.lastUse = ++vertexArrayUseCounter;
+        indexHint           = index;
+        //with a cache size of 1 the bound VAO also is the least recently used one, then it just gets respecified
+        if (index == vertexArrayCurrent) {
+            if (respecify) vertexArray.attributeLayout_ = attributeLayout;
+            countStateCheck(StatisticsCategory::vertexArray, false);
+            return false;
+        }
+        if (!vertexArray.id) threadContextGroup_->functions.glGenVertexArrays(1, &vertexArray.id);
+
+        if (vertexArrayCurrent < 0) {
+            //defaultVaoId is not used while the cache is enabled, so it must not keep buffers alive in the meantime
+            LOOPI(buffer_attribute_getHighestIndexNonNull() + 1) if (buffer_attribute_id[i]) {
+                threadContextGroup_->functions.glBindVertexBuffer(i, 0, 0, attributeLayout_.bufferIndexStride[i]);
+                buffer_attribute_id    [i] = 0;
+                buffer_attribute_offset[i] = 0;
+            }
+            cachedBindIndexBuffer(0);
+        }
+        countStateCheck(StatisticsCategory::vertexArray, true);
+        vertexArrayStateSwap(index);
+        //the tracked layout now is the one the VAO still has, processPendingChangesAttributeLayoutAndBuffers() respecifies it right after this
+        if (respecify) vertexArray.attributeLayout_ = attributeLayout;
+        threadContextGroup_->functions.glBindVertexArray(vertexArray.id);
+        return true;
+    }
+
+    //Binds defaultVaoId again, e.g. before the cache gets cleared or an external library takes over
+    void Context_::vertexArrayBindDefault() {
+        if (vertexArrayCurrent < 0) return;
+        flushDrawBatch();
+        vertexArrayStateSwap(-1);
+        threadContextGroup_->functions.glBindVertexArray(defaultVaoId);
+    }
+
+    //Deletes all cached VAOs, must not be called while one of them is bound
+    void Context_::vertexArrayCacheClear() {
+        for (auto& vertexArray : vertexArrayCache)
+            if (vertexArray.id) threadContextGroup_->functions.glDeleteVertexArrays(1, &vertexArray.id);
+        vertexArrayCache.clear();
+    }
+
+    /*
+        Stores the tracked attribute states into the state of the bound VAO and loads the ones of the VAO at index (-1 for defaultVaoId).
+        The attribute layout of a cached VAO always is the one it got bound for, so only the one of defaultVaoId must be stored.
+    */
+    void Context_::vertexArrayStateSwap(
+        int32_t index
+    ) {
+        VertexArrayState& from = vertexArrayCurrent >= 0 ? vertexArrayCache[vertexArrayCurrent] : vertexArrayDefault;
+        VertexArrayState& to   = index              >= 0 ? vertexArrayCache[index]              : vertexArrayDefault;
+        if (vertexArrayCurrent < 0) from.attributeLayout_ = attributeLayout_;
+        attributeLayout_ = to.attributeLayout_;
+        //all slots above buffer_attribute_highestIndexNonNull are 0, so only the lower ones must be copied
+        const int32_t currentSlotCount = buffer_attribute_getHighestIndexNonNull() + 1;
+        LOOPI(maximum(currentSlotCount, from.buffer_attribute_highestIndexNonNull + 1)) {
+            from.buffer_attribute_id    [i] = buffer_attribute_id    [i];
+            from.buffer_attribute_offset[i] = buffer_attribute_offset[i];
+        }
+        LOOPI(maximum(currentSlotCount, to.buffer_attribute_highestIndexNonNull + 1)) {
+            buffer_attribute_id         [i] = to.buffer_attribute_id    [i];
+            buffer_attribute_offset     [i] = to.buffer_attribute_offset[i];
+        }
+        from.buffer_attribute_highestIndexNonNull = currentSlotCount - 1;
+        buffer_attribute_highestIndexNonNull      = to.buffer_attribute_highestIndexNonNull;
+        from.buffer_attribute_index_id            = buffer_attribute_index_id;
+        buffer_attribute_index_id                 = to.buffer_attribute_index_id;
+        attributeLayoutMaybeChanged               = true;
+        vertexArrayCurrent                        = index;
     }
 
     /**
@@ -217,7 +354,7 @@ namespace glCompact {
         bool     textureChange   = texId     != texIdOld;
         bool     unbindOldTarget = targetChange  && texIdOld;
         bool     bindNewTexture  = textureChange && texId;
-        if (unbindOldTarget || bindNewTexture) {
+        if (countStateCheck(StatisticsCategory::texture, unbindOldTarget || bindNewTexture)) {
             cachedSetActiveTextureUnit(texSlot);
             if (pipeline) pipeline->texture_markSlotChange(texSlot);
         }
@@ -236,7 +373,7 @@ namespace glCompact {
         uint32_t texId
     ) {
         if (threadContextGroup_->extensions.GL_ARB_multi_bind) {
-            if (texture_id[texSlot] != texId) {
+            if (countStateCheck(StatisticsCategory::texture, texture_id[texSlot] != texId)) {
                 texture_id[texSlot] = texId;
                 if (pipeline) pipeline->texture_markSlotChange(texSlot);
                 threadContextGroup_->functions.glBindTextures(texSlot, 1, &texId);
@@ -249,7 +386,9 @@ namespace glCompact {
     void Context_::cachedBindShader(
         uint32_t pipelineShaderId
     ) {
-        if (isDiffThenAssign(this->pipelineShaderId, pipelineShaderId)) {
+        UNLIKELY_IF (transformFeedbackCapturing && this->pipelineShaderId != pipelineShaderId)
+            throw runtime_error("Can not use another pipeline while TransformFeedback is capturing, pause() it first!");
+        if (countStateCheck(StatisticsCategory::shader, isDiffThenAssign(this->pipelineShaderId, pipelineShaderId))) {
             threadContextGroup_->functions.glUseProgram(pipelineShaderId);
         }
     }
@@ -257,7 +396,7 @@ namespace glCompact {
     void Context_::cachedBindArrayBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(boundArrayBuffer, bufferId)) {
+        if (countStateCheck(StatisticsCategory::attributeBuffer, isDiffThenAssign(boundArrayBuffer, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_ARRAY_BUFFER, bufferId);
         }
     }
@@ -265,7 +404,7 @@ namespace glCompact {
     void Context_::cachedBindIndexBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_attribute_index_id, bufferId)) {
+        if (countStateCheck(StatisticsCategory::indexBuffer, isDiffThenAssign(buffer_attribute_index_id, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferId);
         }
     }
@@ -277,7 +416,7 @@ namespace glCompact {
         //TODO: debug test for values over GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS-1
         UNLIKELY_IF (slot >= uint32_t(threadContextGroup_->values.GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS))
             throw runtime_error("Trying to set active texture bayond GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS(" + to_string(threadContextGroup_->values.GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS) + ")");
-        if (isDiffThenAssign(activeTextureSlot, slot)) {
+        if (countStateCheck(StatisticsCategory::texture, isDiffThenAssign(activeTextureSlot, slot))) {
             threadContextGroup_->functions.glActiveTexture(GL_TEXTURE0 + slot);
         }
     }
@@ -285,7 +424,7 @@ namespace glCompact {
     void Context_::cachedBindDrawFbo(
         uint32_t fboId
     ) {
-        if (isDiffThenAssign(current_frame_drawId, fboId)) {
+        if (countStateCheck(StatisticsCategory::frame, isDiffThenAssign(current_frame_drawId, fboId))) {
             threadContextGroup_->functions.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
         }
     }
@@ -293,13 +432,13 @@ namespace glCompact {
     void Context_::cachedBindReadFbo(
         uint32_t fboId
     ) {
-        if (isDiffThenAssign(current_frame_readId, fboId)) {
+        if (countStateCheck(StatisticsCategory::frame, isDiffThenAssign(current_frame_readId, fboId))) {
             threadContextGroup_->functions.glBindFramebuffer(GL_READ_FRAMEBUFFER, fboId);
         }
     }
 
     void Context_::cachedSrgbTargetsReadWriteLinear(bool value) {
-        if (isDiffThenAssign(current_srgbTargetsReadWriteLinear, value)) {
+        if (countStateCheck(StatisticsCategory::frame, isDiffThenAssign(current_srgbTargetsReadWriteLinear, value))) {
             setGlState(GL_FRAMEBUFFER_SRGB, value);
         }
     }
@@ -308,18 +447,28 @@ namespace glCompact {
         glm::uvec2 offset,
         glm::uvec2 size
     ) {
-        if (isDiffThenAssign(
+        if (countStateCheck(StatisticsCategory::viewportScissor, isDiffThenAssign(
             current_viewportOffset, offset,
             current_viewportSize,   size
-        )) {
+        ))) {
             threadContextGroup_->functions.glViewport(offset.x, offset.y, size.x, size.y);
         }
     }
 
+    //GL_RASTERIZER_DISCARD also discards clears, so Frame clears disable it.
+    //Pipelines only apply their setting when stateChange.rasterizerDiscard is set, so everything else changing it must set that flag, too.
+    void Context_::cachedRasterizerDiscard(
+        bool enabled
+    ) {
+        if (countStateCheck(StatisticsCategory::rasterizerDiscard, isDiffThenAssign(rasterizerDiscard, enabled))) {
+            setGlState(GL_RASTERIZER_DISCARD, enabled);
+        }
+    }
+
     void Context_::cachedScissorEnabled(
         bool enabled
     ) {
-        if (isDiffThenAssign(current_scissor_enabled, enabled)) {
+        if (countStateCheck(StatisticsCategory::viewportScissor, isDiffThenAssign(current_scissor_enabled, enabled))) {
             setGlState(GL_SCISSOR_TEST, enabled);
         }
     }
@@ -328,10 +477,10 @@ namespace glCompact {
         glm::uvec2 offset,
         glm::uvec2 size
     ) {
-        if (isDiffThenAssign(
+        if (countStateCheck(StatisticsCategory::viewportScissor, isDiffThenAssign(
             current_scissorOffset, offset,
             current_scissorSize,   size
-        )) {
+        ))) {
             threadContextGroup_->functions.glScissor(offset.x, offset.y, size.x, size.y);
         }
     }
@@ -339,7 +488,7 @@ namespace glCompact {
     void Context_::cachedBindPixelPackBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_pixelPackId, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_pixelPackId, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_PIXEL_PACK_BUFFER, bufferId);
         }
     }
@@ -347,7 +496,7 @@ namespace glCompact {
     void Context_::cachedBindPixelUnpackBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_pixelUnpackId, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_pixelUnpackId, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, bufferId);
         }
     }
@@ -355,7 +504,7 @@ namespace glCompact {
     void Context_::cachedBindCopyReadBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_copyReadId, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_copyReadId, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_COPY_READ_BUFFER, bufferId);
         }
     }
@@ -363,7 +512,7 @@ namespace glCompact {
     void Context_::cachedBindCopyWriteBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_copyWriteId, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_copyWriteId, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
         }
     }
@@ -373,15 +522,68 @@ namespace glCompact {
     void Context_::cachedBindDrawIndirectBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_draw_indirect_id, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_draw_indirect_id, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer_draw_indirect_id);
         }
     }
 
+    /*
+        Submits the draws collected by PipelineRasterization::draw/drawIndexed while draw batching is enabled.
+        The GL state is still the one of the batch pipeline, because every function that changes it or emits other commands flushes first.
+
+        A single draw is submitted directly, everything else gets written into an internal indirect buffer and submitted via one glMultiDraw*Indirect.
+        The buffer is used like a ring and orphaned when it runs full, so we never wait for the GPU to finish reading older batches.
+    */
+    void Context_::submitDrawBatch() {
+        const uint32_t  count   = drawBatchCount;
+        const uint32_t* command = drawBatchCommand.data();
+        drawBatchCount    = 0;
+        drawBatchPipeline = nullptr;
+
+        if (count == 1) {
+            if (drawBatchIndexed) {
+                const uintptr_t indexBufferByteOffset = uintptr_t(command[2]) * (drawBatchIndexType == GL_UNSIGNED_SHORT ? 2 : 4);
+                if (command[4]) {
+                    threadContextGroup_->functions.glDrawElementsInstancedBaseVertexBaseInstance(drawBatchPrimitive, command[0], drawBatchIndexType, reinterpret_cast<const void*>(indexBufferByteOffset), command[1], int32_t(command[3]), command[4]);
+                } else {
+                    threadContextGroup_->functions.glDrawElementsInstancedBaseVertex            (drawBatchPrimitive, command[0], drawBatchIndexType, reinterpret_cast<const void*>(indexBufferByteOffset), command[1], int32_t(command[3]));
+                }
+            } else {
+                if (command[3]) {
+                    threadContextGroup_->functions.glDrawArraysInstancedBaseInstance(drawBatchPrimitive, command[2], command[0], command[1], command[3]);
+                } else {
+                    threadContextGroup_->functions.glDrawArraysInstanced            (drawBatchPrimitive, command[2], command[0], command[1]);
+                }
+            }
+        } else {
+            const uint32_t byteSize = uint32_t(drawBatchCommand.size() * sizeof(uint32_t));
+            if (!drawBatchBufferId) {
+                threadContextGroup_->functions.glGenBuffers(1, &drawBatchBufferId);
+                cachedBindDrawIndirectBuffer(drawBatchBufferId);
+                threadContextGroup_->functions.glBufferData(GL_DRAW_INDIRECT_BUFFER, drawBatchBufferSize, nullptr, GL_STREAM_DRAW);
+                drawBatchBufferOffset = 0;
+            } else {
+                cachedBindDrawIndirectBuffer(drawBatchBufferId);
+                if (drawBatchBufferOffset + byteSize > drawBatchBufferSize) {
+                    threadContextGroup_->functions.glBufferData(GL_DRAW_INDIRECT_BUFFER, drawBatchBufferSize, nullptr, GL_STREAM_DRAW);
+                    drawBatchBufferOffset = 0;
+                }
+            }
+            threadContextGroup_->functions.glBufferSubData(GL_DRAW_INDIRECT_BUFFER, drawBatchBufferOffset, byteSize, command);
+            if (drawBatchIndexed) {
+                threadContextGroup_->functions.glMultiDrawElementsIndirect(drawBatchPrimitive, drawBatchIndexType, reinterpret_cast<const void*>(uintptr_t(drawBatchBufferOffset)), count, 0);
+            } else {
+                threadContextGroup_->functions.glMultiDrawArraysIndirect  (drawBatchPrimitive,                     reinterpret_cast<const void*>(uintptr_t(drawBatchBufferOffset)), count, 0);
+            }
+            drawBatchBufferOffset += byteSize;
+        }
+        drawBatchCommand.clear();
+    }
+
     void Context_::cachedBindDispatchIndirectBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_dispatch_indirect_id, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_dispatch_indirect_id, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer_dispatch_indirect_id);
         }
     }
@@ -390,11 +592,22 @@ namespace glCompact {
     void Context_::cachedBindParameterBuffer(
         uint32_t bufferId
     ) {
-        if (isDiffThenAssign(buffer_parameter_id, bufferId)) {
+        if (countStateCheck(StatisticsCategory::bufferTarget, isDiffThenAssign(buffer_parameter_id, bufferId))) {
             threadContextGroup_->functions.glBindBuffer(GL_PARAMETER_BUFFER, buffer_parameter_id);
         }
     }
 
+    /*
+        Ends the running GpuTimer of the previous draw frame and starts the one of the new draw frame
+    */
+    void Context_::switchFrameGpuTimer(
+        GpuTimer* gpuTimer
+    ) {
+        if (frameGpuTimer && frameGpuTimer->isRunning()) frameGpuTimer->end();
+        frameGpuTimer = gpuTimer;
+        if (frameGpuTimer) frameGpuTimer->begin();
+    }
+
     void Context_::setGlState(uint32_t state, bool enable) {
         if (enable) {
             threadContextGroup_->functions.glEnable(state);
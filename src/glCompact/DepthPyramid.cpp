@@ -0,0 +1,75 @@
+#include "glCompact/DepthPyramid.hpp"
+#include "glCompact/Frame.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::DepthPyramid
+
+        \brief Hierarchical-Z pyramid of the depth attachment of a Frame, for occlusion culling in shaders
+
+        \details build() copies the depth values of a Frame into mipmap level 0 of an R32_SFLOAT Texture2d and then reduces all further levels
+        with TextureInterface::generateMipmapsViaPipelineCompute(). With MipmapFilter::max every texel of a level holds the farthest depth of the area it covers,
+        so an object whose nearest depth is behind that value is occluded. Use MipmapFilter::min for a reversed depth range (GL_GREATER depth test).
+        Texels at the border of odd sized levels include the extra row/column, so the pyramid always stays conservative.
+
+        The depth copy goes through a BufferGpu (like Frame::copyConvertDepthToBuffer), so it does not wait for the GPU and works with any depth attachment,
+        including the one of the display frame. The texture gets (re)created whenever the frame size changes.
+
+        \code{.cpp}
+            DepthPyramid depthPyramid;
+            //after the depth pre pass or with the depth of the last frame
+            depthPyramid.build(getDisplayFrame());
+            cullPipeline.setTexture(0, depthPyramid.getTexture(), nearestSampler); //sample with textureLod(), texelFetch() or a nearest filtering sampler
+        \endcode
+
+        The read back depth values are in window space (0..1 by default).
+
+        Depends on pipelineCompute (GL_ARB_compute_shader, Core since 4.3) and image load/store of R32_SFLOAT.
+    */
+    DepthPyramid::DepthPyramid(
+        MipmapFilter mipmapFilter
+    ) :
+        mipmapFilter(mipmapFilter)
+    {
+        UNLIKELY_IF (mipmapFilter != MipmapFilter::min && mipmapFilter != MipmapFilter::max)
+            throw runtime_error("DepthPyramid only supports MipmapFilter::min and MipmapFilter::max!");
+    }
+
+    /**
+        \brief Copies the depth values of frame into level 0 and rebuilds all further levels
+    */
+    void DepthPyramid::build(
+        Frame& frame
+    ) {
+        UNLIKELY_IF (!threadContextGroup_->feature.pipelineCompute)
+            throw runtime_error("DepthPyramid needs pipelineCompute!");
+        const glm::uvec2 frameSize = glm::uvec2(frame.getSize());
+        UNLIKELY_IF (frameSize.x == 0 || frameSize.y == 0)
+            throw runtime_error("DepthPyramid can not be build from a Frame without size!");
+
+        const uintptr_t depthBufferSize = uintptr_t(frameSize.x) * uintptr_t(frameSize.y) * sizeof(float);
+        if (getSize() != frameSize) texture = Texture2d(SurfaceFormat::R32_SFLOAT, frameSize.x, frameSize.y, true);
+        if (depthBuffer.getSize() < depthBufferSize) depthBuffer = BufferGpu(false, depthBufferSize);
+
+        const glm::ivec2 size = glm::ivec2(frameSize);
+        frame.copyConvertDepthToBuffer(depthBuffer, 0, depthBufferSize, MemorySurfaceFormat::D32_SFLOAT, {0, 0}, size);
+        texture.copyConvertFromBuffer(depthBuffer, 0, uint32_t(depthBufferSize), MemorySurfaceFormat::R32_SFLOAT, 0, {0, 0, 0}, {size.x, size.y, 1});
+        if (getMipmapCount() > 1) texture.generateMipmapsViaPipelineCompute(mipmapFilter);
+    }
+
+    /**
+        \brief Frees the texture and the depth copy buffer
+    */
+    void DepthPyramid::free() {
+        texture.free();
+        depthBuffer.free();
+    }
+}
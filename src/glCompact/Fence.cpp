@@ -1,4 +1,6 @@
 #include "glCompact/Fence.hpp"
+#include "glCompact/Context_.hpp"
+#include "glCompact/threadContext_.hpp"
 #include "glCompact/ContextGroup_.hpp"
 #include "glCompact/threadContextGroup_.hpp"
 #include "glCompact/Tools_.hpp"
@@ -35,6 +37,7 @@ namespace glCompact {
     }
 
     void Fence::insert() {
+        threadContext_->flushDrawBatch();
         free();
         fenceObj = threadContextGroup_->functions.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     }
@@ -92,6 +95,7 @@ namespace glCompact {
             OpenGL/OpenCL will make sure that the GL/CL commands from thread2 won't actually be issued until the sync object is reached.
     */
     void Fence::isSignaledOrStallCommandStream() {
+        threadContext_->flushDrawBatch();
         threadContextGroup_->functions.glWaitSync(fenceObj, 0, GL_TIMEOUT_IGNORED);
     }
 }
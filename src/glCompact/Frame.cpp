@@ -8,6 +8,7 @@
 #include "glCompact/SurfaceFormatDetail.hpp"
 #include "glCompact/MemorySurfaceFormatDetail.hpp"
 #include "glCompact/minimumMaximum.hpp"
+#include "glCompact/GpuTimer.hpp"
 
 #include <glm/glm.hpp>
 
@@ -335,8 +336,10 @@ namespace glCompact {
         depthAndOrStencilSurfaceFormat = frame.depthAndOrStencilSurfaceFormat;
         LOOPI(config::MAX_RGBA_ATTACHMENTS)
             rgbaSurfaceFormat[i]       = frame.rgbaSurfaceFormat[i];
+        gpuTimer                       = frame.gpuTimer;
 
-        frame.id = 0;
+        frame.id       = 0;
+        frame.gpuTimer = nullptr;
     }
 
     Frame& Frame::operator=(
@@ -357,9 +360,11 @@ namespace glCompact {
         depthAndOrStencilSurfaceFormat = frame.depthAndOrStencilSurfaceFormat;
         LOOPI(config::MAX_RGBA_ATTACHMENTS)
             rgbaSurfaceFormat[i]       = frame.rgbaSurfaceFormat[i];
+        gpuTimer                       = frame.gpuTimer;
 
         frame.detachPtrFromThreadContextState();
-        frame.id = 0;
+        frame.id       = 0;
+        frame.gpuTimer = nullptr;
         return *this;
     }
 
@@ -369,6 +374,7 @@ namespace glCompact {
 
     void Frame::free() {
         if (!id) return;
+        threadContext_->flushDrawBatch();
         detachFromThreadContextState();
         threadContextGroup_->functions.glDeleteFramebuffers(1, &id);
         setDefaultValues();
@@ -396,6 +402,20 @@ namespace glCompact {
         threadContext_->stateChange.viewportScissor = true;
     }
 
+    /**
+        \brief Attach a GpuTimer to this frame, or detach it with nullptr
+
+        \details The timer is running from setDrawFrame() with this frame until the next setDrawFrame() call, also if that sets this frame again.
+        So each setDrawFrame() with this frame starts a new measurement of the GpuTimer. The GpuTimer must outlive the time it is attached to the frame.
+    */
+    void Frame::setGpuTimer(
+        GpuTimer* gpuTimer
+    ) {
+        threadContext_->flushDrawBatch();
+        this->gpuTimer = gpuTimer;
+        if (threadContext_->pending_frame == this) threadContext_->switchFrameGpuTimer(gpuTimer);
+    }
+
     /**
         Use size of the Frame as viewport!
         This is used by default!
@@ -534,6 +554,7 @@ namespace glCompact {
         glm::ivec2 dstSize,
         bool       filterLinear
     ) {
+        threadContext_->flushDrawBatch();
         GLuint srcFboId = this->id;
         GLenum filter = filterLinear ? GL_LINEAR : GL_NEAREST;
 
@@ -643,7 +664,10 @@ namespace glCompact {
         uint32_t  slot,
         glm::vec4 rgba
     ) {
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesDrawFrame(this);
+        threadContext_->cachedRasterizerDiscard(false);
+        threadContext_->stateChange.rasterizerDiscard = true;
 
       //if (threadContext->extensions.GL_ARB_direct_state_access) {
       //    threadContextGroup_->functions.glClearNamedFramebufferfv(id, GL_COLOR, slot, &rgba[0]);
@@ -662,7 +686,10 @@ namespace glCompact {
         uint32_t   slot,
         glm::uvec4 rgba
     ) {
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesDrawFrame(this);
+        threadContext_->cachedRasterizerDiscard(false);
+        threadContext_->stateChange.rasterizerDiscard = true;
       //if (threadContext->extensions.GL_ARB_direct_state_access) {
       //    threadContextGroup_->functions.glClearNamedFramebufferuiv(id, GL_COLOR, slot, &rgba[0]);
       //} else {
@@ -674,7 +701,10 @@ namespace glCompact {
         uint32_t   slot,
         glm::ivec4 rgba
     ) {
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesDrawFrame(this);
+        threadContext_->cachedRasterizerDiscard(false);
+        threadContext_->stateChange.rasterizerDiscard = true;
       //if (threadContext->extensions.GL_ARB_direct_state_access) {
       //    threadContextGroup_->functions.glClearNamedFramebufferiv(id, GL_COLOR, slot, &rgba[0]);
       //} else {
@@ -688,7 +718,10 @@ namespace glCompact {
     void Frame::clearDepth(
         float depth
     ) {
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesDrawFrame(this);
+        threadContext_->cachedRasterizerDiscard(false);
+        threadContext_->stateChange.rasterizerDiscard = true;
 
       //if (threadContext->extensions.GL_ARB_direct_state_access) {
       //    threadContextGroup_->functions.glClearNamedFramebufferfv(id, GL_DEPTH, 0, &depth);
@@ -700,7 +733,10 @@ namespace glCompact {
     void Frame::clearStencil(
         uint32_t stencil
     ) {
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesDrawFrame(this);
+        threadContext_->cachedRasterizerDiscard(false);
+        threadContext_->stateChange.rasterizerDiscard = true;
 
       //if (threadContext->extensions.GL_ARB_direct_state_access) {
       //    threadContextGroup_->functions.glClearNamedFramebufferuiv(id, GL_STENCIL, 0, &stencil);
@@ -716,7 +752,10 @@ namespace glCompact {
         float    depth,
         uint32_t stencil
     ) {
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesDrawFrame(this);
+        threadContext_->cachedRasterizerDiscard(false);
+        threadContext_->stateChange.rasterizerDiscard = true;
 
       //if (threadContext->extensions.GL_ARB_direct_state_access) {
       //    threadContextGroup_->functions.glClearNamedFramebufferfi(id, GL_DEPTH_STENCIL, 0, depth, stencil);
@@ -748,6 +787,7 @@ namespace glCompact {
     void Frame::invalidate(
         GLenum attachment
     ) {
+        threadContext_->flushDrawBatch();
         if (!id) return;
         if (threadContextGroup_->extensions.GL_ARB_direct_state_access) {
             threadContextGroup_->functions.glInvalidateNamedFramebufferData(id, 1, &attachment);
@@ -903,6 +943,7 @@ namespace glCompact {
         SurfaceSelector sel,
         GLenum          attachmentType
     ) {
+        threadContext_->flushDrawBatch();
         bool   isTexture        = sel.surface->target != GL_RENDERBUFFER;
         bool   isLayerSelection = sel.layer != -1;
         int    layer            = sel.layer;
@@ -1020,6 +1061,7 @@ namespace glCompact {
         glm::ivec2          offset,
         glm::ivec2          size
     ) {
+        threadContext_->flushDrawBatch();
         if (isRgba) {
             UNLIKELY_IF (isDisplayFrame() && rgbaSlot > 0)
                 throw std::runtime_error("Trying to select rgbaSlot(" + to_string(rgbaSlot) + "), but the Display Frame only has RGBA slot 0");
@@ -1033,7 +1075,7 @@ namespace glCompact {
                 throw std::runtime_error("Trying to copyConvert depth value from Frame that has no depth attachment");
             } else UNLIKELY_IF (!isDepth && isStencil && !depthAndOrStencilSurfaceFormat.detail().isStencil) {
                 throw std::runtime_error("Trying to copyConvert stencil value from Frame that has no stencil attachment");
-            } else UNLIKELY_IF (                         !(depthAndOrStencilSurfaceFormat.detail().isDepth && depthAndOrStencilSurfaceFormat.detail().isStencil)) {
+            } else UNLIKELY_IF ( isDepth &&  isStencil && !(depthAndOrStencilSurfaceFormat.detail().isDepth && depthAndOrStencilSurfaceFormat.detail().isStencil)) {
                 throw std::runtime_error("Trying to copyConvert depthStencil value from Frame that has no depthStencil attachment");
             }
             depthAndOrStencilSurfaceFormat.throwIfNotCopyConvertibleToThisMemorySurfaceFormat(memorySurfaceFormat);
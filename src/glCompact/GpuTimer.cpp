@@ -0,0 +1,163 @@
+#include "glCompact/GpuTimer.hpp"
+#include "glCompact/Context_.hpp"
+#include "glCompact/threadContext_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+
+/*
+    GL_ARB_timer_query (Core since 3.3)
+        void glQueryCounter(GLuint id, GLenum target);
+        void glGetQueryObjecti64v (GLuint id, GLenum pname, GLint64*  params);
+        void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+
+    GL_TIME_ELAPSED queries can not be nested or overlap, only one can be active per context at a time.
+    That is why this uses two GL_TIMESTAMP queries per measurement instead. Any amount of GpuTimer can be running at the same time.
+
+    GLES only has GL_EXT_disjoint_timer_query, not supported (yet).
+*/
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::GpuTimer
+
+        \brief Measures the GPU time of a range of commands without stalling CPU or GPU
+
+        \details Every begin()/end() pair inserts two timestamp queries into the command stream. The results are collected later, when the GPU did execute them.
+        Only query results that are already available get read back, so none of the functions ever waits on the GPU.
+
+        The query objects are kept in a ring, so the timer can be used every frame and the results come in some frames later.
+        If all slots in the ring are still pending when begin() is called, the ring grows by one slot instead of waiting.
+        ringSize should be the amount of frames the GPU can lag behind the CPU plus one.
+
+            GpuTimer shadowPassTimer;
+            ...
+            {
+                GpuTimer::Scope scope(shadowPassTimer);
+                //shadow pass commands
+            }
+            if (shadowPassTimer.hasResult()) cout << shadowPassTimer.getResult() << "ns" << endl;
+
+        A GpuTimer can also be attached to a Frame (Frame::setGpuTimer) or PipelineCompute (PipelineCompute::setGpuTimer).
+
+        Needs GL_ARB_timer_query (Core since 3.3)
+    */
+    GpuTimer::GpuTimer(
+        uint32_t ringSize
+    ) {
+        slot.resize(ringSize ? ringSize : 1);
+    }
+
+    GpuTimer::~GpuTimer() {
+        free();
+    }
+
+    void GpuTimer::free() {
+        if (threadContext_ && threadContext_->frameGpuTimer == this) threadContext_->frameGpuTimer = nullptr;
+        for (auto& s : slot) {
+            if (s.queryId[0]) {
+                UNLIKELY_IF (!threadContextGroup_) crash("glCompact::GpuTimer destructor called but thread has no reference to threadContextGroup_! Leaking OpenGL object!");
+                threadContextGroup_->functions.glDeleteQueries(2, s.queryId);
+            }
+            s = Slot();
+        }
+        nextSlot       = 0;
+        runningSlot    = 0;
+        running        = false;
+        resultSequence = 0;
+        result         = 0;
+        resultCount    = 0;
+    }
+
+    /**
+        \brief Starts a measurement. Inserts a timestamp query into the command stream.
+    */
+    void GpuTimer::begin() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!threadContextGroup_->extensions.GL_ARB_timer_query)
+            throw runtime_error("missing support for GL_ARB_timer_query (Core since 3.3)!");
+        UNLIKELY_IF (running)
+            throw runtime_error("GpuTimer::begin() called on running GpuTimer!");
+        resolve();
+
+        uint32_t slotCount = uint32_t(slot.size());
+        uint32_t i = 0;
+        while (i < slotCount && slot[(nextSlot + i) % slotCount].pending) ++i;
+        if (i == slotCount) {
+            slot.emplace_back();
+            runningSlot = slotCount;
+        } else {
+            runningSlot = (nextSlot + i) % slotCount;
+        }
+        nextSlot = (runningSlot + 1) % uint32_t(slot.size());
+
+        Slot& s = slot[runningSlot];
+        if (!s.queryId[0]) threadContextGroup_->functions.glGenQueries(2, s.queryId);
+        threadContextGroup_->functions.glQueryCounter(s.queryId[0], GL_TIMESTAMP);
+        running = true;
+    }
+
+    /**
+        \brief Ends the measurement started with begin(). Inserts a timestamp query into the command stream.
+    */
+    void GpuTimer::end() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!running)
+            throw runtime_error("GpuTimer::end() called without GpuTimer::begin()!");
+        Slot& s = slot[runningSlot];
+        threadContextGroup_->functions.glQueryCounter(s.queryId[1], GL_TIMESTAMP);
+        s.sequence = nextSequence++;
+        s.pending  = true;
+        running    = false;
+    }
+
+    /**
+        \brief Returns true if at last one measurement got resolved. Does not wait for the GPU.
+    */
+    bool GpuTimer::hasResult() {
+        resolve();
+        return resultCount != 0;
+    }
+
+    /**
+        \brief Returns the GPU time in nanoseconds of the latest resolved measurement, or 0 if there is none yet. Does not wait for the GPU.
+    */
+    uint64_t GpuTimer::getResult() {
+        resolve();
+        return result;
+    }
+
+    /**
+        \brief Amount of measurements that are issued but not resolved yet
+    */
+    uint32_t GpuTimer::getPendingCount() const {
+        uint32_t count = 0;
+        for (auto& s : slot) if (s.pending) count++;
+        return count;
+    }
+
+    void GpuTimer::resolve() {
+        for (auto& s : slot) {
+            if (!s.pending) continue;
+            //The end timestamp is issued after the begin timestamp, if it is available so is the begin timestamp.
+            int32_t available = 0;
+            threadContextGroup_->functions.glGetQueryObjectiv(s.queryId[1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+            uint64_t timestamp[2] = {};
+            threadContextGroup_->functions.glGetQueryObjectui64v(s.queryId[0], GL_QUERY_RESULT, &timestamp[0]);
+            threadContextGroup_->functions.glGetQueryObjectui64v(s.queryId[1], GL_QUERY_RESULT, &timestamp[1]);
+            s.pending = false;
+            resultCount++;
+            if (s.sequence > resultSequence) {
+                resultSequence = s.sequence;
+                result         = timestamp[1] >= timestamp[0] ? timestamp[1] - timestamp[0] : 0;
+            }
+        }
+    }
+}
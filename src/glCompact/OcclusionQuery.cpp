@@ -0,0 +1,200 @@
+#include "glCompact/OcclusionQuery.hpp"
+#include "glCompact/Context_.hpp"
+#include "glCompact/threadContext_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+
+/*
+    Occlusion queries (Core since 1.5)
+        GL_ANY_SAMPLES_PASSED              GL_ARB_occlusion_query2  (Core since 3.3)
+        GL_ANY_SAMPLES_PASSED_CONSERVATIVE GL_ARB_ES3_compatibility (Core since 4.3)
+
+    All occlusion query targets share one slot per context, only one of them can be active at a time.
+    Conditional rendering (Core since 3.0) only affects draws, clears and blits. Not compute dispatches or copies.
+*/
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::OcclusionQuery
+
+        \brief Counts the samples of the draws between begin() and end() that pass the depth and stencil test, without stalling CPU or GPU
+
+        \details Like GpuTimer the query objects are kept in a ring, so the query can be used every frame and the results come in some frames later.
+        hasResult() and getResult() never wait. waitResult() waits for the latest ended query.
+
+        To skip draws without a CPU round trip, use the query as condition for conditional rendering:
+
+            OcclusionQuery occlusionQuery;
+            {
+                OcclusionQuery::Scope scope(occlusionQuery);
+                boundingBoxPipeline.draw(...); //with color and depth writes disabled
+            }
+            {
+                ConditionalRenderScope condition(occlusionQuery, ConditionalRenderMode::noWait);
+                expensivePipeline.draw(...);
+            }
+
+        For OcclusionQueryType::anySamplesPassed and anySamplesPassedConservative the result is 1 or 0.
+    */
+    OcclusionQuery::OcclusionQuery(
+        OcclusionQueryType occlusionQueryType,
+        uint32_t           ringSize
+    ) :
+        occlusionQueryType(occlusionQueryType)
+    {
+        slot.resize(ringSize ? ringSize : 1);
+    }
+
+    OcclusionQuery::~OcclusionQuery() {
+        free();
+    }
+
+    void OcclusionQuery::free() {
+        bool hasQueryId = false;
+        for (auto& s : slot) hasQueryId |= s.queryId != 0;
+        if (!hasQueryId) return;
+        UNLIKELY_IF (!threadContextGroup_) crash("glCompact::OcclusionQuery destructor called but thread has no reference to threadContextGroup_! Leaking OpenGL object!");
+        if (threadContext_) {
+            if (threadContext_->conditionalRenderOcclusionQuery == this) setCondition();
+            if (running) {
+                threadContext_->flushDrawBatch();
+                threadContextGroup_->functions.glEndQuery(static_cast<GLenum>(occlusionQueryType));
+                threadContext_->runningOcclusionQuery = nullptr;
+            }
+        }
+        for (auto& s : slot) {
+            if (s.queryId) threadContextGroup_->functions.glDeleteQueries(1, &s.queryId);
+            s = Slot();
+        }
+        nextSlot       = 0;
+        runningSlot    = 0;
+        lastEndedSlot  = -1;
+        running        = false;
+        resultSequence = 0;
+        result         = 0;
+        resultCount    = 0;
+    }
+
+    /**
+        \brief Starts counting samples of all following draws. Only one OcclusionQuery can be running at a time.
+    */
+    void OcclusionQuery::begin() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (occlusionQueryType == OcclusionQueryType::anySamplesPassed && !threadContextGroup_->extensions.GL_ARB_occlusion_query2)
+            throw runtime_error("missing support for GL_ARB_occlusion_query2 (Core since 3.3)!");
+        UNLIKELY_IF (occlusionQueryType == OcclusionQueryType::anySamplesPassedConservative && !threadContextGroup_->extensions.GL_ARB_ES3_compatibility)
+            throw runtime_error("missing support for GL_ARB_ES3_compatibility (Core since 4.3)!");
+        UNLIKELY_IF (running)
+            throw runtime_error("OcclusionQuery::begin() called on running OcclusionQuery!");
+        UNLIKELY_IF (threadContext_->runningOcclusionQuery != nullptr)
+            throw runtime_error("OcclusionQuery::begin() called while another OcclusionQuery is running!");
+        UNLIKELY_IF (threadContext_->conditionalRenderOcclusionQuery == this)
+            throw runtime_error("OcclusionQuery::begin() called while this OcclusionQuery is used by setCondition()!");
+        resolve();
+
+        uint32_t slotCount = uint32_t(slot.size());
+        uint32_t i = 0;
+        while (i < slotCount && slot[(nextSlot + i) % slotCount].pending) ++i;
+        if (i == slotCount) {
+            slot.emplace_back();
+            runningSlot = slotCount;
+        } else {
+            runningSlot = (nextSlot + i) % slotCount;
+        }
+        nextSlot = (runningSlot + 1) % uint32_t(slot.size());
+
+        Slot& s = slot[runningSlot];
+        if (!s.queryId) threadContextGroup_->functions.glGenQueries(1, &s.queryId);
+        threadContextGroup_->functions.glBeginQuery(static_cast<GLenum>(occlusionQueryType), s.queryId);
+        threadContext_->runningOcclusionQuery = this;
+        running = true;
+    }
+
+    /**
+        \brief Stops counting. The result of this query also is the condition for setCondition().
+    */
+    void OcclusionQuery::end() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!running)
+            throw runtime_error("OcclusionQuery::end() called without OcclusionQuery::begin()!");
+        Slot& s = slot[runningSlot];
+        threadContextGroup_->functions.glEndQuery(static_cast<GLenum>(occlusionQueryType));
+        threadContext_->runningOcclusionQuery = nullptr;
+        s.sequence    = nextSequence++;
+        s.pending     = true;
+        lastEndedSlot = int32_t(runningSlot);
+        running       = false;
+    }
+
+    /**
+        \brief Returns true if at last one query got resolved. Does not wait for the GPU.
+    */
+    bool OcclusionQuery::hasResult() {
+        resolve();
+        return resultCount != 0;
+    }
+
+    /**
+        \brief Returns the result of the latest resolved query, or 0 if there is none yet. Does not wait for the GPU.
+    */
+    uint64_t OcclusionQuery::getResult() {
+        resolve();
+        return result;
+    }
+
+    /**
+        \brief Waits for the result of the latest ended query and returns it
+    */
+    uint64_t OcclusionQuery::waitResult() {
+        UNLIKELY_IF (lastEndedSlot < 0)
+            throw runtime_error("OcclusionQuery::waitResult() called without any ended query!");
+        Slot& s = slot[lastEndedSlot];
+        if (s.pending) {
+            threadContext_->flushDrawBatch();
+            uint64_t value = 0;
+            threadContextGroup_->functions.glGetQueryObjectui64v(s.queryId, GL_QUERY_RESULT, &value);
+            resolveSlot(s, value);
+        }
+        return result;
+    }
+
+    /**
+        \brief Amount of queries that are ended but not resolved yet
+    */
+    uint32_t OcclusionQuery::getPendingCount() const {
+        uint32_t count = 0;
+        for (auto& s : slot) if (s.pending) count++;
+        return count;
+    }
+
+    void OcclusionQuery::resolve() {
+        for (auto& s : slot) {
+            if (!s.pending) continue;
+            int32_t available = 0;
+            threadContextGroup_->functions.glGetQueryObjectiv(s.queryId, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+            uint64_t value = 0;
+            threadContextGroup_->functions.glGetQueryObjectui64v(s.queryId, GL_QUERY_RESULT, &value);
+            resolveSlot(s, value);
+        }
+    }
+
+    void OcclusionQuery::resolveSlot(
+        Slot&    s,
+        uint64_t value
+    ) {
+        s.pending = false;
+        resultCount++;
+        if (s.sequence > resultSequence) {
+            resultSequence = s.sequence;
+            result         = value;
+        }
+    }
+}
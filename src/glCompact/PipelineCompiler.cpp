@@ -0,0 +1,325 @@
+#include "glCompact/PipelineCompiler.hpp"
+#include "glCompact/PipelineCompiler_.hpp"
+#include "glCompact/PipelineRasterization.hpp"
+#include "glCompact/ContextScope.hpp"
+#include "glCompact/Context_.hpp"
+#include "glCompact/threadContext_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/ProgramCache_.hpp"
+#include "glCompact/config.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+
+/*
+    Sync objects, programs and shaders are shared between all contexts of a share group. Everything else (VAOs, FBOs, bindings) is not,
+    that is why the workers only compile and link and the pipeline object itself is created on the render thread.
+
+    A fence is only guaranteed to become signaled if the context that inserted it gets flushed.
+    GL_SYNC_FLUSH_COMMANDS_BIT in glClientWaitSync only flushes the calling context, so the worker has to glFlush after inserting the fence.
+
+    GL_KHR_parallel_shader_compile has the same goal without extra contexts, see PipelineCompileMode::async.
+    The driver may still serialize compiling of multiple contexts, how much this gains depends on the driver.
+*/
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    PipelineCompilerJob_::~PipelineCompilerJob_() {
+        if (programId) threadContextGroup_->functions.glDeleteProgram(programId);
+    }
+
+    /**
+        \ingroup API
+        \class glCompact::PipelineCompiler
+
+        \brief Compiles and links pipelines on worker threads with their own shared contexts
+
+        \details Every worker thread calls workerContextMakeCurrent(workerIndex) once when it starts. It must make a OpenGL context current on the calling thread
+        that shares its objects with the context of contextScope. Creating these contexts is up to the windowing library (e.g. SDL_GL_SHARE_WITH_CURRENT_CONTEXT),
+        most of them need the shared contexts to be created on the render thread before the PipelineCompiler is constructed.
+        workerContextRelease(workerIndex) is called on the worker thread after it finished, it can be empty.
+
+        The returned Job is used to construct the pipeline on the render thread. If the job is not ready yet, the pipeline constructor blocks until it is.
+
+            PipelineCompiler pipelineCompiler(&contextScope, [&](uint32_t i){SDL_GL_MakeCurrent(window, workerContext[i]);}, nullptr, 2);
+            vector<PipelineCompiler::Job> job;
+            for (auto& material : materialList) job.push_back(pipelineCompiler.compileRasterization(material.vertex, "", "", "", material.fragment));
+            ...
+            if (job[i].isReady()) materialPipeline[i].reset(new MaterialPipeline(Primitive::triangles, job[i]));
+
+        The program cache (setProgramCacheDirectory) is used by the workers too. Reflection data of newly compiled programs is collected on the render thread
+        when the pipeline is constructed.
+
+        Needs GLCOMPACT_MULTIPLE_CONTEXT in config.hpp and GL_ARB_sync (Core since 3.2)
+    */
+    PipelineCompiler::PipelineCompiler(
+        const ContextScope*                       contextScope,
+        std::function<void(uint32_t workerIndex)> workerContextMakeCurrent,
+        std::function<void(uint32_t workerIndex)> workerContextRelease,
+        uint32_t                                  workerCount
+    ):
+        contextScope            (contextScope),
+        workerContextMakeCurrent(workerContextMakeCurrent),
+        workerContextRelease    (workerContextRelease)
+    {
+        #ifndef GLCOMPACT_MULTIPLE_CONTEXT
+            throw runtime_error("PipelineCompiler needs GLCOMPACT_MULTIPLE_CONTEXT to be defined in config.hpp!");
+        #endif
+        UNLIKELY_IF (!contextScope)
+            throw runtime_error("PipelineCompiler needs the ContextScope of the render thread!");
+        UNLIKELY_IF (!workerContextMakeCurrent)
+            throw runtime_error("PipelineCompiler needs a function to make the worker contexts current!");
+        if (!workerCount) workerCount = 1;
+        LOOPI(workerCount) worker.emplace_back(&PipelineCompiler::workerThread, this, i);
+    }
+
+    /**
+        \brief Waits for the jobs the workers are processing right now and joins the worker threads. Jobs that are still in the queue fail.
+    */
+    PipelineCompiler::~PipelineCompiler() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stop = true;
+        }
+        queueCondition.notify_all();
+        for (auto& w : worker) w.join();
+
+        for (auto& job : queue) {
+            lock_guard<mutex> lock(job->mutex);
+            job->infoLog = "PipelineCompiler got destroyed before the job was processed!";
+            job->done    = true;
+            job->condition.notify_all();
+        }
+    }
+
+    /**
+        \brief Queues compiling and linking of a rasterization pipeline, empty strings for unused stages
+    */
+    PipelineCompiler::Job PipelineCompiler::compileRasterization(
+        const std::string& vertexString,
+        const std::string& tessControlString,
+        const std::string& tessEvalutionString,
+        const std::string& geometryString,
+        const std::string& fragmentString
+    ) {
+        auto job = make_shared<PipelineCompilerJob_>();
+        job->shaderString[0] = vertexString;
+        job->shaderString[1] = tessControlString;
+        job->shaderString[2] = tessEvalutionString;
+        job->shaderString[3] = geometryString;
+        job->shaderString[4] = fragmentString;
+        LOOPI(5) job->hasShader[i] = !job->shaderString[i].empty();
+        return submit(move(job));
+    }
+
+    /**
+        \brief Queues compiling and linking of a compute pipeline
+    */
+    PipelineCompiler::Job PipelineCompiler::compileCompute(
+        const std::string& computeString
+    ) {
+        auto job = make_shared<PipelineCompilerJob_>();
+        job->compute         = true;
+        job->shaderString[0] = computeString;
+        job->hasShader[0]    = true;
+        return submit(move(job));
+    }
+
+    /**
+        \brief Amount of jobs that no worker started on yet
+    */
+    uint32_t PipelineCompiler::getQueueSize() {
+        lock_guard<mutex> lock(queueMutex);
+        return uint32_t(queue.size());
+    }
+
+    /**
+        \brief Blocks until the queue is empty and all workers are done with their current job
+    */
+    void PipelineCompiler::waitIdle() {
+        unique_lock<mutex> lock(queueMutex);
+        idleCondition.wait(lock, [this]{return queue.empty() && busyCount == 0;});
+    }
+
+    PipelineCompiler::Job PipelineCompiler::submit(
+        std::shared_ptr<PipelineCompilerJob_> job
+    ) {
+        Job handle;
+        handle.job_ = job;
+        {
+            lock_guard<mutex> lock(queueMutex);
+            queue.push_back(move(job));
+        }
+        queueCondition.notify_one();
+        return handle;
+    }
+
+    void PipelineCompiler::compileJob(
+        PipelineCompilerJob_& job
+    ) {
+        const string* const shaderSrc[] = {
+            &job.shaderString[0],
+            &job.shaderString[1],
+            &job.shaderString[2],
+            &job.shaderString[3],
+            &job.shaderString[4]
+        };
+        const GLenum shaderType[] = {
+            GL_VERTEX_SHADER,
+            GL_TESS_CONTROL_SHADER,
+            GL_TESS_EVALUATION_SHADER,
+            GL_GEOMETRY_SHADER,
+            GL_FRAGMENT_SHADER
+        };
+        const uint32_t shaderCount = job.compute ? 1 : 5;
+
+        job.programCacheKey = ProgramCache_::isEnabled() ? ProgramCache_::createKey(shaderSrc, shaderCount) : 0;
+        uint32_t id = ProgramCache_::load(job.programCacheKey, job.programCacheInformation);
+        job.fromProgramCache = id != 0;
+
+        if (!id) {
+            uint32_t shaderId[5] = {};
+            LOOPI(shaderCount) if (job.hasShader[i]) {
+                shaderId[i] = threadContextGroup_->functions.glCreateShader(job.compute ? GL_COMPUTE_SHADER : shaderType[i]);
+                const char* pCString = shaderSrc[i]->c_str();
+                threadContextGroup_->functions.glShaderSource(shaderId[i], 1, reinterpret_cast<const GLchar**>(&pCString), NULL);
+                threadContextGroup_->functions.glCompileShader(shaderId[i]);
+            }
+            id = threadContextGroup_->functions.glCreateProgram();
+            ProgramCache_::setRetrievableHint(id);
+            LOOPI(shaderCount) if (shaderId[i]) threadContextGroup_->functions.glAttachShader(id, shaderId[i]);
+            threadContextGroup_->functions.glLinkProgram(id);
+
+            bool compileSuccessful = true;
+            LOOPI(shaderCount) if (shaderId[i]) {
+                GLint compileStatus;
+                threadContextGroup_->functions.glGetShaderiv(shaderId[i], GL_COMPILE_STATUS, &compileStatus);
+                string shaderLog = PipelineInterface::getShaderInfoLog(shaderId[i]);
+                if (!shaderLog.empty())
+                    job.infoLog += (job.compute ? string("COMPUTE SHADER") : PipelineRasterization::shaderTypeString[i]) + " LOG:\n" + shaderLog + "\n";
+                compileSuccessful &= compileStatus == GL_TRUE;
+            }
+
+            GLint linkStatus = GL_FALSE;
+            if (compileSuccessful) {
+                threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
+                string programLog = PipelineInterface::getProgramInfoLog(id);
+                if (!programLog.empty())
+                    job.infoLog += "PROGRAM LINK STATUS:\n" + programLog + "\n";
+            }
+
+            LOOPI(shaderCount) if (shaderId[i]) {
+                threadContextGroup_->functions.glDetachShader(id, shaderId[i]);
+                threadContextGroup_->functions.glDeleteShader(shaderId[i]);
+            }
+
+            if (!compileSuccessful || !linkStatus) {
+                threadContextGroup_->functions.glDeleteProgram(id);
+                id = 0;
+                job.infoLog = (compileSuccessful ? "Error linking shader:\n" : "Error loading shader:\n") + job.infoLog;
+            }
+        }
+
+        if (id) {
+            job.fence.insert();
+            threadContextGroup_->functions.glFlush();
+        }
+        job.programId = id;
+    }
+
+    void PipelineCompiler::workerThread(
+        uint32_t workerIndex
+    ) {
+        workerContextMakeCurrent(workerIndex);
+        {
+            ContextScope workerContextScope(contextScope);
+            for (;;) {
+                shared_ptr<PipelineCompilerJob_> job;
+                {
+                    unique_lock<mutex> lock(queueMutex);
+                    queueCondition.wait(lock, [this]{return stop || !queue.empty();});
+                    if (stop) break;
+                    job = move(queue.front());
+                    queue.pop_front();
+                    busyCount++;
+                }
+
+                try {
+                    compileJob(*job);
+                } catch (const std::exception& e) {
+                    job->infoLog += e.what();
+                }
+                LOOPI(5) {
+                    job->shaderString[i].clear();
+                    job->shaderString[i].shrink_to_fit();
+                }
+                {
+                    lock_guard<mutex> lock(job->mutex);
+                    job->done = true;
+                }
+                job->condition.notify_all();
+                //If the handle is already gone the program and fence get deleted here, while the worker context is still current
+                job.reset();
+
+                {
+                    lock_guard<mutex> lock(queueMutex);
+                    busyCount--;
+                }
+                idleCondition.notify_all();
+            }
+        }
+        if (workerContextRelease) workerContextRelease(workerIndex);
+    }
+
+    bool PipelineCompiler::Job::isCompute() const {
+        return job_ && job_->compute;
+    }
+
+    /**
+        \brief True if the worker is done with this job and the linked program is visible to the calling context. Never blocks.
+    */
+    bool PipelineCompiler::Job::isReady() {
+        UNLIKELY_IF (!job_) return false;
+        {
+            lock_guard<mutex> lock(job_->mutex);
+            if (!job_->done) return false;
+        }
+        if (!job_->programId || job_->fenceSignaled) return true;
+        job_->fenceSignaled = job_->fence.isSignaled();
+        return job_->fenceSignaled;
+    }
+
+    /**
+        \brief Blocks until isReady() would return true
+    */
+    void PipelineCompiler::Job::wait() {
+        UNLIKELY_IF (!job_)
+            throw runtime_error("PipelineCompiler::Job is empty!");
+        {
+            unique_lock<mutex> lock(job_->mutex);
+            job_->condition.wait(lock, [this]{return job_->done;});
+        }
+        if (!job_->programId || job_->fenceSignaled) return;
+        job_->fence.isSignaledOrWait();
+        job_->fenceSignaled = true;
+    }
+
+    /**
+        \brief True if compiling or linking failed, blocks until the job is done
+    */
+    bool PipelineCompiler::Job::hasFailed() {
+        wait();
+        return !job_->programId && !job_->taken;
+    }
+
+    /**
+        \brief Compiler and linker messages, blocks until the job is done
+    */
+    std::string PipelineCompiler::Job::getInfoLog() {
+        wait();
+        return job_->infoLog;
+    }
+}
@@ -5,6 +5,9 @@
 #include "glCompact/threadContextGroup_.hpp"
 #include "glCompact/config.hpp"
 #include "glCompact/minimumMaximum.hpp"
+#include "glCompact/GpuTimer.hpp"
+#include "glCompact/ProgramCache_.hpp"
+#include "glCompact/PipelineCompiler_.hpp"
 
     #include "glCompact/Tools_.hpp"
     #include "glCompact/GlTools.hpp"
@@ -62,15 +65,17 @@ using namespace glCompact::gl;
 
 namespace glCompact {
     PipelineCompute::PipelineCompute(
-        const std::string&          shaderString
+        const std::string&          shaderString,
+        PipelineCompileMode         compileMode
     ) {
-        loadString_(shaderString);
+        loadString_(shaderString, compileMode);
     }
 
     //TODO: one of the only instances where I depend on catch to work (blocks people form changing throw into a simple crash)
     PipelineCompute::PipelineCompute(
         const std::string&          path,
-        const std::string&          fileName
+        const std::string&          fileName,
+        PipelineCompileMode         compileMode
     ):
         loadedFromFile(true)
     {
@@ -83,52 +88,101 @@ namespace glCompact {
         } catch (const std::exception& e) {
             throw std::runtime_error("Can not read compute shader file \"" + fullFileName + "\". " + e.what());
         }
-        loadString_(shaderString);
+        loadString_(shaderString, compileMode);
+    }
+
+    //Takes over the program of a PipelineCompiler job, blocks if the job is not ready yet
+    PipelineCompute::PipelineCompute(
+        PipelineCompiler::Job job
+    ) {
+        PipelineCompilerJob_& compilerJob = loadCompilerJob_(job, true);
+        loadInformation_(compilerJob.fromProgramCache ? &compilerJob.programCacheInformation : nullptr);
     }
 
     void PipelineCompute::loadString_(
-        const std::string& computeShaderString
+        const std::string&  computeShaderString,
+        PipelineCompileMode compileMode
     ) {
+        const string* const shaderSrc[] = {&computeShaderString};
+        loadProgramCacheKey = ProgramCache_::isEnabled() ? ProgramCache_::createKey(shaderSrc, 1) : 0;
+        vector<char> programCacheInformation;
+        id = ProgramCache_::load(loadProgramCacheKey, programCacheInformation);
+        if (id) {
+            loadInformation_(&programCacheInformation);
+            return;
+        }
+
+        //Compile status and link status are only checked in loadFinish_(), so with GL_KHR_parallel_shader_compile the driver can do all of it in the background
         GLuint shaderId = threadContextGroup_->functions.glCreateShader(GL_COMPUTE_SHADER);
         const char *pCString = computeShaderString.c_str();
         threadContextGroup_->functions.glShaderSource(shaderId, 1, reinterpret_cast<const GLchar**>(&pCString), NULL);
         threadContextGroup_->functions.glCompileShader(shaderId);
+        loadShaderId[0] = shaderId;
+
+        id = threadContextGroup_->functions.glCreateProgram();
+        ProgramCache_::setRetrievableHint(id);
+
+        threadContextGroup_->functions.glAttachShader(id, shaderId);
+        threadContextGroup_->functions.glLinkProgram(id);
+
+        if (compileMode == PipelineCompileMode::async) {
+            loadPending = true;
+            return;
+        }
+        loadFinish_();
+    }
+
+    /*
+        Second half of loading a program that is not from the program cache. Blocks until the driver is done with compiling and linking.
+    */
+    void PipelineCompute::loadFinish_() {
+        GLuint shaderId = loadShaderId[0];
+        loadShaderId[0] = 0;
+
         GLint status;
         threadContextGroup_->functions.glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status);
         bool compileSuccessful = status == GL_TRUE;
         string shaderLog = getShaderInfoLog(shaderId);
         if (!shaderLog.empty())
             infoLog_ += "COMPUTE SHADER LOG:\n" + shaderLog + "\n";
-        UNLIKELY_IF (!compileSuccessful) {
-            if (shaderId) threadContextGroup_->functions.glDeleteShader(shaderId);
-            throw std::runtime_error("Error loading shader:\n" + infoLog_);
-        }
 
-        id = threadContextGroup_->functions.glCreateProgram();
-        //if (binaryRetrievableHint && threadContext->extensions.GL_ARB_get_program_binary)
-        //    threadContextGroup_->functions.glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
-        //else
-        //    glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_FALSE);
-
-        threadContextGroup_->functions.glAttachShader(id, shaderId);
-        threadContextGroup_->functions.glLinkProgram(id);
-
-        GLint linkStatus;
-        threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
-        string programLog = getProgramInfoLog(id);
-        if (!programLog.empty())
-            infoLog_ += "PROGRAM LINK STATUS:\n" + getProgramInfoLog(id) + "\n";
+        GLint linkStatus = GL_FALSE;
+        if (compileSuccessful) {
+            threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
+            string programLog = getProgramInfoLog(id);
+            if (!programLog.empty())
+                infoLog_ += "PROGRAM LINK STATUS:\n" + programLog + "\n";
+        }
 
         threadContextGroup_->functions.glDetachShader(id, shaderId);
         threadContextGroup_->functions.glDeleteShader(shaderId);
 
-        UNLIKELY_IF (!linkStatus) {
+        UNLIKELY_IF (!compileSuccessful || !linkStatus) {
             threadContextGroup_->functions.glDeleteProgram(id);
             id = 0;
-            throw std::runtime_error("Error linking shader:\n" + infoLog_);
+            throw std::runtime_error((compileSuccessful ? "Error linking shader:\n" : "Error loading shader:\n") + infoLog_);
         }
 
-        collectInformation();
+        loadInformation_(nullptr);
+    }
+
+    /*
+        Reads the shader information that was stored in the program cache, or collects it from the linked program and stores it in the cache
+    */
+    void PipelineCompute::loadInformation_(
+        const std::vector<char>* programCacheInformation
+    ) {
+        if (programCacheInformation) {
+            ProgramCacheReader_ reader(*programCacheInformation);
+            readInformation(reader);
+        } else {
+            collectInformation();
+            if (ProgramCache_::isEnabled()) {
+                ProgramCacheWriter_ writer;
+                writeInformation(writer);
+                ProgramCache_::store(loadProgramCacheKey, id, writer.data);
+            }
+        }
         allocateMemory();
     }
 
@@ -137,6 +191,20 @@ namespace glCompact {
         threadContextGroup_->functions.glGetProgramiv(id, GL_COMPUTE_WORK_GROUP_SIZE, &workGroupSize[0]);
     }
 
+    void PipelineCompute::writeInformation(
+        ProgramCacheWriter_& writer
+    ) const {
+        PipelineInterface::writeInformation(writer);
+        LOOPI(3) writer.write(workGroupSize[i]);
+    }
+
+    void PipelineCompute::readInformation(
+        ProgramCacheReader_& reader
+    ) {
+        PipelineInterface::readInformation(reader);
+        LOOPI(3) reader.read(workGroupSize[i]);
+    }
+
     /** \brief dispatch compute shader
      *
      * \param x
@@ -151,7 +219,10 @@ namespace glCompact {
         UNLIKELY_IF (!threadContextGroup_->extensions.GL_ARB_compute_shader)
             throw std::runtime_error("missing support for GL_ARB_compute_shader (Core since 4.3)!");
         processPendingChanges();
+        const bool timed = gpuTimer && !gpuTimer->isRunning();
+        if (timed) gpuTimer->begin();
         threadContextGroup_->functions.glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+        if (timed) gpuTimer->end();
     }
 
     /** \brief This is a helper function to dispatch a minimum amount of work groups
@@ -222,7 +293,10 @@ namespace glCompact {
             throw std::runtime_error("does not take empty buffer!");
         processPendingChanges();
         threadContext_->cachedBindDispatchIndirectBuffer(buffer.id);
+        const bool timed = gpuTimer && !gpuTimer->isRunning();
+        if (timed) gpuTimer->begin();
         threadContextGroup_->functions.glDispatchComputeIndirect(offset);
+        if (timed) gpuTimer->end();
     }
 
     /*
@@ -269,6 +343,7 @@ namespace glCompact {
     }
 
     void PipelineCompute::processPendingChanges() {
+        threadContext_->flushDrawBatch();
         threadContext_->cachedBindShader(id);
         if (threadContext_->pipeline != this) {
             PipelineInterface::processPendingChangesPipeline();
@@ -0,0 +1,223 @@
+#include "glCompact/PipelineComputeCulling.hpp"
+#include "glCompact/DepthPyramid.hpp"
+#include "glCompact/MemoryBarrier.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace glCompact {
+    /*
+        Every invocation tests one object. Visible objects first get a slot in the work group via a shared counter,
+        then one invocation per work group reserves the range of all of them in the global count. That keeps the global atomics at one per work group.
+        The order of the written commands is therefore not the order of the objects.
+
+        Hi-Z: the screen space rectangle of the box around the bounding sphere is looked up in the pyramid level where it covers at most 2x2 texels.
+        Spheres that reach behind the camera plane are never occluded.
+    */
+    const string PipelineComputeCulling::shaderString = R"""(#version 430
+layout(local_size_x = 64) in;
+
+struct CullingObject {
+    vec4 boundingSphere;
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int  baseVertex;
+    uint baseInstance;
+};
+struct DrawElementsIndirectCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int  baseVertex;
+    uint baseInstance;
+};
+
+readonly layout(std430, binding=0) buffer objectBuffer {
+    CullingObject object[];
+};
+writeonly layout(std430, binding=1) buffer commandBuffer {
+    DrawElementsIndirectCommand command[];
+};
+layout(std430, binding=2) buffer countBuffer {
+    uint drawCount;
+};
+
+uniform uint objectCount;
+uniform mat4 viewProjection;
+uniform int  hiZ;
+uniform int  depthZeroToOne;
+uniform int  depthReversed;
+uniform sampler2D depthPyramid_binding0;
+
+shared uint groupVisibleCount;
+shared uint groupFirstSlot;
+
+bool isInFrustum(vec4 sphere) {
+    //Planes from the rows of viewProjection (Gribb/Hartmann), near plane for -w <= z is also conservative for 0 <= z
+    const mat4 m = transpose(viewProjection);
+    const vec4 plane[6] = vec4[6](m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2]);
+    for (int i = 0; i < 6; ++i)
+        if (dot(plane[i].xyz, sphere.xyz) + plane[i].w < -sphere.w * length(plane[i].xyz)) return false;
+    return true;
+}
+
+bool isOccluded(vec4 sphere) {
+    vec3 ndcMin = vec3( 1.0);
+    vec3 ndcMax = vec3(-1.0);
+    for (int i = 0; i < 8; ++i) {
+        const vec3 corner = sphere.xyz + sphere.w * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        const vec4 clip = viewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0) return false;
+        ndcMin = min(ndcMin, clip.xyz / clip.w);
+        ndcMax = max(ndcMax, clip.xyz / clip.w);
+    }
+    const vec2 uvMin    = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0);
+    const vec2 uvMax    = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0);
+    const float depthMin = depthZeroToOne != 0 ? ndcMin.z : ndcMin.z * 0.5 + 0.5;
+    const float depthMax = depthZeroToOne != 0 ? ndcMax.z : ndcMax.z * 0.5 + 0.5;
+
+    const vec2 extent = (uvMax - uvMin) * vec2(textureSize(depthPyramid_binding0, 0));
+    const int  lod    = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, textureQueryLevels(depthPyramid_binding0) - 1);
+    //Level sizes are rounded down, so scaling uv by the level size would undershoot for non power of two sizes.
+    //Texel t of level lod covers the level 0 texels t << lod up to (t + 1) << lod (the last one also the odd remainder).
+    const ivec2 levelSize = textureSize(depthPyramid_binding0, lod);
+    const ivec2 baseSize  = textureSize(depthPyramid_binding0, 0);
+    const ivec2 p0 = min(ivec2(uvMin * vec2(baseSize)) >> lod, levelSize - 1);
+    const ivec2 p1 = min(ivec2(uvMax * vec2(baseSize)) >> lod, levelSize - 1);
+    const vec4 d = vec4(
+        texelFetch(depthPyramid_binding0, ivec2(p0.x, p0.y), lod).r,
+        texelFetch(depthPyramid_binding0, ivec2(p1.x, p0.y), lod).r,
+        texelFetch(depthPyramid_binding0, ivec2(p0.x, p1.y), lod).r,
+        texelFetch(depthPyramid_binding0, ivec2(p1.x, p1.y), lod).r
+    );
+    //nearest depth of the object behind the farthest depth of the covered area
+    if (depthReversed != 0) return depthMax < min(min(d.x, d.y), min(d.z, d.w));
+    return depthMin > max(max(d.x, d.y), max(d.z, d.w));
+}
+
+void main() {
+    const uint groupIndex =
+        gl_WorkGroupID.z * gl_NumWorkGroups.y * gl_NumWorkGroups.x +
+        gl_WorkGroupID.y * gl_NumWorkGroups.x +
+        gl_WorkGroupID.x;
+    const uint globalIndex = gl_LocalInvocationIndex + groupIndex * gl_WorkGroupSize.x;
+
+    if (gl_LocalInvocationIndex == 0) groupVisibleCount = 0;
+    barrier();
+
+    bool visible = false;
+    CullingObject o;
+    if (globalIndex < objectCount) {
+        o = object[globalIndex];
+        visible = isInFrustum(o.boundingSphere) && !(hiZ != 0 && isOccluded(o.boundingSphere));
+    }
+    uint groupSlot = 0;
+    if (visible) groupSlot = atomicAdd(groupVisibleCount, 1u);
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0 && groupVisibleCount > 0) groupFirstSlot = atomicAdd(drawCount, groupVisibleCount);
+    barrier();
+
+    if (visible) command[groupFirstSlot + groupSlot] = DrawElementsIndirectCommand(o.count, o.instanceCount, o.firstIndex, o.baseVertex, o.baseInstance);
+})""";
+
+    /**
+        \ingroup API
+        \class glCompact::PipelineComputeCulling
+
+        \brief Frustum and Hi-Z culling of draw commands on the GPU, producing the input of PipelineRasterization::drawIndexedIndirectCount()
+
+        \details objectBuffer holds objectCount CullingObject records, each a bounding sphere and the DrawElementsIndirectCommand to draw the object with.
+        cull() writes the commands of all visible objects tightly packed into commandBuffer and their count as uint32_t at offset 0 of countBuffer.
+        gl_BaseInstance (or baseInstance as attribute divisor offset) can be used to find the per object data while drawing, the order of the commands is not stable.
+
+        \code{.cpp}
+            PipelineComputeCulling culling;
+            BufferGpu objectBuffer (false, objectCount * sizeof(CullingObject), cullingObjects);
+            BufferGpu commandBuffer(false, objectCount * sizeof(DrawElementsIndirectCommand));
+            BufferGpu countBuffer  (false, sizeof(uint32_t));
+            //each frame
+            culling.cull(objectBuffer, objectCount, commandBuffer, countBuffer, projection * view, depthPyramid);
+            pipeline.drawIndexedIndirectCount(commandBuffer, 0, countBuffer, 0, objectCount);
+        \endcode
+
+        With a DepthPyramid objects get also tested against the depth of the pyramid. It must be built with the same (or the previous frame) viewProjection.
+        A DepthPyramid with MipmapFilter::min is treated as reversed depth range (GL_GREATER depth test).
+        Set clipDepthZeroToOne if glClipControl(..., GL_ZERO_TO_ONE) is used.
+
+        The command barrier for the following indirect draw is set. Reading commandBuffer or countBuffer in shaders needs MemoryBarrier::shaderStorageBuffer().
+
+        Depends on pipelineCompute (GL_ARB_compute_shader, Core since 4.3), GL_ARB_shader_storage_buffer_object (Core since 4.3) and for drawIndexedIndirectCount on drawIndirectCount (GL_ARB_indirect_parameters, Core since 4.6)
+    */
+    PipelineComputeCulling::PipelineComputeCulling(
+        PipelineCompileMode compileMode
+    ) :
+        PipelineCompute(shaderString, compileMode)
+    {}
+
+    /**
+        \brief Frustum culling only
+    */
+    void PipelineComputeCulling::cull(
+        BufferInterface&  objectBuffer,
+        uint32_t          objectCount,
+        BufferInterface&  commandBuffer,
+        BufferInterface&  countBuffer,
+        const glm::mat4&  viewProjection
+    ) {
+        hiZ = 0;
+        setTexture(0);
+        dispatchCulling(objectBuffer, objectCount, commandBuffer, countBuffer, viewProjection);
+    }
+
+    /**
+        \brief Frustum and Hi-Z occlusion culling
+    */
+    void PipelineComputeCulling::cull(
+        BufferInterface&    objectBuffer,
+        uint32_t            objectCount,
+        BufferInterface&    commandBuffer,
+        BufferInterface&    countBuffer,
+        const glm::mat4&    viewProjection,
+        const DepthPyramid& depthPyramid,
+        bool                clipDepthZeroToOne
+    ) {
+        UNLIKELY_IF (!depthPyramid.getTexture().getMipmapCount())
+            throw runtime_error("PipelineComputeCulling::cull() needs a DepthPyramid that was build!");
+        hiZ            = 1;
+        depthZeroToOne = clipDepthZeroToOne ? 1 : 0;
+        depthReversed  = depthPyramid.getMipmapFilter() == MipmapFilter::min ? 1 : 0;
+        setTexture(0, depthPyramid.getTexture());
+        dispatchCulling(objectBuffer, objectCount, commandBuffer, countBuffer, viewProjection);
+    }
+
+    void PipelineComputeCulling::dispatchCulling(
+        BufferInterface&  objectBuffer,
+        uint32_t          objectCount,
+        BufferInterface&  commandBuffer,
+        BufferInterface&  countBuffer,
+        const glm::mat4&  viewProjection
+    ) {
+        UNLIKELY_IF (objectBuffer.getSize()  < uintptr_t(objectCount) * sizeof(CullingObject))
+            throw runtime_error("PipelineComputeCulling objectBuffer is too small for " + to_string(objectCount) + " CullingObject!");
+        UNLIKELY_IF (commandBuffer.getSize() < uintptr_t(objectCount) * sizeof(DrawElementsIndirectCommand))
+            throw runtime_error("PipelineComputeCulling commandBuffer is too small for " + to_string(objectCount) + " DrawElementsIndirectCommand!");
+        UNLIKELY_IF (countBuffer.getSize()   < sizeof(uint32_t))
+            throw runtime_error("PipelineComputeCulling countBuffer is too small!");
+
+        countBuffer.clear(0, sizeof(uint32_t), uint32_t(0));
+        if (objectCount) {
+            setShaderStorageBuffer(0, objectBuffer);
+            setShaderStorageBuffer(1, commandBuffer);
+            setShaderStorageBuffer(2, countBuffer);
+            this->objectCount    = objectCount;
+            this->viewProjection = viewProjection;
+            dispatchMinGroupCount((uint64_t(objectCount) + 63) / 64);
+        }
+        MemoryBarrier::parameterBuffer();
+    }
+}
@@ -0,0 +1,149 @@
+#include "glCompact/PipelineComputeMipmap_.hpp"
+#include "glCompact/gl/Constants.hpp"
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    PipelineComputeMipmap_::PipelineComputeMipmap_(
+        int32_t      sizedFormat,
+        MipmapFilter mipmapFilter
+    ) :
+        PipelineCompute(getShaderString(sizedFormat, mipmapFilter)),
+        sizedFormat    (sizedFormat),
+        mipmapFilter   (mipmapFilter)
+    {}
+
+    //GLSL image format layout qualifier of all float, unorm and snorm formats with image load/store support. Returns nullptr for all others.
+    const char* PipelineComputeMipmap_::getImageFormatQualifier(
+        int32_t sizedFormat
+    ) {
+        switch (sizedFormat) {
+            case GL_RGBA32F:        return "rgba32f";
+            case GL_RGBA16F:        return "rgba16f";
+            case GL_RG32F:          return "rg32f";
+            case GL_RG16F:          return "rg16f";
+            case GL_R11F_G11F_B10F: return "r11f_g11f_b10f";
+            case GL_R32F:           return "r32f";
+            case GL_R16F:           return "r16f";
+            case GL_RGBA16:         return "rgba16";
+            case GL_RGB10_A2:       return "rgb10_a2";
+            case GL_RGBA8:          return "rgba8";
+            case GL_RG16:           return "rg16";
+            case GL_RG8:            return "rg8";
+            case GL_R16:            return "r16";
+            case GL_R8:             return "r8";
+            case GL_RGBA16_SNORM:   return "rgba16_snorm";
+            case GL_RGBA8_SNORM:    return "rgba8_snorm";
+            case GL_RG16_SNORM:     return "rg16_snorm";
+            case GL_RG8_SNORM:      return "rg8_snorm";
+            case GL_R16_SNORM:      return "r16_snorm";
+            case GL_R8_SNORM:       return "r8_snorm";
+        }
+        return nullptr;
+    }
+
+    /*
+        Every invocation produces one texel of the first destination level from the source level. For box/min/max the 8x8 results of a work group
+        are then reduced further in shared memory, writing up to 3 more levels without another dispatch. That only works if the levels in between have
+        even sizes, what the caller makes sure of via levelCount. Kaiser needs texels outside of the work group tile, so it always uses levelCount 1.
+    */
+    string PipelineComputeMipmap_::getShaderString(
+        int32_t      sizedFormat,
+        MipmapFilter mipmapFilter
+    ) {
+        string format = getImageFormatQualifier(sizedFormat);
+        string reduce;
+        string normalize;
+        switch (mipmapFilter) {
+            case MipmapFilter::box:
+            case MipmapFilter::kaiser:
+                reduce    = "((a) + (b))";
+                normalize = "((v) / float(n))";
+                break;
+            case MipmapFilter::min:
+                reduce    = "min(a, b)";
+                normalize = "(v)";
+                break;
+            case MipmapFilter::max:
+                reduce    = "max(a, b)";
+                normalize = "(v)";
+                break;
+        }
+
+        return string() + R"""(#version 430
+layout(local_size_x = 8, local_size_y = 8) in;
+)""" + (mipmapFilter == MipmapFilter::kaiser ? "#define KAISER\n" : "") + R"""(
+#define REDUCE(a, b) )""" + reduce + R"""(
+#define NORMALIZE(v, n) )""" + normalize + R"""(
+
+uniform int srcLod;
+uniform int levelCount;
+uniform sampler2D srcTexture_binding0;
+layout()""" + format + R"""() writeonly uniform image2D dstImage_binding0;
+layout()""" + format + R"""() writeonly uniform image2D dstImage_binding1;
+layout()""" + format + R"""() writeonly uniform image2D dstImage_binding2;
+layout()""" + format + R"""() writeonly uniform image2D dstImage_binding3;
+
+shared vec4 tile[8][8];
+
+vec4 fetch(ivec2 p, ivec2 srcSize) {
+    return texelFetch(srcTexture_binding0, clamp(p, ivec2(0), srcSize - 1), srcLod);
+}
+
+void store(int level, ivec2 p, vec4 v) {
+    switch (level) {
+        case 0: imageStore(dstImage_binding0, p, v); break;
+        case 1: imageStore(dstImage_binding1, p, v); break;
+        case 2: imageStore(dstImage_binding2, p, v); break;
+        case 3: imageStore(dstImage_binding3, p, v); break;
+    }
+}
+
+void main() {
+    const ivec2 srcSize = textureSize(srcTexture_binding0, srcLod);
+    ivec2 dstSize = max(srcSize >> 1, ivec2(1));
+    const ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    const ivec2 l = ivec2(gl_LocalInvocationID.xy);
+
+    vec4 v;
+#ifdef KAISER
+    const float w[6] = float[6](-0.020992, 0.094502, 0.426490, 0.426490, 0.094502, -0.020992);
+    v = vec4(0.0);
+    for (int y = 0; y < 6; ++y) {
+        vec4 row = vec4(0.0);
+        for (int x = 0; x < 6; ++x) row += w[x] * fetch(p * 2 + ivec2(x - 2, y - 2), srcSize);
+        v += w[y] * row;
+    }
+#else
+    //With odd source sizes the last texel also covers the extra row/column, so min/max stay conservative
+    const ivec2 tapCount = ivec2(
+        (p.x == dstSize.x - 1 && (srcSize.x & 1) == 1) ? 3 : 2,
+        (p.y == dstSize.y - 1 && (srcSize.y & 1) == 1) ? 3 : 2
+    );
+    v = fetch(p * 2, srcSize);
+    for (int y = 0; y < tapCount.y; ++y)
+        for (int x = 0; x < tapCount.x; ++x)
+            if (x != 0 || y != 0) v = REDUCE(v, fetch(p * 2 + ivec2(x, y), srcSize));
+    v = NORMALIZE(v, tapCount.x * tapCount.y);
+#endif
+    if (all(lessThan(p, dstSize))) store(0, p, v);
+
+    for (int level = 1; level < levelCount; ++level) {
+        tile[l.y][l.x] = v;
+        memoryBarrierShared();
+        barrier();
+        dstSize = max(dstSize >> 1, ivec2(1));
+        const int tileSize = 8 >> level;
+        if (all(lessThan(l, ivec2(tileSize)))) {
+            const ivec2 t = l * 2;
+            v = REDUCE(REDUCE(tile[t.y][t.x], tile[t.y][t.x + 1]), REDUCE(tile[t.y + 1][t.x], tile[t.y + 1][t.x + 1]));
+            v = NORMALIZE(v, 4);
+            const ivec2 q = ivec2(gl_WorkGroupID.xy) * tileSize + l;
+            if (all(lessThan(q, dstSize))) store(level, q, v);
+        }
+        barrier();
+    }
+})""";
+    }
+}
@@ -14,11 +14,16 @@
 #include "glCompact/multiMalloc.h"
 #include "glCompact/minimumMaximum.hpp"
 #include "glCompact/isDiffThenAssign.hpp"
+#include "glCompact/Statistics_.hpp"
+#include "glCompact/ProgramCache_.hpp"
+#include "glCompact/PipelineCompiler_.hpp"
+#include "glCompact/BlockLayout.hpp"
 
 #include <glm/glm.hpp>
 
 #include <regex>
 #include <algorithm>
+#include <cstring>
 
 ///\cond HIDDEN_FROM_DOXYGEN
 /*
@@ -99,8 +104,12 @@ namespace glCompact {
     PipelineInterface::~PipelineInterface() {
         //if (!SDL_GL_GetCurrentContext())
         //    cout << "WARNING: glCompact::PipelineInterface destructor called but no active OpenGL context in this thread to delete it! Leaking OpenGL object!" << endl;
+        if (threadContextGroup_)
+            for (auto shaderId : loadShaderId)
+                if (shaderId) threadContextGroup_->functions.glDeleteShader(shaderId);
         if (id) {
             if (threadContext_) {
+                threadContext_->flushDrawBatch();
                 detachFromThreadContext();
             }
             if (threadContextGroup_) {
@@ -115,6 +124,7 @@ namespace glCompact {
         uint32_t                slot,
         const TextureInterface& texture
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (!texture.id)
             throw std::runtime_error("empty texture not accepted!");
         UNLIKELY_IF (int32_t(slot) >= sampler_count) return; //TODO: would break if anyone uses slot value over 0x8FFFFFFFF
@@ -127,6 +137,7 @@ namespace glCompact {
     void PipelineInterface::setTexture(
         uint32_t slot
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= sampler_count) return;
 
         texture_id    [slot] = 0;
@@ -135,6 +146,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setTexture() {
+        UNLIKELY_IF (loadPending) waitReady();
         for (int32_t i = 0; i < sampler_count; ++i) {
             texture_id    [i] = 0;
             texture_target[i] = 0;
@@ -147,6 +159,7 @@ namespace glCompact {
         uint32_t       slot,
         const Sampler& sampler
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= sampler_count) return;
 
         sampler_id[slot] = sampler.id;
@@ -156,6 +169,7 @@ namespace glCompact {
     void PipelineInterface::setSampler(
         uint32_t slot
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= sampler_count) return;
 
         sampler_id[slot] = 0;
@@ -163,6 +177,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setSampler() {
+        UNLIKELY_IF (loadPending) waitReady();
         for (int32_t i = 0; i < sampler_count; ++i) sampler_id[i] = 0;
         sampler_changedSlotMin = 0;
         sampler_changedSlotMax = sampler_count - 1;
@@ -173,6 +188,7 @@ namespace glCompact {
         const BufferInterface& buffer,
         uintptr_t              offset
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (!buffer.id)
             throw std::runtime_error("does not take empty Buffer!");
         UNLIKELY_IF (int32_t(slot) >= buffer_uniform_count) return;
@@ -189,6 +205,7 @@ namespace glCompact {
         uintptr_t              offset,
         uintptr_t              size
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (!buffer.id)
             throw std::runtime_error("does not take empty Buffer!");
         UNLIKELY_IF (int32_t(slot) >= buffer_uniform_count) return;
@@ -202,6 +219,7 @@ namespace glCompact {
     void PipelineInterface::setUniformBuffer(
         uint32_t slot
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= buffer_uniform_count) return;
 
         buffer_uniform_id    [slot] = 0;
@@ -211,6 +229,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniformBuffer() {
+        UNLIKELY_IF (loadPending) waitReady();
         for (int32_t i = 0; i < buffer_uniform_count; ++i) {
             buffer_uniform_id    [i] = 0;
             buffer_uniform_offset[i] = 0;
@@ -224,6 +243,7 @@ namespace glCompact {
         uint32_t        slot,
         TextureSelector textureSelector
     ){
+        UNLIKELY_IF (loadPending) waitReady();
         setImage(slot, textureSelector, textureSelector.texture->surfaceFormat);
     }
 
@@ -232,6 +252,7 @@ namespace glCompact {
         TextureSelector textureSelector,
         SurfaceFormat   surfaceFormat
     ){
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= image_count) return;
 
         image_id         [slot] = textureSelector.texture->id;
@@ -244,6 +265,7 @@ namespace glCompact {
     void PipelineInterface::setImage(
         uint32_t slot
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= image_count) return;
 
         image_id[slot] = 0;
@@ -251,6 +273,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setImage() {
+        UNLIKELY_IF (loadPending) waitReady();
         for (int32_t i = 0; i < image_count; ++i) image_id[i] = 0;
         image_changedSlotMin = 0;
         image_changedSlotMax = image_count - 1;
@@ -264,6 +287,7 @@ namespace glCompact {
         BufferInterface& buffer,
         uintptr_t        offset
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (!buffer.id)
             throw std::runtime_error("does not take empty Buffer!");
         UNLIKELY_IF (int32_t(slot) >= buffer_shaderStorage_count) return;
@@ -277,6 +301,7 @@ namespace glCompact {
         uintptr_t        offset,
         uintptr_t        size
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (!buffer.id)
             throw std::runtime_error("does not take empty Buffer!");
         UNLIKELY_IF (int32_t(slot) >= buffer_shaderStorage_count) return;
@@ -290,6 +315,7 @@ namespace glCompact {
     void PipelineInterface::setShaderStorageBuffer(
         uint32_t slot
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         UNLIKELY_IF (int32_t(slot) >= buffer_shaderStorage_count) return;
 
         buffer_shaderStorage_id    [slot] = 0;
@@ -299,6 +325,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setShaderStorageBuffer() {
+        UNLIKELY_IF (loadPending) waitReady();
         for (int i = 0; i < buffer_shaderStorage_count; ++i) {
             buffer_shaderStorage_id    [i] = 0;
             buffer_shaderStorage_offset[i] = 0;
@@ -308,6 +335,73 @@ namespace glCompact {
         buffer_shaderStorage_changedSlotMax = buffer_shaderStorage_count - 1;
     }
 
+    /**
+        \brief Returns true if the pipeline can be used without waiting
+
+        \details Pipelines created with PipelineCompileMode::async return from the constructor without waiting for the driver to compile and link the shaders.
+        With GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile the driver does this in the background and this function only polls GL_COMPLETION_STATUS_KHR.
+        Without either extension the driver can not be asked, then this waits like waitReady().
+
+        Once the program is ready the shader information is collected. Throws if compiling or linking failed.
+    */
+    bool PipelineInterface::isReady() {
+        if (!loadPending) return true;
+        if (!loadFailed && (threadContextGroup_->extensions.GL_KHR_parallel_shader_compile || threadContextGroup_->extensions.GL_ARB_parallel_shader_compile)) {
+            int32_t completionStatus = GL_TRUE;
+            threadContextGroup_->functions.glGetProgramiv(id, GL_COMPLETION_STATUS_KHR, &completionStatus);
+            if (!completionStatus) return false;
+        }
+        waitReady();
+        return true;
+    }
+
+    /**
+        \brief Waits until the program of a pipeline created with PipelineCompileMode::async is ready, throws if compiling or linking failed
+
+        \details Every function that depends on the shader information (setting textures, buffers, images, uniforms, drawing/dispatching) calls this.
+        So using a pipeline that is not ready yet is not an error, but it blocks.
+    */
+    void PipelineInterface::waitReady() {
+        if (!loadPending) return;
+        UNLIKELY_IF (loadFailed)
+            throw std::runtime_error("Using pipeline that failed to load!\n" + infoLog_);
+        try {
+            loadFinish_();
+        } catch (...) {
+            loadFailed = true;
+            throw;
+        }
+        loadPending = false;
+        for (auto& task : loadPendingTaskList) task();
+        loadPendingTaskList = std::vector<std::function<void()>>();
+    }
+
+    /*
+        Takes over the linked program of a PipelineCompiler job, blocks if the job is not ready yet. Throws if compiling or linking failed.
+        The caller still has to collect or read the shader information.
+    */
+    PipelineCompilerJob_& PipelineInterface::loadCompilerJob_(
+        PipelineCompiler::Job& job,
+        bool                   compute
+    ) {
+        UNLIKELY_IF (!job.isValid())
+            throw std::runtime_error("PipelineCompiler::Job is empty!");
+        UNLIKELY_IF (job.isCompute() != compute)
+            throw std::runtime_error(compute ? "PipelineCompiler::Job of a rasterization pipeline can not be used for PipelineCompute!" : "PipelineCompiler::Job of a compute pipeline can not be used for PipelineRasterization!");
+        job.wait();
+        PipelineCompilerJob_& compilerJob = *job.job_;
+        UNLIKELY_IF (compilerJob.taken)
+            throw std::runtime_error("PipelineCompiler::Job was already used to create a pipeline!");
+        infoLog_ = compilerJob.infoLog;
+        UNLIKELY_IF (!compilerJob.programId)
+            throw std::runtime_error(infoLog_);
+        id                      = compilerJob.programId;
+        loadProgramCacheKey     = compilerJob.programCacheKey;
+        compilerJob.programId   = 0;
+        compilerJob.taken       = true;
+        return compilerJob;
+    }
+
     void PipelineInterface::detachFromThreadContext() {
         if (threadContext_) {
             if (threadContext_->pipeline == this) threadContext_->pipeline = 0;
@@ -353,82 +447,6 @@ namespace glCompact {
             return "";
     }
 
-    /*bool PipelineInterface::copyBinaryToMemory(
-        GLenum& binaryFormat,
-        GLsizei bufSize,
-        void*   mem
-    ) const {
-        if (!threadContext->extensions.GL_ARB_get_program_binary) return false;
-        if (!binarySize || bufSize < binarySize) return false;
-        GLsizei bufSizeReturn;
-        threadContextGroup_->functions.glGetProgramBinary(id, binarySize, &bufSizeReturn, &binaryFormat, mem);
-        return true;
-    }
-
-    bool PipelineInterface::copyBinaryFromMemory(
-        GLenum      binaryFormat,
-        GLsizei     bufSize,
-        const void* mem
-    ) {
-        free();
-        if (!threadContext->extensions.GL_ARB_get_program_binary) return false;
-        id_ = threadContextGroup_->functions.glCreateProgram();
-        threadContextGroup_->functions.glProgramBinary(id, binaryFormat, mem, bufSize);
-        GLint linkStatus = 0;
-        threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
-        if (!linkStatus) {
-            free();
-            return false;
-        }
-        return true;
-    }
-
-    bool PipelineInterface::copyBinaryToFile(
-        const std::string& fileName
-    ) const {
-        if (!binarySize) return false;
-        GLenum binaryFormat;
-        char* data = new char[binarySize];
-
-        bool result = copyBinaryToMemory(binaryFormat, binarySize, data);
-        if (result) {
-            std::ofstream fileStream(fileName.c_str(), std::ios::out | std::ios::binary);
-            if (fileStream.is_open()) {
-                uint64_t binaryFormat64 = binaryFormat;
-                fileStream.write(reinterpret_cast<const char*>(&binaryFormat64), sizeof(uint64_t));
-                fileStream.write(reinterpret_cast<const char*>(data), binarySize);
-            } else {
-                result = false;
-            }
-        }
-
-        delete[] data;
-        return result;
-    }
-
-    bool PipelineInterface::copyBinaryFromFile(
-        const std::string& fileName
-    ) {
-        free();
-        bool result = false;
-        std::ifstream fileStream(fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
-        if (fileStream.is_open()) {
-            std::ifstream::pos_type fileSize = fileStream.tellg();
-            fileStream.seekg(0, std::ios::beg);
-            int binarySizeNew = int(fileSize) - sizeof(uint64_t);
-            if (binarySizeNew <= 0) return false;
-            GLenum binaryFormatNew;
-            char* data = new char[binarySizeNew];
-            uint64_t binaryFormat64;
-            fileStream.read(reinterpret_cast<char*>(&binaryFormat64), sizeof(uint64_t));
-            fileStream.read(reinterpret_cast<char*>(data), binarySizeNew);
-            binaryFormatNew = static_cast<GLenum>(binaryFormat64);
-            result = copyBinaryFromMemory(binaryFormatNew, binarySizeNew, data);
-            delete[] data;
-        }
-        return result;
-    }*/
-
     string PipelineInterface::getPipelineInformationQueryString() {
         string s;
         if (uniformList.size()) {
@@ -486,15 +504,293 @@ namespace glCompact {
     //if the uniform name does not exist, this will return -1
     //Uniforms can be removed during optimization by the GLSL compiler.
     int32_t PipelineInterface::getUniformLocation(
-        const std::string& uniformName
+        HashedName uniformName
     ) {
         //return threadContextGroup_->functions.glGetUniformLocation(id, uniformName.c_str());
+        const Uniform* uniform = findUniform(uniformName);
+        return uniform ? uniform->location : -1;
+    }
+
+    /*
+        Pipelines can have hundreds of uniforms and their UniformSetter, UniformBlockLayout and getUniformLocation() lookups happen for every member of every
+        pipeline object. The name index turns each of them into a binary search over name hashes, with a string compare only for matching hashes.
+    */
+    void PipelineInterface::buildNameIndex() {
+        buildNameIndex(uniformNameIndex,      uniformList);
+        buildNameIndex(uniformBlockNameIndex, uniformBlockList);
+        buildNameIndex(storageBlockNameIndex, storageBlockList);
+    }
+
+    const PipelineInterface::Uniform* PipelineInterface::findUniform(
+        HashedName name
+    ) const {
+        return findByName(uniformNameIndex, uniformList, name);
+    }
+
+    const PipelineInterface::UniformBlock* PipelineInterface::findUniformBlock(
+        HashedName name
+    ) const {
+        return findByName(uniformBlockNameIndex, uniformBlockList, name);
+    }
+
+    const PipelineInterface::StorageBlock* PipelineInterface::findStorageBlock(
+        HashedName name
+    ) const {
+        return findByName(storageBlockNameIndex, storageBlockList, name);
+    }
+
+    /**
+        \brief Defers uniform writes of this pipeline to its next draw or dispatch
+
+        \details With uniform shadowing enabled, UniformSetter keeps a CPU copy of all default-block uniforms of the program.
+        Writes only compare and update this copy and mark the changed locations, that get uploaded before the next draw or dispatch of this pipeline.
+        Setting uniforms of pipelines that are not bound therefore does not bind their program, writing the value a uniform already has costs no GL call,
+        and several changed elements of one uniform array are uploaded with one call.
+
+        Uniforms are program state, so disabling it uploads all still pending values right away.
+        Values set in other ways then with UniformSetter bypass the shadow copy and may get overwritten by pending values.
+        Waits for a pipeline created with PipelineCompileMode::async to be ready. Disabled by default.
+    */
+    void PipelineInterface::setUniformShadowing(
+        bool enabled
+    ) {
+        UNLIKELY_IF (loadPending) waitReady();
+        if (uniformShadowing == enabled) return;
+        uniformShadowing = enabled;
+        if (!enabled) {
+            if (uniformShadow_changedLocationMin <= uniformShadow_changedLocationMax) {
+                threadContext_->flushDrawBatch();
+                threadContext_->cachedBindShader(id);
+                processPendingChangesUniformShadow();
+            }
+            uniformShadowLocation = vector<UniformShadowLocation>();
+            uniformShadowData     = vector<uint8_t>();
+            return;
+        }
+
+        int32_t locationMax = -1;
         for (auto& uniform : uniformList)
-            if (uniform.name == uniformName) return uniform.location;
-        return -1;
+            locationMax = maximum(locationMax, uniform.location + (uniform.arrayStride ? maximum(uniform.arraySize - 1, 0) * uniform.arrayStride : 0));
+        uniformShadowLocation.assign(locationMax + 1, UniformShadowLocation());
+        uint32_t dataSize = 0;
+        LOOPI(uniformList.size()) {
+            auto& uniform = uniformList[i];
+            const uint32_t size = glTypeToUniformSize(uniform.type);
+            if (!size) continue;
+            //8 byte aligned for double types, the elements of an array are tightly packed like the glUniform*v functions expect them
+            dataSize = alignTo<uint32_t>(dataSize, 8);
+            const int32_t elementCount = uniform.arrayStride ? maximum(uniform.arraySize, 1) : 1;
+            LOOPJ(elementCount) {
+                auto& shadowLocation = uniformShadowLocation[uniform.location + j * uniform.arrayStride];
+                shadowLocation.offset  = dataSize;
+                shadowLocation.size    = size;
+                shadowLocation.type    = uniform.type;
+                shadowLocation.uniform = int32_t(i);
+                dataSize += size;
+            }
+        }
+        uniformShadowData.assign(dataSize, 0);
+    }
+
+    /*
+        Writes count elements of size bytes into the uniform shadow and marks the ones that differ.
+        Returns false if the location is not shadowed (e.g. bool types), then the caller has to set the uniform directly.
+    */
+    bool PipelineInterface::uniformShadowWrite(
+        int32_t     location,
+        int32_t     stride,
+        const void* value,
+        uint32_t    size,
+        int         count
+    ) {
+        UNLIKELY_IF (location < 0) return true; //like glUniform*, ignore writes to location -1
+        UNLIKELY_IF (uint32_t(location) >= uniformShadowLocation.size() || uniformShadowLocation[location].size != size) return false;
+        const uint8_t* src = static_cast<const uint8_t*>(value);
+        LOOPI(count) {
+            const int32_t l = location + int32_t(i) * stride;
+            UNLIKELY_IF (uint32_t(l) >= uniformShadowLocation.size() || uniformShadowLocation[l].size != size) break;
+            auto& shadowLocation = uniformShadowLocation[l];
+            uint8_t* dst = &uniformShadowData[shadowLocation.offset];
+            if (countStateCheck(StatisticsCategory::uniform, !shadowLocation.known || memcmp(dst, src, size) != 0)) {
+                memcpy(dst, src, size);
+                shadowLocation.known = true;
+                if (!shadowLocation.dirty) {
+                    shadowLocation.dirty = true;
+                    uniformShadow_markLocationChange(l);
+                }
+            }
+            src += size;
+        }
+        return true;
+    }
+
+    namespace {
+        //Uniform block and storage block variables in one form, uniform block variables are never part of a top level array
+        struct ReflectedBlockVariable {
+            const string* name;
+            int32_t       type;
+            int32_t       arraySize;
+            int32_t       offset;
+            int32_t       arrayStride;
+            int32_t       matrixStride;
+            bool          matrixRowMajor;
+            int32_t       topLevelArraySize;
+            int32_t       topLevelArrayStride;
+        };
+
+        //Member variables are reported as memberName, BlockName.memberName (blocks with instance name) or topLevelArray[0].memberName,
+        //array variables of storage blocks with a trailing "[0]". Only these prefixes get removed, so memberName never matches a member of a nested struct.
+        bool blockVariableNameMatches(
+            string        variableName,
+            const string& blockName,
+            bool          topLevelArray,
+            const string& memberName
+        ) {
+            if (variableName.size() >= 3 && variableName.compare(variableName.size() - 3, 3, "[0]") == 0) variableName.resize(variableName.size() - 3);
+            if (variableName.size() > blockName.size() && variableName.compare(0, blockName.size(), blockName) == 0 && variableName[blockName.size()] == '.')
+                variableName.erase(0, blockName.size() + 1);
+            if (topLevelArray) {
+                const size_t prefixEnd = variableName.find("[0].");
+                if (prefixEnd == string::npos || variableName.find_first_of(".[") != prefixEnd) return false;
+                variableName.erase(0, prefixEnd + 4);
+            }
+            return variableName == memberName;
+        }
+
+        //Returns the first difference between the description and the reflected variables, or an empty string if they match
+        string verifyBlockLayout(
+            const string&                         blockName,
+            const BlockLayoutDescription&         description,
+            const vector<ReflectedBlockVariable>& variableList
+        ) {
+            int64_t topLevelArrayOffset = -1;
+            for (auto& member : description.member) {
+                const ReflectedBlockVariable* variable = nullptr;
+                for (auto& v : variableList) {
+                    if (!blockVariableNameMatches(*v.name, blockName, v.topLevelArraySize != 1, member.name)) continue;
+                    variable = &v;
+                    break;
+                }
+                const string memberString = "Block layout member " + member.name + " of " + blockName;
+                UNLIKELY_IF (!variable)
+                    return memberString + " is not an active variable of the GLSL block!";
+                UNLIKELY_IF (variable->type != member.type)
+                    return memberString + " is " + gl::typeToGlslAndCNameString(member.type) + " in C++ but " + gl::typeToGlslAndCNameString(variable->type) + " in GLSL!";
+                UNLIKELY_IF (variable->matrixRowMajor)
+                    return memberString + " is a row_major matrix in GLSL, block layout structs only support column-major matrices!";
+
+                //the struct is the element of a top level array (e.g. buffer Light_binding0 {Light light[];}), its offsets are relative to the first element
+                int64_t offset = member.offset;
+                if (variable->topLevelArraySize != 1) {
+                    UNLIKELY_IF (uint32_t(variable->topLevelArrayStride) != description.size)
+                        return memberString + " is part of a top level array with a stride of " + to_string(variable->topLevelArrayStride) + " byte, but the C++ struct has " + to_string(description.size) + " byte!";
+                    if (topLevelArrayOffset < 0) topLevelArrayOffset = int64_t(variable->offset) - int64_t(member.offset);
+                    offset += topLevelArrayOffset;
+                }
+                UNLIKELY_IF (variable->offset != offset)
+                    return memberString + " has the offset " + to_string(offset) + " in C++ but " + to_string(variable->offset) + " in GLSL!";
+                //storage block arrays of unknown size (array[]) report 0
+                UNLIKELY_IF (variable->arraySize != 0 && uint32_t(maximum(variable->arraySize, 1)) != member.arraySize)
+                    return memberString + " has the array size " + to_string(member.arraySize) + " in C++ but " + to_string(variable->arraySize) + " in GLSL!";
+                UNLIKELY_IF (member.arraySize > 1 && uint32_t(variable->arrayStride) != member.arrayStride)
+                    return memberString + " has the array stride " + to_string(member.arrayStride) + " in C++ but " + to_string(variable->arrayStride) + " in GLSL!";
+                UNLIKELY_IF (member.matrixStride && uint32_t(variable->matrixStride) != member.matrixStride)
+                    return memberString + " has the matrix stride " + to_string(member.matrixStride) + " in C++ but " + to_string(variable->matrixStride) + " in GLSL!";
+            }
+            return "";
+        }
+    }
+
+    /**
+        \brief Throws if the block layout struct of description does not match the uniform block blockName of this pipeline
+
+        \details Block layout structs are C++ structs whose members get the offsets of the std140 or std430 rules at compile time.
+        Their memory can be uploaded into a buffer as it is, with a single copyFromMemory, instead of writing every member into place.
+        This compares the offset, type, array size, array stride and matrix stride of every described member against the reflection of the pipeline,
+        usually once in the constructor of the pipeline.
+
+        \code{.cpp}
+            //layout(std140) uniform Object_binding0 {mat4 model; vec4 rgba; float roughness; float weight[4];};
+            using Weight = glCompact::BlockArray<float, 4, glCompact::BlockLayoutRule::std140>;
+            struct Object {
+                GLCOMPACT_BLOCK_LAYOUT(std140);
+                GLCOMPACT_BLOCK_MEMBER(glm::mat4, model);
+                GLCOMPACT_BLOCK_MEMBER(glm::vec4, rgba);
+                GLCOMPACT_BLOCK_MEMBER(float,     roughness);
+                GLCOMPACT_BLOCK_MEMBER(Weight,    weight);
+            };
+            static_assert(offsetof(Object, weight) == 96, "");
+
+            myPipeline.verifyUniformBlockLayout("Object_binding0", glCompact::BlockLayoutDescription::create<Object>({
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Object, model),
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Object, rgba),
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Object, roughness),
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Object, weight)
+            }));
+        \endcode
+
+        Matrices with padded columns (e.g. mat3) are declared as BlockMatrix, arrays as BlockArray.
+        Members of the GLSL block that are not described are not checked. Members of nested structs can not be described.
+        Waits for a pipeline created with PipelineCompileMode::async to be ready.
+    */
+    void PipelineInterface::verifyUniformBlockLayout(
+        const std::string&            blockName,
+        const BlockLayoutDescription& description
+    ) {
+        UNLIKELY_IF (loadPending) waitReady();
+        const UniformBlock* uniformBlock = findUniformBlock(blockName);
+        UNLIKELY_IF (!uniformBlock)
+            error("verifyUniformBlockLayout did not find a uniform block with the name \"" + blockName + "\"!");
+        vector<ReflectedBlockVariable> variableList;
+        for (auto& u : uniformBlock->uniform)
+            variableList.push_back({&u.name, u.type, u.arraySize, u.offset, u.arrayStride, u.matrixStride, u.matrixRowMajor, 1, 0});
+        const string mismatch = verifyBlockLayout(blockName, description, variableList);
+        UNLIKELY_IF (!mismatch.empty()) error(mismatch);
+    }
+
+    /**
+        \brief Throws if the block layout struct of description does not match the storage block blockName of this pipeline
+
+        \details Like verifyUniformBlockLayout(). The struct can also describe the element of a top level array, e.g. of an array of unknown size,
+        whose elements are tightly packed with sizeof(struct) in std430. A std::vector of the struct then is uploaded with a single copyFromMemory.
+
+        \code{.cpp}
+            //layout(std430) buffer Light_binding0 {Light light[];}; with struct Light {vec3 position; float radius; vec3 color; uint flags;};
+            struct Light {
+                GLCOMPACT_BLOCK_LAYOUT(std430);
+                GLCOMPACT_BLOCK_MEMBER(glm::vec3, position);
+                GLCOMPACT_BLOCK_MEMBER(float,     radius);
+                GLCOMPACT_BLOCK_MEMBER(glm::vec3, color);
+                GLCOMPACT_BLOCK_MEMBER(uint32_t,  flags);
+            };
+            static_assert(sizeof(Light) == 32, "");
+
+            myPipeline.verifyStorageBlockLayout("Light_binding0", glCompact::BlockLayoutDescription::create<Light>({
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, position),
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, radius),
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, color),
+                GLCOMPACT_BLOCK_LAYOUT_MEMBER(Light, flags)
+            }));
+            lightBuffer.copyFromMemory(lightList.data(), 0, lightList.size() * sizeof(Light));
+        \endcode
+    */
+    void PipelineInterface::verifyStorageBlockLayout(
+        const std::string&            blockName,
+        const BlockLayoutDescription& description
+    ) {
+        UNLIKELY_IF (loadPending) waitReady();
+        const StorageBlock* storageBlock = findStorageBlock(blockName);
+        UNLIKELY_IF (!storageBlock)
+            error("verifyStorageBlockLayout did not find a storage block with the name \"" + blockName + "\"!");
+        vector<ReflectedBlockVariable> variableList;
+        for (auto& v : storageBlock->variable)
+            variableList.push_back({&v.name, v.type, v.arraySize, v.offset, v.arrayStride, v.matrixStride, v.matrixRowMajor, v.topLevelArraySize, v.topLevelArrayStride});
+        const string mismatch = verifyBlockLayout(blockName, description, variableList);
+        UNLIKELY_IF (!mismatch.empty()) error(mismatch);
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const GLfloat& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform1f(shaderId , uniformLocation, value);
         } else {
@@ -504,6 +800,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec2& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform2f(shaderId , uniformLocation, value[0], value[1]);
         } else {
@@ -513,6 +810,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec3& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform3f(shaderId , uniformLocation, value[0], value[1], value[2]);
         } else {
@@ -522,6 +820,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec4& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform4f(shaderId , uniformLocation, value[0], value[1], value[2], value[3]);
         } else {
@@ -531,6 +830,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const GLdouble& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform1d(shaderId , uniformLocation, value);
         } else {
@@ -540,6 +840,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dvec2& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform2d(shaderId , uniformLocation, value[0], value[1]);
         } else {
@@ -549,6 +850,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dvec3& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform3d(shaderId , uniformLocation, value[0], value[1], value[2]);
         } else {
@@ -558,6 +860,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dvec4& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform4d(shaderId , uniformLocation, value[0], value[1], value[2], value[3]);
         } else {
@@ -567,6 +870,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const int32_t& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform1i(shaderId , uniformLocation, value);
         } else {
@@ -576,6 +880,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::ivec2& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform2i(shaderId , uniformLocation, value[0], value[1]);
         } else {
@@ -585,6 +890,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::ivec3& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform3i(shaderId , uniformLocation, value[0], value[1], value[2]);
         } else {
@@ -594,6 +900,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::ivec4& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform4i(shaderId , uniformLocation, value[0], value[1], value[2], value[3]);
         } else {
@@ -603,6 +910,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const GLuint& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform1ui(shaderId , uniformLocation, value);
         } else {
@@ -612,6 +920,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::uvec2& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform2ui(shaderId , uniformLocation, value[0], value[1]);
         } else {
@@ -621,6 +930,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::uvec3& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform3ui(shaderId , uniformLocation, value[0], value[1], value[2]);
         } else {
@@ -630,6 +940,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::uvec4& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects) {
             threadContextGroup_->functions.glProgramUniform4ui(shaderId , uniformLocation, value[0], value[1], value[2], value[3]);
         } else {
@@ -639,6 +950,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const GLfloat& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform1fv(shaderId, uniformLocation, count, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -648,6 +960,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform2fv(shaderId, uniformLocation, count, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -657,6 +970,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform3fv(shaderId, uniformLocation, count, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -666,6 +980,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::vec4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform4fv(shaderId, uniformLocation, count, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -676,6 +991,7 @@ namespace glCompact {
 
     //NOTE: There are no EXT DSA functions for setting double uniforms
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const GLdouble& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform1dv(shaderId, uniformLocation, count, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -685,6 +1001,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dvec2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform2dv(shaderId, uniformLocation, count, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -694,6 +1011,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dvec3 &value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform3dv(shaderId, uniformLocation, count, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -703,6 +1021,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dvec4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform4dv(shaderId, uniformLocation, count, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -712,6 +1031,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const int32_t& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform1iv(shaderId, uniformLocation, count, reinterpret_cast<const GLint*>(&value));
         else {
@@ -721,6 +1041,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::ivec2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform2iv(shaderId, uniformLocation, count, reinterpret_cast<const GLint*>(&value));
         else {
@@ -730,6 +1051,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::ivec3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform3iv(shaderId, uniformLocation, count, reinterpret_cast<const GLint*>(&value));
         else {
@@ -739,6 +1061,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::ivec4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform4iv(shaderId, uniformLocation, count, reinterpret_cast<const GLint*>(&value));
         else {
@@ -748,6 +1071,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const GLuint& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform1uiv(shaderId, uniformLocation, count, reinterpret_cast<const GLuint*>(&value));
         else {
@@ -757,6 +1081,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::uvec2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform2uiv(shaderId, uniformLocation, count, reinterpret_cast<const GLuint*>(&value));
         else {
@@ -766,6 +1091,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::uvec3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform3uiv(shaderId, uniformLocation, count, reinterpret_cast<const GLuint*>(&value));
         else {
@@ -775,6 +1101,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::uvec4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniform4uiv(shaderId, uniformLocation, count, reinterpret_cast<const GLuint*>(&value));
         else {
@@ -786,6 +1113,7 @@ namespace glCompact {
     //NOTE: transpose can be done with glm, therefor we ignore the transpose value for the gl function
     //TODO: row-major order. or column-major the default?
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat2x2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix2fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -795,6 +1123,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat2x3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix2x3fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -804,6 +1133,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat2x4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix2x4fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -813,6 +1143,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat3x2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix3x2fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -822,6 +1153,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat3x3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix3fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -831,6 +1163,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat3x4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix3x4fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -840,6 +1173,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat4x2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix4x2fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -849,6 +1183,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat4x3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix4x3fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -858,6 +1193,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::mat4x4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix4fv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLfloat*>(&value));
         else {
@@ -868,6 +1204,7 @@ namespace glCompact {
 
     //NOTE: There are no EXT DSA functions for setting double uniforms
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat2x2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix2dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -877,6 +1214,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat2x3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix2x3dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -886,6 +1224,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat2x4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix2x4dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -895,6 +1234,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat3x2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix3x2dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -904,6 +1244,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat3x3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix3dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -913,6 +1254,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat3x4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix3x4dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -922,6 +1264,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat4x2& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix4x2dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -931,6 +1274,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat4x3& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix4x3dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -940,6 +1284,7 @@ namespace glCompact {
     }
 
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const glm::dmat4x4& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS && threadContextGroup_->extensions.GL_ARB_separate_shader_objects)
             threadContextGroup_->functions.glProgramUniformMatrix4dv(shaderId, uniformLocation, count, false, reinterpret_cast<const GLdouble*>(&value));
         else {
@@ -950,6 +1295,7 @@ namespace glCompact {
 
     //GL_ARB_bindless_texture (not core)
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const uint64_t& value) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS) {
             threadContextGroup_->functions.glProgramUniformHandleui64ARB(shaderId, uniformLocation, value);
         } else {
@@ -960,6 +1306,7 @@ namespace glCompact {
 
     //GL_ARB_bindless_texture (not core)
     void PipelineInterface::setUniform(uint32_t shaderId, int32_t uniformLocation, const uint64_t& value, int count) {
+        threadContext_->flushDrawBatch();
         if (config::ENABLE_USE_OF_DSA_UNIFORM_FUNCTIONS) {
             threadContextGroup_->functions.glProgramUniformHandleui64vARB(shaderId, uniformLocation, count, reinterpret_cast<const GLuint64*>(&value));
         } else {
@@ -1008,6 +1355,13 @@ namespace glCompact {
         image_changedSlotMax = maximum(image_changedSlotMax, slot);
     }
 
+    void PipelineInterface::uniformShadow_markLocationChange(
+        int32_t location
+    ) {
+        uniformShadow_changedLocationMin = minimum(uniformShadow_changedLocationMin, location);
+        uniformShadow_changedLocationMax = maximum(uniformShadow_changedLocationMax, location);
+    }
+
     /*
         Functions to read values of uniforms
 
@@ -1255,8 +1609,9 @@ namespace glCompact {
                         + " -> " + ru.name
                     );
                 setUniform(id, ru.location, binding);
-                samplerList[binding].name = ru.name;
-                samplerList[binding].type = ru.type;
+                samplerList[binding].name     = ru.name;
+                samplerList[binding].type     = ru.type;
+                samplerList[binding].location = ru.location;
 
 
             } else if (gl::typeIsImage(ru.type)) {
@@ -1280,8 +1635,9 @@ namespace glCompact {
                         + " -> " + ru.name
                     );
                 setUniform(id, ru.location, binding);
-                imageList[binding].name = ru.name;
-                imageList[binding].type = ru.type;
+                imageList[binding].name     = ru.name;
+                imageList[binding].type     = ru.type;
+                imageList[binding].location = ru.location;
 
             //} else if (ru.type == GL_UNSIGNED_INT_ATOMIC_COUNTER) {
             } else if (ru.location != -1) {
@@ -1326,6 +1682,7 @@ namespace glCompact {
                         + " -> layout(binding = " + to_string(layoutQualifierBinding) + ") " + uniformBlock.name
                     );
                 threadContextGroup_->functions.glUniformBlockBinding(id, blockIndex, binding);
+                uniformBlock.binding = binding;
                 threadContextGroup_->functions.glGetActiveUniformBlockiv(id, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &uniformBlock.blockSize);
                 threadContextGroup_->functions.glGetActiveUniformBlockiv(id, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &uniformCount);
                 vector<uint32_t> uniformIndexList(uniformCount); //index into raw uniform list
@@ -1455,13 +1812,161 @@ namespace glCompact {
                 storageBlockList.push_back(sb);
             }
         }
+        updateBindingCount();
+        buildNameIndex();
+
+        if (detectedAtomicCounter)
+            warning("Warning detected atomic counter variables, glCompact does not support them! (Real hardware support only exist in some AMD devices, other vendors use SSBO atomics)");
+    }
+
+    void PipelineInterface::updateBindingCount() {
         sampler_count               = samplerList.size();
         for (const auto& ub : uniformBlockList) buffer_uniform_count = max<size_t>(buffer_uniform_count, ub.binding + 1);
         image_count                 = imageList.size();
         for (const auto& sb : storageBlockList) buffer_shaderStorage_count = max<size_t>(buffer_shaderStorage_count, sb.binding + 1);
+    }
 
-        if (detectedAtomicCounter)
-            warning("Warning detected atomic counter variables, glCompact does not support them! (Real hardware support only exist in some AMD devices, other vendors use SSBO atomics)");
+    /*
+        Serializes everything collectInformation() gathered, for the program cache. Must be kept in the same order as readInformation()!
+    */
+    void PipelineInterface::writeInformation(
+        ProgramCacheWriter_& writer
+    ) const {
+        writer.write(uint32_t(attributeList.size()));
+        for (const auto& attribute : attributeList) {
+            writer.write(attribute.name);
+            writer.write(attribute.type);
+            writer.write(attribute.arraySize);
+        }
+
+        writer.write(uint32_t(uniformList.size()));
+        for (const auto& uniform : uniformList) {
+            writer.write(uniform.name);
+            writer.write(uniform.location);
+            writer.write(uniform.type);
+            writer.write(uniform.arraySize);
+            writer.write(uniform.arrayStride);
+        }
+
+        for (auto bindingUniformList : {&samplerList, &imageList}) {
+            writer.write(uint32_t(bindingUniformList->size()));
+            for (const auto& bindingUniform : *bindingUniformList) {
+                writer.write(bindingUniform.name);
+                writer.write(bindingUniform.type);
+                writer.write(bindingUniform.location);
+            }
+        }
+
+        writer.write(uint32_t(uniformBlockList.size()));
+        for (const auto& uniformBlock : uniformBlockList) {
+            writer.write(uniformBlock.name);
+            writer.write(uniformBlock.binding);
+            writer.write(uniformBlock.blockSize);
+            writer.write(uint32_t(uniformBlock.uniform.size()));
+            for (const auto& uniform : uniformBlock.uniform) {
+                writer.write(uniform.name);
+                writer.write(uniform.type);
+                writer.write(uniform.arraySize);
+                writer.write(uniform.offset);
+                writer.write(uniform.arrayStride);
+                writer.write(uniform.matrixStride);
+                writer.write(uint8_t(uniform.matrixRowMajor));
+            }
+        }
+
+        writer.write(uint32_t(storageBlockList.size()));
+        for (const auto& storageBlock : storageBlockList) {
+            writer.write(storageBlock.name);
+            writer.write(storageBlock.binding);
+            writer.write(uint32_t(storageBlock.variable.size()));
+            for (const auto& variable : storageBlock.variable) {
+                writer.write(variable.name);
+                writer.write(variable.type);
+                writer.write(variable.arraySize);
+                writer.write(variable.offset);
+                writer.write(variable.arrayStride);
+                writer.write(variable.matrixStride);
+                writer.write(uint8_t(variable.matrixRowMajor));
+                writer.write(variable.topLevelArraySize);
+                writer.write(variable.topLevelArrayStride);
+            }
+        }
+    }
+
+    /*
+        Replaces collectInformation() for a program loaded from the program cache. Does not issue any introspection queries.
+        The sampler/image uniform values and uniform block bindings that collectInformation() sets are not reliably part of a program binary, so they are set again.
+    */
+    void PipelineInterface::readInformation(
+        ProgramCacheReader_& reader
+    ) {
+        attributeList.resize(reader.read<uint32_t>());
+        for (auto& attribute : attributeList) {
+            reader.read(attribute.name);
+            reader.read(attribute.type);
+            reader.read(attribute.arraySize);
+        }
+
+        uniformList.resize(reader.read<uint32_t>());
+        for (auto& uniform : uniformList) {
+            reader.read(uniform.name);
+            reader.read(uniform.location);
+            reader.read(uniform.type);
+            reader.read(uniform.arraySize);
+            reader.read(uniform.arrayStride);
+        }
+
+        for (auto bindingUniformList : {&samplerList, &imageList}) {
+            bindingUniformList->resize(reader.read<uint32_t>());
+            LOOPI(bindingUniformList->size()) {
+                auto& bindingUniform = (*bindingUniformList)[i];
+                reader.read(bindingUniform.name);
+                reader.read(bindingUniform.type);
+                reader.read(bindingUniform.location);
+                if (bindingUniform.type) setUniform(id, bindingUniform.location, int32_t(i));
+            }
+        }
+
+        uniformBlockList.resize(reader.read<uint32_t>());
+        LOOPI(uniformBlockList.size()) {
+            auto& uniformBlock = uniformBlockList[i];
+            reader.read(uniformBlock.name);
+            reader.read(uniformBlock.binding);
+            reader.read(uniformBlock.blockSize);
+            uniformBlock.uniform.resize(reader.read<uint32_t>());
+            for (auto& uniform : uniformBlock.uniform) {
+                reader.read(uniform.name);
+                reader.read(uniform.type);
+                reader.read(uniform.arraySize);
+                reader.read(uniform.offset);
+                reader.read(uniform.arrayStride);
+                reader.read(uniform.matrixStride);
+                uniform.matrixRowMajor = reader.read<uint8_t>() != 0;
+            }
+            //uniformBlockList is filled in active uniform block index order
+            threadContextGroup_->functions.glUniformBlockBinding(id, uint32_t(i), uniformBlock.binding);
+        }
+
+        storageBlockList.resize(reader.read<uint32_t>());
+        for (auto& storageBlock : storageBlockList) {
+            reader.read(storageBlock.name);
+            reader.read(storageBlock.binding);
+            storageBlock.variable.resize(reader.read<uint32_t>());
+            for (auto& variable : storageBlock.variable) {
+                reader.read(variable.name);
+                reader.read(variable.type);
+                reader.read(variable.arraySize);
+                reader.read(variable.offset);
+                reader.read(variable.arrayStride);
+                reader.read(variable.matrixStride);
+                variable.matrixRowMajor = reader.read<uint8_t>() != 0;
+                reader.read(variable.topLevelArraySize);
+                reader.read(variable.topLevelArrayStride);
+            }
+        }
+
+        updateBindingCount();
+        buildNameIndex();
     }
 
     void PipelineInterface::allocateMemory() {
@@ -1483,8 +1988,23 @@ namespace glCompact {
         multiMallocPtr = multiMalloc(md, sizeof(md));
     }
 
+    //True if the next processPendingChanges() of this pipeline, assuming it is still bound, would emit any GL commands
+    bool PipelineInterface::hasPendingChanges() const {
+        return loadPending
+            || buffer_uniform_changedSlotMin       <= buffer_uniform_changedSlotMax
+            || buffer_shaderStorage_changedSlotMin <= buffer_shaderStorage_changedSlotMax
+            || texture_changedSlotMin              <= texture_changedSlotMax
+            || sampler_changedSlotMin              <= sampler_changedSlotMax
+            || image_changedSlotMin                <= image_changedSlotMax
+            || uniformShadow_changedLocationMin    <= uniformShadow_changedLocationMax
+            || threadContext_->memoryBarrierMask;
+    }
+
     void PipelineInterface::processPendingChanges() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (loadPending) waitReady();
         threadContext_->cachedBindShader(id); //glCompact::PipelineX and shaderId binding are independent! (e.g. setting a uniform will bind the shaderId in the background)
+        processPendingChangesUniformShadow();
         processPendingChangesBuffersUniform();
         processPendingChangesBuffersShaderStorage();
         processPendingChangesTextures();
@@ -1547,7 +2067,7 @@ namespace glCompact {
                     changedSlotMax--;
                 }
 
-                if (changedSlotMin <= changedSlotMax) {
+                if (countStateCheck(StatisticsCategory::uniformBuffer, changedSlotMin <= changedSlotMax)) {
                     const uint32_t    count        = changedSlotMax - changedSlotMin + 1;
                     const uint32_t*   bufferIdList =                                     &buffer_uniform_id    [changedSlotMin];
                     const GLintptr*   offsetList   = reinterpret_cast<const GLintptr*>  (&buffer_uniform_offset[changedSlotMin]);
@@ -1556,9 +2076,10 @@ namespace glCompact {
                 }
             } else {
                 for (int i = changedSlotMin; i <= changedSlotMax; ++i) {
-                    if (threadContext_->buffer_uniform_id    [i] != buffer_uniform_id    [i]
+                    if (countStateCheck(StatisticsCategory::uniformBuffer,
+                        threadContext_->buffer_uniform_id    [i] != buffer_uniform_id    [i]
                     ||  threadContext_->buffer_uniform_offset[i] != buffer_uniform_offset[i]
-                    ||  threadContext_->buffer_uniform_size  [i] != buffer_uniform_size  [i])
+                    ||  threadContext_->buffer_uniform_size  [i] != buffer_uniform_size  [i]))
                         threadContextGroup_->functions.glBindBufferRange(GL_UNIFORM_BUFFER, i, buffer_uniform_id[i], buffer_uniform_offset[i], buffer_uniform_size[i]);
                 }
             }
@@ -1588,6 +2109,7 @@ namespace glCompact {
 
         if (changedSlotMin <= changedSlotMax) {
             if (threadContextGroup_->extensions.GL_ARB_multi_bind) {
+                countStateCheck(StatisticsCategory::shaderStorageBuffer, true); //unchanged slots are not filtered out here
                 const uint32_t    count        = changedSlotMax - changedSlotMin + 1;
                 const uint32_t*   bufferIdList =                                     &buffer_shaderStorage_id    [changedSlotMin];
                 const GLintptr*   offsetList   = reinterpret_cast<const GLintptr*>  (&buffer_shaderStorage_offset[changedSlotMin]);
@@ -1595,9 +2117,10 @@ namespace glCompact {
                 threadContextGroup_->functions.glBindBuffersRange(GL_SHADER_STORAGE_BUFFER, changedSlotMin, count, bufferIdList, offsetList, sizeList);
             } else {
                 for (int i = changedSlotMin; i <= changedSlotMax; ++i) {
-                    if (threadContext_->buffer_shaderStorage_id    [i] != buffer_shaderStorage_id    [i]
+                    if (countStateCheck(StatisticsCategory::shaderStorageBuffer,
+                        threadContext_->buffer_shaderStorage_id    [i] != buffer_shaderStorage_id    [i]
                     ||  threadContext_->buffer_shaderStorage_offset[i] != buffer_shaderStorage_offset[i]
-                    ||  threadContext_->buffer_shaderStorage_size  [i] != buffer_shaderStorage_size  [i])
+                    ||  threadContext_->buffer_shaderStorage_size  [i] != buffer_shaderStorage_size  [i]))
                         threadContextGroup_->functions.glBindBufferRange(GL_SHADER_STORAGE_BUFFER, i, buffer_shaderStorage_id[i], buffer_shaderStorage_offset[i], buffer_shaderStorage_size[i]);
                 }
             }
@@ -1630,7 +2153,7 @@ namespace glCompact {
                     changedSlotMax--;
                 }
 
-                if (changedSlotMin <= changedSlotMax) {
+                if (countStateCheck(StatisticsCategory::texture, changedSlotMin <= changedSlotMax)) {
                           uint32_t  count       = changedSlotMax - changedSlotMin + 1;
                     const uint32_t* textureList = &texture_id[changedSlotMin];
                     threadContextGroup_->functions.glBindTextures(changedSlotMin, count, textureList);
@@ -1663,7 +2186,7 @@ namespace glCompact {
                     changedSlotMax--;
                 }
 
-                if (changedSlotMin <= changedSlotMax) {
+                if (countStateCheck(StatisticsCategory::sampler, changedSlotMin <= changedSlotMax)) {
                     GLsizei count = changedSlotMax - changedSlotMin + 1;
                     const uint32_t* samplerList = &sampler_id[changedSlotMin];
                     threadContextGroup_->functions.glBindSamplers(changedSlotMin, count, samplerList);
@@ -1672,7 +2195,7 @@ namespace glCompact {
                 }
             } else {
                 for (int i = changedSlotMin; i <= changedSlotMax; ++i) {
-                    if (isDiffThenAssign(threadContext_->sampler_id[i], sampler_id[i])) {
+                    if (countStateCheck(StatisticsCategory::sampler, isDiffThenAssign(threadContext_->sampler_id[i], sampler_id[i]))) {
                         threadContextGroup_->functions.glBindSampler(i, sampler_id[i]);
                     }
                 }
@@ -1699,12 +2222,12 @@ namespace glCompact {
 
         if (changedSlotMin <= changedSlotMax) {
             for (int i = changedSlotMin; i <= changedSlotMax; ++i) {
-                if (isDiffThenAssign(
+                if (countStateCheck(StatisticsCategory::image, isDiffThenAssign(
                     threadContext_->image_id         [i], image_id         [i],
                     threadContext_->image_format     [i], image_format     [i],
                     threadContext_->image_mipmapLevel[i], image_mipmapLevel[i],
                     threadContext_->image_layer      [i], image_layer      [i]
-                )) {
+                ))) {
                     if (image_id[i]) {
                         if (image_layer[i] == -1) {
                             threadContextGroup_->functions.glBindImageTexture(i, image_id[i], image_mipmapLevel[i], 0,              0, GL_READ_WRITE, image_format[i]);
@@ -1722,6 +2245,31 @@ namespace glCompact {
         }
     }
 
+    //Uploads the changed uniform shadow locations, the program must be bound
+    void PipelineInterface::processPendingChangesUniformShadow() {
+        if (uniformShadow_changedLocationMin > uniformShadow_changedLocationMax) return;
+        int32_t l = uniformShadow_changedLocationMin;
+        while (l <= uniformShadow_changedLocationMax) {
+            const auto& shadowLocation = uniformShadowLocation[l];
+            if (!shadowLocation.dirty) {
+                l++;
+                continue;
+            }
+            //consecutive changed elements of the same uniform array go into one call
+            int32_t count = 1;
+            while (l + count <= uniformShadow_changedLocationMax
+            &&     uniformShadowLocation[l + count].dirty
+            &&     uniformShadowLocation[l + count].uniform == shadowLocation.uniform
+            &&     uniformShadowLocation[l + count].offset  == shadowLocation.offset + uint32_t(count) * shadowLocation.size)
+                count++;
+            LOOPI(count) uniformShadowLocation[l + i].dirty = false;
+            uploadUniform(shadowLocation.type, l, count, &uniformShadowData[shadowLocation.offset]);
+            l += count;
+        }
+        uniformShadow_changedLocationMin = std::numeric_limits<decltype(uniformShadow_changedLocationMin)>::max();
+        uniformShadow_changedLocationMax = -1;
+    }
+
     string PipelineInterface::glTypeToGlslName(int32_t type) {
         return gl::typeToGlslAndCNameString(type);
     }
@@ -1729,4 +2277,90 @@ namespace glCompact {
     string PipelineInterface::glTypeToCppName(int32_t type) {
         return gl::typeToCppTypeNameString(type);
     }
+
+    //Byte size of one element of a uniform type that UniformSetter can set, 0 for all others
+    uint32_t PipelineInterface::glTypeToUniformSize(int32_t type) {
+        switch (type) {
+            case GL_FLOAT:              return  4;
+            case GL_FLOAT_VEC2:         return  8;
+            case GL_FLOAT_VEC3:         return 12;
+            case GL_FLOAT_VEC4:         return 16;
+            case GL_INT:                return  4;
+            case GL_INT_VEC2:           return  8;
+            case GL_INT_VEC3:           return 12;
+            case GL_INT_VEC4:           return 16;
+            case GL_UNSIGNED_INT:       return  4;
+            case GL_UNSIGNED_INT_VEC2:  return  8;
+            case GL_UNSIGNED_INT_VEC3:  return 12;
+            case GL_UNSIGNED_INT_VEC4:  return 16;
+            case GL_DOUBLE:             return  8;
+            case GL_DOUBLE_VEC2:        return 16;
+            case GL_DOUBLE_VEC3:        return 24;
+            case GL_DOUBLE_VEC4:        return 32;
+            case GL_FLOAT_MAT2:         return  4 * 4;
+            case GL_FLOAT_MAT2x3:       return  6 * 4;
+            case GL_FLOAT_MAT2x4:       return  8 * 4;
+            case GL_FLOAT_MAT3x2:       return  6 * 4;
+            case GL_FLOAT_MAT3:         return  9 * 4;
+            case GL_FLOAT_MAT3x4:       return 12 * 4;
+            case GL_FLOAT_MAT4x2:       return  8 * 4;
+            case GL_FLOAT_MAT4x3:       return 12 * 4;
+            case GL_FLOAT_MAT4:         return 16 * 4;
+            case GL_DOUBLE_MAT2:        return  4 * 8;
+            case GL_DOUBLE_MAT2x3:      return  6 * 8;
+            case GL_DOUBLE_MAT2x4:      return  8 * 8;
+            case GL_DOUBLE_MAT3x2:      return  6 * 8;
+            case GL_DOUBLE_MAT3:        return  9 * 8;
+            case GL_DOUBLE_MAT3x4:      return 12 * 8;
+            case GL_DOUBLE_MAT4x2:      return  8 * 8;
+            case GL_DOUBLE_MAT4x3:      return 12 * 8;
+            case GL_DOUBLE_MAT4:        return 16 * 8;
+        }
+        return 0;
+    }
+
+    //Sets count elements of a uniform of the bound program from tightly packed values, type must be one glTypeToUniformSize() knows
+    void PipelineInterface::uploadUniform(int32_t type, int32_t uniformLocation, int count, const void* value) {
+        auto& functions = threadContextGroup_->functions;
+        const GLfloat*  f = static_cast<const GLfloat* >(value);
+        const GLdouble* d = static_cast<const GLdouble*>(value);
+        const GLint*    i = static_cast<const GLint*   >(value);
+        const GLuint*   u = static_cast<const GLuint*  >(value);
+        switch (type) {
+            case GL_FLOAT:              functions.glUniform1fv        (uniformLocation, count,        f); break;
+            case GL_FLOAT_VEC2:         functions.glUniform2fv        (uniformLocation, count,        f); break;
+            case GL_FLOAT_VEC3:         functions.glUniform3fv        (uniformLocation, count,        f); break;
+            case GL_FLOAT_VEC4:         functions.glUniform4fv        (uniformLocation, count,        f); break;
+            case GL_INT:                functions.glUniform1iv        (uniformLocation, count,        i); break;
+            case GL_INT_VEC2:           functions.glUniform2iv        (uniformLocation, count,        i); break;
+            case GL_INT_VEC3:           functions.glUniform3iv        (uniformLocation, count,        i); break;
+            case GL_INT_VEC4:           functions.glUniform4iv        (uniformLocation, count,        i); break;
+            case GL_UNSIGNED_INT:       functions.glUniform1uiv       (uniformLocation, count,        u); break;
+            case GL_UNSIGNED_INT_VEC2:  functions.glUniform2uiv       (uniformLocation, count,        u); break;
+            case GL_UNSIGNED_INT_VEC3:  functions.glUniform3uiv       (uniformLocation, count,        u); break;
+            case GL_UNSIGNED_INT_VEC4:  functions.glUniform4uiv       (uniformLocation, count,        u); break;
+            case GL_DOUBLE:             functions.glUniform1dv        (uniformLocation, count,        d); break;
+            case GL_DOUBLE_VEC2:        functions.glUniform2dv        (uniformLocation, count,        d); break;
+            case GL_DOUBLE_VEC3:        functions.glUniform3dv        (uniformLocation, count,        d); break;
+            case GL_DOUBLE_VEC4:        functions.glUniform4dv        (uniformLocation, count,        d); break;
+            case GL_FLOAT_MAT2:         functions.glUniformMatrix2fv  (uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT2x3:       functions.glUniformMatrix2x3fv(uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT2x4:       functions.glUniformMatrix2x4fv(uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT3x2:       functions.glUniformMatrix3x2fv(uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT3:         functions.glUniformMatrix3fv  (uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT3x4:       functions.glUniformMatrix3x4fv(uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT4x2:       functions.glUniformMatrix4x2fv(uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT4x3:       functions.glUniformMatrix4x3fv(uniformLocation, count, false, f); break;
+            case GL_FLOAT_MAT4:         functions.glUniformMatrix4fv  (uniformLocation, count, false, f); break;
+            case GL_DOUBLE_MAT2:        functions.glUniformMatrix2dv  (uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT2x3:      functions.glUniformMatrix2x3dv(uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT2x4:      functions.glUniformMatrix2x4dv(uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT3x2:      functions.glUniformMatrix3x2dv(uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT3:        functions.glUniformMatrix3dv  (uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT3x4:      functions.glUniformMatrix3x4dv(uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT4x2:      functions.glUniformMatrix4x2dv(uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT4x3:      functions.glUniformMatrix4x3dv(uniformLocation, count, false, d); break;
+            case GL_DOUBLE_MAT4:        functions.glUniformMatrix4dv  (uniformLocation, count, false, d); break;
+        }
+    }
 }
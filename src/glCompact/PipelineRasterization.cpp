@@ -7,11 +7,14 @@
 #include "glCompact/BufferGpu.hpp"
 #include "glCompact/minimumMaximum.hpp"
 #include "glCompact/Debug.hpp"
+#include "glCompact/ProgramCache_.hpp"
+#include "glCompact/PipelineCompiler_.hpp"
 
 #include "glCompact/Tools_.hpp"
 #include "glCompact/gl/Helper.hpp"
 
 #include "glCompact/isDiffThenAssign.hpp"
+#include "glCompact/Statistics_.hpp"
 
 #include <glm/glm.hpp>
 #include <vector>
@@ -40,15 +43,31 @@ namespace glCompact {
      * Use PipelineRasterization myPipeline(PipelineRasterizationFromStrings(...));
      */
     PipelineRasterization::PipelineRasterization(
-        Primitive          primitive,
-        const std::string& vertexString,
-        const std::string& tessControlString,
-        const std::string& tessEvalutionString,
-        const std::string& geometryString,
-        const std::string& fragmentString
+        Primitive           primitive,
+        const std::string&  vertexString,
+        const std::string&  tessControlString,
+        const std::string&  tessEvalutionString,
+        const std::string&  geometryString,
+        const std::string&  fragmentString,
+        PipelineCompileMode compileMode
+    ) :
+        PipelineRasterization(primitive, vertexString, tessControlString, tessEvalutionString, geometryString, fragmentString, TransformFeedbackLayout(), compileMode)
+    {}
+
+    /** \brief loads Graphics GLSL shader from strings, capturing the outputs of transformFeedbackLayout via TransformFeedback
+     */
+    PipelineRasterization::PipelineRasterization(
+        Primitive                      primitive,
+        const std::string&             vertexString,
+        const std::string&             tessControlString,
+        const std::string&             tessEvalutionString,
+        const std::string&             geometryString,
+        const std::string&             fragmentString,
+        const TransformFeedbackLayout& transformFeedbackLayout,
+        PipelineCompileMode            compileMode
     ) {
-        UNLIKELY_IF (!loadStrings_(vertexString, tessControlString, tessEvalutionString, geometryString, fragmentString))
-            throw std::runtime_error(infoLog_);
+        UNLIKELY_IF (!loadStrings_(vertexString, tessControlString, tessEvalutionString, geometryString, fragmentString, transformFeedbackLayout, compileMode))
+            throw std::runtime_error(getLoadErrorString());
         inputPrimitive = primitive;
     }
 
@@ -58,13 +77,30 @@ namespace glCompact {
      * Use PipelineRasterization myPipeline(PipelineRasterizationFromFiles(...));
      */
     PipelineRasterization::PipelineRasterization(
-        const std::string& path,
-        Primitive          primitive,
-        const std::string& vertexFile,
-        const std::string& tessControlFile,
-        const std::string& tessEvalutionFile,
-        const std::string& geometryFile,
-        const std::string& fragmentFile
+        const std::string&  path,
+        Primitive           primitive,
+        const std::string&  vertexFile,
+        const std::string&  tessControlFile,
+        const std::string&  tessEvalutionFile,
+        const std::string&  geometryFile,
+        const std::string&  fragmentFile,
+        PipelineCompileMode compileMode
+    ) :
+        PipelineRasterization(path, primitive, vertexFile, tessControlFile, tessEvalutionFile, geometryFile, fragmentFile, TransformFeedbackLayout(), compileMode)
+    {}
+
+    /** \brief loads Graphics GLSL shader from files, capturing the outputs of transformFeedbackLayout via TransformFeedback
+     */
+    PipelineRasterization::PipelineRasterization(
+        const std::string&             path,
+        Primitive                      primitive,
+        const std::string&             vertexFile,
+        const std::string&             tessControlFile,
+        const std::string&             tessEvalutionFile,
+        const std::string&             geometryFile,
+        const std::string&             fragmentFile,
+        const TransformFeedbackLayout& transformFeedbackLayout,
+        PipelineCompileMode            compileMode
     ):
         loadedFromFiles(true)
     {
@@ -89,12 +125,21 @@ namespace glCompact {
             }
         }
 
-        UNLIKELY_IF (!loadStrings_(fileContent[0], fileContent[1], fileContent[2], fileContent[3], fileContent[4])) {
-            string s = "Error during shader file load\n";
-            LOOPI(5) if (!fileName[i].empty()) s += " " + shaderTypeStringSameLenght[i] + ": " + this->fileName[i] + "\n";
-            s += infoLog_;
-            throw std::runtime_error(s);
-        }
+        UNLIKELY_IF (!loadStrings_(fileContent[0], fileContent[1], fileContent[2], fileContent[3], fileContent[4], transformFeedbackLayout, compileMode))
+            throw std::runtime_error(getLoadErrorString());
+        inputPrimitive = primitive;
+    }
+
+    /** \brief takes over the program of a PipelineCompiler job, blocks if the job is not ready yet
+     */
+    PipelineRasterization::PipelineRasterization(
+        Primitive             primitive,
+        PipelineCompiler::Job job
+    ) {
+        PipelineCompilerJob_& compilerJob = loadCompilerJob_(job, false);
+        LOOPI(5) hasShader[i] = compilerJob.hasShader[i];
+        setDefaultValues();
+        loadInformation_(compilerJob.fromProgramCache ? &compilerJob.programCacheInformation : nullptr);
         inputPrimitive = primitive;
     }
 
@@ -138,6 +183,7 @@ namespace glCompact {
     void PipelineRasterization::setAttributeLayout(
         const AttributeLayout& attributeLayout
     ) {
+        UNLIKELY_IF (loadPending) waitReady();
         const int uppermostActiveBufferIndex = attributeLayout.uppermostActiveBufferIndex;
         const int uppermostActiveLocation    = attributeLayout.uppermostActiveLocation;
 
@@ -666,6 +712,15 @@ namespace glCompact {
         multiSample = enable;
     }
 
+    /** \brief Discard all primitives right before rasterization (default is disabled)
+     * Only the vertex processing stages are executed. Useful when only capturing vertices via TransformFeedback, or for vertex shaders that only write into buffers.
+     * Note that clearing a Frame is not affected by this pipeline setting.
+    */
+    void PipelineRasterization::setRasterizerDiscard(bool enable) {
+        rasterizerDiscard = enable;
+        stateChange.rasterizerDiscard = true;
+    }
+
     void PipelineRasterization::buffer_attribute_markSlotChange(
         int32_t slot
     ) {
@@ -674,18 +729,29 @@ namespace glCompact {
     }
 
     bool PipelineRasterization::loadStrings_(
-        const std::string& stringVertex,
-        const std::string& stringTessControl,
-        const std::string& stringTessEvalution,
-        const std::string& stringGeometry,
-        const std::string& stringFragment
+        const std::string&  stringVertex,
+        const std::string&  stringTessControl,
+        const std::string&  stringTessEvalution,
+        const std::string&  stringGeometry,
+        const std::string&  stringFragment,
+        const TransformFeedbackLayout& transformFeedbackLayout,
+        PipelineCompileMode compileMode
     ) {
+        UNLIKELY_IF (transformFeedbackLayout.needsTransformFeedback3 && !threadContextGroup_->extensions.GL_ARB_transform_feedback3)
+            throw std::runtime_error("TransformFeedbackLayout with addNextBuffer() or addSkip() needs GL_ARB_transform_feedback3 (Core since 4.0)!");
+        UNLIKELY_IF (transformFeedbackLayout.getBufferCount() > TransformFeedback::getMaxBufferCount())
+            throw std::runtime_error("TransformFeedbackLayout uses " + to_string(transformFeedbackLayout.getBufferCount()) + " buffers, but the max. is " + to_string(TransformFeedback::getMaxBufferCount()) + "!");
+
+        //The captured outputs change the linked program, so they are part of the program cache key
+        string transformFeedbackLayoutString;
+        for (auto& varying : transformFeedbackLayout.varying) transformFeedbackLayoutString += varying + "\n";
         const string *const shaderSrc[] = {
             &stringVertex,
             &stringTessControl,
             &stringTessEvalution,
             &stringGeometry,
-            &stringFragment
+            &stringFragment,
+            &transformFeedbackLayoutString
         };
         const GLenum shaderType[] = {
             GL_VERTEX_SHADER,
@@ -694,67 +760,123 @@ namespace glCompact {
             GL_GEOMETRY_SHADER,
             GL_FRAGMENT_SHADER
         };
-        GLuint shaderId[5] = {0};
+
+        //TODO: maybe make this better
+        hasShader[0] = !stringVertex.empty();
+        hasShader[1] = !stringTessControl.empty();
+        hasShader[2] = !stringTessEvalution.empty();
+        hasShader[3] = !stringGeometry.empty();
+        hasShader[4] = !stringFragment.empty();
+        setDefaultValues();
 
         Debug::DisableCallbackInScope disableCallbackInScope;
 
+        //A binary loaded from the cache skips compiling and linking, everything after that is the same
+        loadProgramCacheKey = ProgramCache_::isEnabled() ? ProgramCache_::createKey(shaderSrc, transformFeedbackLayout.isEmpty() ? 5 : 6) : 0;
+        vector<char> programCacheInformation;
+        id = ProgramCache_::load(loadProgramCacheKey, programCacheInformation);
+        if (id) {
+            loadInformation_(&programCacheInformation);
+            return true;
+        }
+
+        //Compile status and link status are only checked in loadResult_(), so with GL_KHR_parallel_shader_compile the driver can do all of it in the background
         LOOPI(5) if (!shaderSrc[i]->empty()) {
             GLuint shaderPartId = threadContextGroup_->functions.glCreateShader(shaderType[i]);
             const char* pCString = shaderSrc[i]->c_str();
             threadContextGroup_->functions.glShaderSource(shaderPartId, 1, reinterpret_cast<const GLchar**>(&pCString), NULL);
             threadContextGroup_->functions.glCompileShader(shaderPartId);
-            GLint compileSuccessful;
-            threadContextGroup_->functions.glGetShaderiv(shaderPartId, GL_COMPILE_STATUS, &compileSuccessful);
-            string shaderLog = getShaderInfoLog(shaderPartId);
-            if (!shaderLog.empty())
-                infoLog_ += shaderTypeString[i] + " LOG:\n" + shaderLog + "\n";
-            shaderId[i] = shaderPartId;
-            if (!compileSuccessful) {
-                LOOPJ(5) if (shaderId[j]) threadContextGroup_->functions.glDeleteShader(shaderId[j]);
-                //throw std::runtime_error("Error loading shader:\n" + infoLog_);
-                infoLog_ = "Error loading shader:\n" + infoLog_;
-                return false;
-            }
+            loadShaderId[i] = shaderPartId;
         }
         id = threadContextGroup_->functions.glCreateProgram();
-        //if (binaryRetrievableHint && threadContextGroup_->extensions.GL_ARB_get_program_binary)
-        //    threadContextGroup_->functions.glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
-        //else
-        //    glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_FALSE);
+        ProgramCache_::setRetrievableHint(id);
 
-        LOOPI(5) if (shaderId[i]) threadContextGroup_->functions.glAttachShader(id, shaderId[i]);
+        LOOPI(5) if (loadShaderId[i]) threadContextGroup_->functions.glAttachShader(id, loadShaderId[i]);
+        if (!transformFeedbackLayout.isEmpty()) {
+            vector<const GLchar*> varyingName;
+            for (auto& varying : transformFeedbackLayout.varying) varyingName.push_back(varying.c_str());
+            threadContextGroup_->functions.glTransformFeedbackVaryings(id, GLsizei(varyingName.size()), varyingName.data(), GL_INTERLEAVED_ATTRIBS);
+        }
         threadContextGroup_->functions.glLinkProgram(id);
 
-        GLint linkStatus;
-        threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
-        string programLog = getProgramInfoLog(id);
-        if (!programLog.empty())
-            infoLog_ += "PROGRAM LINK STATUS:\n" + getProgramInfoLog(id) + "\n";
+        if (compileMode == PipelineCompileMode::async) {
+            loadPending = true;
+            return true;
+        }
+        return loadResult_();
+    }
+
+    /*
+        Second half of loading a program that is not from the program cache. Blocks until the driver is done with compiling and linking.
+    */
+    bool PipelineRasterization::loadResult_() {
+        bool compileSuccessful = true;
+        LOOPI(5) if (loadShaderId[i]) {
+            GLint compileStatus;
+            threadContextGroup_->functions.glGetShaderiv(loadShaderId[i], GL_COMPILE_STATUS, &compileStatus);
+            string shaderLog = getShaderInfoLog(loadShaderId[i]);
+            if (!shaderLog.empty())
+                infoLog_ += shaderTypeString[i] + " LOG:\n" + shaderLog + "\n";
+            compileSuccessful &= compileStatus == GL_TRUE;
+        }
+
+        GLint linkStatus = GL_FALSE;
+        if (compileSuccessful) {
+            threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
+            string programLog = getProgramInfoLog(id);
+            if (!programLog.empty())
+                infoLog_ += "PROGRAM LINK STATUS:\n" + programLog + "\n";
+        }
 
-        LOOPI(5) if (shaderId[i]) {
-            threadContextGroup_->functions.glDetachShader(id, shaderId[i]);
-            threadContextGroup_->functions.glDeleteShader(shaderId[i]);
+        LOOPI(5) if (loadShaderId[i]) {
+            threadContextGroup_->functions.glDetachShader(id, loadShaderId[i]);
+            threadContextGroup_->functions.glDeleteShader(loadShaderId[i]);
+            loadShaderId[i] = 0;
         }
 
-        if (!linkStatus) {
+        if (!compileSuccessful || !linkStatus) {
             threadContextGroup_->functions.glDeleteProgram(id);
             id = 0;
-            //throw std::runtime_error("Error linking shader:\n" + infoLog_);
-            infoLog_ = "Error linking shader:\n" + infoLog_;
+            //throw std::runtime_error("Error loading shader:\n" + infoLog_);
+            infoLog_ = (compileSuccessful ? "Error linking shader:\n" : "Error loading shader:\n") + infoLog_;
             return false;
         }
 
-        //TODO: maybe make this better
-        hasShader[0] = !stringVertex.empty();
-        hasShader[1] = !stringTessControl.empty();
-        hasShader[2] = !stringTessEvalution.empty();
-        hasShader[3] = !stringGeometry.empty();
-        hasShader[4] = !stringFragment.empty();
+        loadInformation_(nullptr);
+        return true;
+    }
 
-        collectInformation();
+    /*
+        Reads the shader information that was stored in the program cache, or collects it from the linked program and stores it in the cache
+    */
+    void PipelineRasterization::loadInformation_(
+        const std::vector<char>* programCacheInformation
+    ) {
+        if (programCacheInformation) {
+            ProgramCacheReader_ reader(*programCacheInformation);
+            readInformation(reader);
+        } else {
+            collectInformation();
+            if (ProgramCache_::isEnabled()) {
+                ProgramCacheWriter_ writer;
+                writeInformation(writer);
+                ProgramCache_::store(loadProgramCacheKey, id, writer.data);
+            }
+        }
         allocateMemory();
-        setDefaultValues();
-        return true;
+    }
+
+    void PipelineRasterization::loadFinish_() {
+        Debug::DisableCallbackInScope disableCallbackInScope;
+        UNLIKELY_IF (!loadResult_())
+            throw std::runtime_error(getLoadErrorString());
+    }
+
+    string PipelineRasterization::getLoadErrorString() {
+        if (!loadedFromFiles) return infoLog_;
+        string s = "Error during shader file load\n";
+        LOOPI(5) if (!fileName[i].empty()) s += " " + shaderTypeStringSameLenght[i] + ": " + fileName[i] + "\n";
+        return s + infoLog_;
     }
 
     void PipelineRasterization::setDefaultValues() {
@@ -832,6 +954,13 @@ namespace glCompact {
         //TESS_GEN_SPACING             //=EQUAL, FRACTIONAL_EVEN, FRACTIONAL_ODD
         //TESS_GEN_VERTEX_ORDER        //=CCW, CW
         //TESS_GEN_POINT_MODE          //=bool
+        if (hasTessEvalutionStage()) {
+            int32_t tessGenMode      = 0;
+            int32_t tessGenPointMode = 0;
+            threadContextGroup_->functions.glGetProgramiv(id, GL_TESS_GEN_MODE,       &tessGenMode);
+            threadContextGroup_->functions.glGetProgramiv(id, GL_TESS_GEN_POINT_MODE, &tessGenPointMode);
+            tessellationOutputPrimitive = tessGenPointMode ? Primitive::points : tessGenMode == GL_ISOLINES ? Primitive::lines : Primitive::triangles;
+        }
 
         //Core since 3.2
         if (hasGeometryStage()) {
@@ -842,14 +971,80 @@ namespace glCompact {
             //GEOMETRY_SHADER_INVOCATIONS
         }
 
-        //int32_t transformFeedbackVaryingCount         = 0;
+        //Also counts outputs declared via xfb_buffer/xfb_offset in the shader (GL_ARB_enhanced_layouts)
+        threadContextGroup_->functions.glGetProgramiv(id, GL_TRANSFORM_FEEDBACK_VARYINGS, &transformFeedbackVaryingCount);
         //int32_t transformFeedbackVaryingNameLengthMax = 0;
         //int32_t transformFeedbackBufferMode;
-        //threadContextGroup_->functions.glGetProgramiv(id, GL_TRANSFORM_FEEDBACK_VARYINGS,           &transformFeedbackVaryingCount);
         //threadContextGroup_->functions.glGetProgramiv(id, GL_TRANSFORM_FEEDBACK_VARYING_MAX_LENGTH, &transformFeedbackVaryingNameLengthMax);
         //threadContextGroup_->functions.glGetProgramiv(id, GL_TRANSFORM_FEEDBACK_BUFFER_MODE,        &transformFeedbackBufferMode); //= GL_SEPARATE_ATTRIBS or GL_INTERLEAVED_ATTRIBS.
     }
 
+    void PipelineRasterization::writeInformation(
+        ProgramCacheWriter_& writer
+    ) const {
+        PipelineInterface::writeInformation(writer);
+
+        uint32_t usedLocationCount = 0;
+        LOOPI(config::MAX_ATTRIBUTES) if (attributeLocationInfo[i].type) usedLocationCount++;
+        writer.write(usedLocationCount);
+        LOOPI(config::MAX_ATTRIBUTES) if (attributeLocationInfo[i].type) {
+            writer.write(uint32_t(i));
+            writer.write(attributeLocationInfo[i].type);
+            writer.write(attributeLocationInfo[i].name);
+            writer.write(attributeLayout_.gpuType[i]);
+        }
+
+        writer.write(geometryOutputPrimitveMax);
+        writer.write(geometryOutputPrimitive);
+        writer.write(geometryInputPrimitive);
+        writer.write(tessellationOutputPrimitive);
+        writer.write(transformFeedbackVaryingCount);
+    }
+
+    void PipelineRasterization::readInformation(
+        ProgramCacheReader_& reader
+    ) {
+        PipelineInterface::readInformation(reader);
+
+        uint32_t usedLocationCount = reader.read<uint32_t>();
+        LOOPI(usedLocationCount) {
+            uint32_t location = reader.read<uint32_t>();
+            UNLIKELY_IF (location >= config::MAX_ATTRIBUTES)
+                throw runtime_error("Program cache attribute location outside of config::MAX_ATTRIBUTES!");
+            reader.read(attributeLocationInfo[location].type);
+            reader.read(attributeLocationInfo[location].name);
+            reader.read(attributeLayout_.gpuType[location]);
+        }
+
+        reader.read(geometryOutputPrimitveMax);
+        reader.read(geometryOutputPrimitive);
+        reader.read(geometryInputPrimitive);
+        reader.read(tessellationOutputPrimitive);
+        reader.read(transformFeedbackVaryingCount);
+    }
+
+    /*
+        Primitive that glBeginTransformFeedback needs for this pipeline, the output primitive of the last vertex processing stage reduced to points, lines or triangles.
+        Returns -1 for input primitives that need a geometry or tessellation stage.
+    */
+    Primitive PipelineRasterization::getTransformFeedbackPrimitive() const {
+        if (hasGeometryStage()) {
+            switch (static_cast<GLenum>(geometryOutputPrimitive)) {
+                case GL_POINTS:         return Primitive::points;
+                case GL_LINE_STRIP:     return Primitive::lines;
+                case GL_TRIANGLE_STRIP: return Primitive::triangles;
+            }
+            return static_cast<Primitive>(-1);
+        }
+        if (hasTessEvalutionStage()) return tessellationOutputPrimitive;
+        switch (inputPrimitive) {
+            case Primitive::points:    return Primitive::points;
+            case Primitive::lines:     return Primitive::lines;
+            case Primitive::triangles: return Primitive::triangles;
+            default:                   return static_cast<Primitive>(-1);
+        }
+    }
+
     /*
         Draw/rasterize primitive commands
 
@@ -891,6 +1086,12 @@ namespace glCompact {
         UNLIKELY_IF (firstInstance > 0 && !threadContextGroup_->extensions.GL_ARB_base_instance)
             throw std::runtime_error("firstInstance must be 0 without support for GL_ARB_base_instance (Core since 4.2)!");
 
+        if (drawBatchPrepare(false)) {
+            threadContext_->drawBatchCommand.insert(threadContext_->drawBatchCommand.end(), {vertexCount, instanceCount, firstVertex, firstInstance});
+            threadContext_->drawBatchCount++;
+            return;
+        }
+
         processPendingChanges();
         if (firstInstance) {
             UNLIKELY_IF (!threadContextGroup_->extensions.GL_ARB_base_instance)
@@ -935,6 +1136,13 @@ namespace glCompact {
         UNLIKELY_IF (firstInstance > 0 && !threadContextGroup_->extensions.GL_ARB_base_instance)
             throw std::runtime_error("firstInstance must be 0 without support for GL_ARB_base_instance (Core since 4.2)!");
 
+        if (drawBatchPrepare(true)) {
+            const uint32_t batchFirstIndex = firstIndex + uint32_t(buffer_attribute_index_offset / (indexType == IndexType::UINT16 ? 2 : 4));
+            threadContext_->drawBatchCommand.insert(threadContext_->drawBatchCommand.end(), {indexCount, instanceCount, batchFirstIndex, uint32_t(vertexOffset), firstInstance});
+            threadContext_->drawBatchCount++;
+            return;
+        }
+
         processPendingChanges();
         threadContext_->cachedBindIndexBuffer(buffer_attribute_index_id);
         uintptr_t indexBufferByteOffset = this->buffer_attribute_index_offset + (firstIndex * (indexType == IndexType::UINT16 ? 2 : 4)); //assuming we never support UINT8 index
@@ -1120,7 +1328,91 @@ namespace glCompact {
         }
     }
 
+    /** \brief draw the vertices captured by the last begin()/end() of transformFeedback, the vertex count never gets read back to the CPU
+     * \details Depends on GL_ARB_transform_feedback2 (Core since 4.0)
+     *
+     * The captured buffers must be set as attribute buffers of this pipeline.
+     * \param instanceCount must be 1 without GL_ARB_transform_feedback_instanced (Core since 4.2)
+     * \param stream vertex stream of a geometry shader, must be 0 without GL_ARB_transform_feedback3 (Core since 4.0)
+     */
+    void PipelineRasterization::drawTransformFeedback(
+        const TransformFeedback& transformFeedback,
+        uint32_t                 instanceCount,
+        uint32_t                 stream
+    ) {
+        UNLIKELY_IF (!threadContextGroup_->extensions.GL_ARB_transform_feedback2)
+            throw std::runtime_error("missing support for GL_ARB_transform_feedback2 (Core since 4.0)!");
+        UNLIKELY_IF (instanceCount != 1 && !threadContextGroup_->extensions.GL_ARB_transform_feedback_instanced)
+            throw std::runtime_error("instanceCount must be 1 without support for GL_ARB_transform_feedback_instanced (Core since 4.2)!");
+        UNLIKELY_IF (stream != 0 && !threadContextGroup_->extensions.GL_ARB_transform_feedback3)
+            throw std::runtime_error("stream must be 0 without support for GL_ARB_transform_feedback3 (Core since 4.0)!");
+        UNLIKELY_IF (!transformFeedback.hasCapture())
+            throw std::runtime_error("drawTransformFeedback() needs a TransformFeedback that got ended at last once!");
+        UNLIKELY_IF (transformFeedback.isActive())
+            throw std::runtime_error("drawTransformFeedback() can not draw from an active TransformFeedback!");
+
+        processPendingChanges();
+        if (instanceCount != 1) {
+            if (stream) {
+                threadContextGroup_->functions.glDrawTransformFeedbackStreamInstanced(static_cast<GLenum>(inputPrimitive), transformFeedback.id, stream, instanceCount);
+            } else {
+                threadContextGroup_->functions.glDrawTransformFeedbackInstanced      (static_cast<GLenum>(inputPrimitive), transformFeedback.id,         instanceCount);
+            }
+        } else {
+            if (stream) {
+                threadContextGroup_->functions.glDrawTransformFeedbackStream         (static_cast<GLenum>(inputPrimitive), transformFeedback.id, stream);
+            } else {
+                threadContextGroup_->functions.glDrawTransformFeedback               (static_cast<GLenum>(inputPrimitive), transformFeedback.id);
+            }
+        }
+    }
+
+    bool PipelineRasterization::hasPendingChanges() const {
+        return PipelineInterface::hasPendingChanges()
+            || buffer_attribute_changedSlotMin <= buffer_attribute_changedSlotMax
+            || stateChange.all
+            || threadContext_->stateChange.all
+            || threadContext_->attributeLayoutMaybeChanged
+            || threadContext_->pending_frame != threadContext_->current_frame
+            || threadContext_->memoryBarrierRasterizationRegionMask;
+    }
+
+    /*
+        Draw batching (setDrawBatching): Returns true if the draw must be added to threadContext_->drawBatchCommand instead of being issued.
+        Draws are only collected as long as they come from this pipeline without any pending changes in between, so the GL state is the same for all of them.
+        Otherwise the pending batch gets submitted, the pending changes of this pipeline get processed and a new batch starts with this draw.
+    */
+    bool PipelineRasterization::drawBatchPrepare(
+        bool indexed
+    ) {
+        Context_& context = *threadContext_;
+        if (!context.drawBatchEnabled || !threadContextGroup_->extensions.GL_ARB_multi_draw_indirect) return false;
+        //DrawElementsIndirectCommand can only express the index buffer offset in whole indices
+        if (indexed && buffer_attribute_index_offset % (indexType == IndexType::UINT16 ? 2 : 4)) return false;
+
+        if (context.drawBatchPipeline  == this
+        &&  context.drawBatchIndexed   == indexed
+        &&  context.drawBatchPrimitive == uint32_t(inputPrimitive)
+        &&  (!indexed || (context.drawBatchIndexType == uint32_t(indexType) && context.buffer_attribute_index_id == buffer_attribute_index_id))
+        &&  (context.drawBatchCommand.size() + 5) * sizeof(uint32_t) <= Context_::drawBatchBufferSize
+        &&  !hasPendingChanges()) return true;
+
+        processPendingChanges();
+        if (indexed) context.cachedBindIndexBuffer(buffer_attribute_index_id);
+        context.drawBatchPipeline  = this;
+        context.drawBatchIndexed   = indexed;
+        context.drawBatchPrimitive = uint32_t(inputPrimitive);
+        context.drawBatchIndexType = uint32_t(indexType);
+        return true;
+    }
+
     void PipelineRasterization::processPendingChanges() {
+        UNLIKELY_IF (threadContext_->transformFeedbackCapturing) {
+            UNLIKELY_IF (threadContext_->transformFeedback->pipeline != this)
+                throw std::runtime_error("Only the pipeline given to TransformFeedback::begin() can draw while capturing, pause() it to use other pipelines!");
+            UNLIKELY_IF (threadContext_->transformFeedback->primitive != getTransformFeedbackPrimitive())
+                throw std::runtime_error("Draw primitive does not fit to the primitive of the active TransformFeedback!");
+        }
         PipelineInterface::processPendingChanges();
         if (threadContext_->pipeline != this) {
             PipelineInterface::processPendingChangesPipeline();
@@ -1211,10 +1503,10 @@ namespace glCompact {
         */
 
         //FACE FRONT AND CULLING
-        if (isDiffThenAssign(threadContext_->triangleFrontIsClockwiseRotation, triangleFrontIsClockwiseRotation)) {
+        if (countStateCheck(StatisticsCategory::face, isDiffThenAssign(threadContext_->triangleFrontIsClockwiseRotation, triangleFrontIsClockwiseRotation))) {
             threadContextGroup_->functions.glFrontFace(triangleFrontIsClockwiseRotation ? GL_CW : GL_CCW);
         }
-        if (isDiffThenAssign(threadContext_->faceToDraw, faceToDraw)) {
+        if (countStateCheck(StatisticsCategory::face, isDiffThenAssign(threadContext_->faceToDraw, faceToDraw))) {
             if (faceToDraw == FaceSelection::frontAndBack) {
                 threadContextGroup_->functions.glDisable(GL_CULL_FACE);
             } else {
@@ -1231,23 +1523,24 @@ namespace glCompact {
         if (bool(stateChangeBoth.depth)) {
             bool depthEnabled = depthWriteEnabled || depthCompareOperator != CompareOperator::disabled;
 
-            if (isDiffThenAssign(threadContext_->depthEnabled, depthEnabled)) {
+            if (countStateCheck(StatisticsCategory::depth, isDiffThenAssign(threadContext_->depthEnabled, depthEnabled))) {
                 threadContext_->setGlState(GL_DEPTH_TEST, depthEnabled);
             }
 
             if (depthEnabled) {
-                if (isDiffThenAssign(threadContext_->depthCompareOperator, depthCompareOperator)) {
+                if (countStateCheck(StatisticsCategory::depth, isDiffThenAssign(threadContext_->depthCompareOperator, depthCompareOperator))) {
                     threadContextGroup_->functions.glDepthFunc(static_cast<GLenum>(depthCompareOperator));
                 }
-                if (isDiffThenAssign(threadContext_->depthWriteEnabled, depthWriteEnabled)) {
+                if (countStateCheck(StatisticsCategory::depth, isDiffThenAssign(threadContext_->depthWriteEnabled, depthWriteEnabled))) {
                     threadContextGroup_->functions.glDepthMask(depthWriteEnabled);
                 }
 
                 //TODO: maybe just always enable this states???
-                if (threadContext_->depthBiasConstantFactor != depthBiasConstantFactor
+                if (countStateCheck(StatisticsCategory::depth,
+                    threadContext_->depthBiasConstantFactor != depthBiasConstantFactor
                 ||  threadContext_->depthBiasClamp          != depthBiasClamp
                 ||  threadContext_->depthBiasSlopeFactor    != depthBiasSlopeFactor
-                ) {
+                )) {
                     bool current_usingDepthOffset =
                             threadContext_->depthBiasConstantFactor != 0
                         ||  threadContext_->depthBiasClamp          != 0
@@ -1275,15 +1568,15 @@ namespace glCompact {
                     threadContext_->depthBiasSlopeFactor    = depthBiasSlopeFactor;
                 }
 
-                if(isDiffThenAssign(
+                if (countStateCheck(StatisticsCategory::depth, isDiffThenAssign(
                     threadContext_->depthNearMapping, depthNearMapping,
                     threadContext_->depthFarMapping,  depthFarMapping
-                )) {
+                ))) {
                     //There also is glDepthRangef, Core since 4.1
                     threadContextGroup_->functions.glDepthRange(depthNearMapping, depthFarMapping);
                 }
 
-                if (isDiffThenAssign(threadContext_->depthClippingToClamping, depthClippingToClamping)) {
+                if (countStateCheck(StatisticsCategory::depth, isDiffThenAssign(threadContext_->depthClippingToClamping, depthClippingToClamping))) {
                     threadContext_->setGlState(GL_DEPTH_CLAMP, !depthClippingToClamping);
                 }
             }
@@ -1337,31 +1630,31 @@ namespace glCompact {
             ||  stencilWriteBack.stencilPassDepthFailOperator          != StencilOperator::keep
             ||  stencilWriteBack.stencilPassDepthPassOrAbsentOperator  != StencilOperator::keep;
 
-            if (isDiffThenAssign(threadContext_->stencilEnabled, stencilEnabled)) {
+            if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(threadContext_->stencilEnabled, stencilEnabled))) {
                 threadContext_->setGlState(GL_STENCIL_TEST, stencilEnabled);
             }
 
             if (stencilEnabled) {
                 if (faceToDraw == FaceSelection::frontAndBack || faceToDraw == FaceSelection::front) {
-                    if (isDiffThenAssign(
+                    if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(
                         threadContext_->stencilTestFront.refValue,        stencilTestFront.refValue,
                         threadContext_->stencilTestFront.compareOperator, stencilTestFront.compareOperator,
                         threadContext_->stencilTestFront.readMask,        stencilTestFront.readMask
-                    )) {
+                    ))) {
                         threadContextGroup_->functions.glStencilFuncSeparate(
                             GL_FRONT,
                             static_cast<GLenum>(stencilTestFront.compareOperator),
                             stencilTestFront.refValue,
                             stencilTestFront.readMask);
                     }
-                    if (isDiffThenAssign(threadContext_->stencilWriteFront.writeMask, stencilWriteFront.writeMask)) {
+                    if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(threadContext_->stencilWriteFront.writeMask, stencilWriteFront.writeMask))) {
                         threadContextGroup_->functions.glStencilMaskSeparate(GL_FRONT, stencilWriteFront.writeMask);
                     }
-                    if (isDiffThenAssign(
+                    if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(
                         threadContext_->stencilWriteFront.stencilFailOperator,                  stencilWriteFront.stencilFailOperator,
                         threadContext_->stencilWriteFront.stencilPassDepthFailOperator,         stencilWriteFront.stencilPassDepthFailOperator,
                         threadContext_->stencilWriteFront.stencilPassDepthPassOrAbsentOperator, stencilWriteFront.stencilPassDepthPassOrAbsentOperator
-                    )) {
+                    ))) {
                         threadContextGroup_->functions.glStencilOpSeparate(
                             GL_FRONT,
                             static_cast<GLenum>(stencilWriteFront.stencilFailOperator),
@@ -1370,25 +1663,25 @@ namespace glCompact {
                     }
                 }
                 if (faceToDraw == FaceSelection::frontAndBack || faceToDraw == FaceSelection::back) {
-                    if (isDiffThenAssign(
+                    if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(
                         threadContext_->stencilTestBack.refValue,        stencilTestBack.refValue,
                         threadContext_->stencilTestBack.compareOperator, stencilTestBack.compareOperator,
                         threadContext_->stencilTestBack.readMask,        stencilTestBack.readMask
-                    )) {
+                    ))) {
                         threadContextGroup_->functions.glStencilFuncSeparate(
                             GL_BACK,
                             static_cast<GLenum>(stencilTestBack.compareOperator),
                             stencilTestBack.refValue,
                             stencilTestBack.readMask);
                     }
-                    if (isDiffThenAssign(threadContext_->stencilWriteBack.writeMask, stencilWriteBack.writeMask)) {
+                    if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(threadContext_->stencilWriteBack.writeMask, stencilWriteBack.writeMask))) {
                         threadContextGroup_->functions.glStencilMaskSeparate(GL_BACK, stencilWriteBack.writeMask);
                     }
-                    if (isDiffThenAssign(
+                    if (countStateCheck(StatisticsCategory::stencil, isDiffThenAssign(
                         threadContext_->stencilWriteBack.stencilFailOperator,                  stencilWriteBack.stencilFailOperator,
                         threadContext_->stencilWriteBack.stencilPassDepthFailOperator,         stencilWriteBack.stencilPassDepthFailOperator,
                         threadContext_->stencilWriteBack.stencilPassDepthPassOrAbsentOperator, stencilWriteBack.stencilPassDepthPassOrAbsentOperator
-                    )) {
+                    ))) {
                         threadContextGroup_->functions.glStencilOpSeparate(
                             GL_BACK,
                             static_cast<GLenum>(stencilWriteBack.stencilFailOperator),
@@ -1403,14 +1696,14 @@ namespace glCompact {
         //glColorMask  core since 2.0
         //glColorMaski core since 3.0
         if (singleRgbaWriteMaskState) {
-            if (!threadContext_->singleRgbaWriteMaskState || threadContext_->rgbaWriteMask[0].value != rgbaWriteMask[0].value) {
+            if (countStateCheck(StatisticsCategory::rgbaWriteMask, !threadContext_->singleRgbaWriteMaskState || threadContext_->rgbaWriteMask[0].value != rgbaWriteMask[0].value)) {
                 threadContextGroup_->functions.glColorMask(rgbaWriteMask[0].r, rgbaWriteMask[0].g, rgbaWriteMask[0].b, rgbaWriteMask[0].a);
                 LOOPI(config::MAX_RGBA_ATTACHMENTS) {
                     threadContext_->rgbaWriteMask[i].value = rgbaWriteMask[i].value;
                 }
             }
         } else {
-            LOOPI(config::MAX_RGBA_ATTACHMENTS) if (isDiffThenAssign(threadContext_->rgbaWriteMask[i].value, rgbaWriteMask[i].value)) {
+            LOOPI(config::MAX_RGBA_ATTACHMENTS) if (countStateCheck(StatisticsCategory::rgbaWriteMask, isDiffThenAssign(threadContext_->rgbaWriteMask[i].value, rgbaWriteMask[i].value))) {
                 threadContextGroup_->functions.glColorMaski(i, rgbaWriteMask[i].r, rgbaWriteMask[i].g, rgbaWriteMask[i].b, rgbaWriteMask[i].a);
             }
         }
@@ -1439,13 +1732,13 @@ namespace glCompact {
                     threadContext_->setGlState(GL_BLEND, true);
                 } else {
                     LOOPI(config::MAX_RGBA_ATTACHMENTS) {
-                        if (threadContext_->blendEnabled[i] != blendEnabled[i]) {
+                        if (countStateCheck(StatisticsCategory::blend, threadContext_->blendEnabled[i] != blendEnabled[i])) {
                             threadContext_->blendEnabled[i] = blendEnabled[i];
                             threadContext_->setGlState(GL_BLEND, i, blendEnabled[i]);
                         }
                     }
                 }
-                if (threadContext_->blendConstRgba != blendConstRgba) {
+                if (countStateCheck(StatisticsCategory::blend, threadContext_->blendConstRgba != blendConstRgba)) {
                     threadContext_->blendConstRgba = blendConstRgba;
                     threadContextGroup_->functions.glBlendColor(blendConstRgba.r, blendConstRgba.g, blendConstRgba.b, blendConstRgba.a);
                 }
@@ -1473,7 +1766,7 @@ namespace glCompact {
                         if (threadContext_->blendFactors  [0] == blendFactors  [firstActiveIndex]) blendFactorsChanged   = false;
                         if (threadContext_->blendEquations[0] == blendEquations[firstActiveIndex]) blendEquationsChanged = false;
                     }
-                    if (blendFactorsChanged) {
+                    if (countStateCheck(StatisticsCategory::blend, blendFactorsChanged)) {
                         LOOPI(config::MAX_RGBA_ATTACHMENTS)
                             threadContext_->blendFactors[i] = blendFactors[i];
                         threadContextGroup_->functions.glBlendFuncSeparate(
@@ -1483,7 +1776,7 @@ namespace glCompact {
                             static_cast<GLenum>(blendFactors[firstActiveIndex].dstA)
                         );
                     }
-                    if (blendEquationsChanged) {
+                    if (countStateCheck(StatisticsCategory::blend, blendEquationsChanged)) {
                         LOOPI(config::MAX_RGBA_ATTACHMENTS)
                             threadContext_->blendEquations[i] = blendEquations[i];
                         threadContextGroup_->functions.glBlendEquationSeparate(
@@ -1499,7 +1792,7 @@ namespace glCompact {
                     UNLIKELY_IF (!(threadContextGroup_->version.gl >= GlVersion::v40))
                         throw std::runtime_error("Trying to set multible rgba blend factors/equations, but not supported by this system (missing OpenGL 4.0 or higher)");
                     for (int i = firstActiveIndex; i < config::MAX_RGBA_ATTACHMENTS; i++) {
-                        if (isDiffThenAssign(threadContext_->blendFactors[i], blendFactors[i])) {
+                        if (countStateCheck(StatisticsCategory::blend, isDiffThenAssign(threadContext_->blendFactors[i], blendFactors[i]))) {
                             threadContextGroup_->functions.glBlendFuncSeparatei(
                                 i,
                                 static_cast<GLenum>(blendFactors[i].srcRgb),
@@ -1508,7 +1801,7 @@ namespace glCompact {
                                 static_cast<GLenum>(blendFactors[i].dstA)
                             );
                         }
-                        if (isDiffThenAssign(threadContext_->blendEquations[i], blendEquations[i])) {
+                        if (countStateCheck(StatisticsCategory::blend, isDiffThenAssign(threadContext_->blendEquations[i], blendEquations[i]))) {
                             threadContextGroup_->functions.glBlendEquationSeparatei(
                                 i,
                                 static_cast<GLenum>(blendEquations[i].rgb),
@@ -1519,7 +1812,7 @@ namespace glCompact {
                     threadContext_->blendModesUniform = false;
                 }
             } else {
-                if (threadContext_->blendEnabledAny) {
+                if (countStateCheck(StatisticsCategory::blend, threadContext_->blendEnabledAny)) {
                     threadContext_->blendEnabledAny = false;
                     LOOPI(config::MAX_RGBA_ATTACHMENTS)
                         threadContext_->blendEnabled[i] = false;
@@ -1529,9 +1822,12 @@ namespace glCompact {
         }
 
         //MULTISAMPLE
-        if (isDiffThenAssign(threadContext_->multiSample, multiSample)) {
+        if (countStateCheck(StatisticsCategory::multiSample, isDiffThenAssign(threadContext_->multiSample, multiSample))) {
             threadContext_->setGlState(GL_MULTISAMPLE, multiSample);
         }
+
+        //RASTERIZER DISCARD (Frame clears disable it and flag the context state change)
+        if (stateChangeBoth.rasterizerDiscard) threadContext_->cachedRasterizerDiscard(rasterizerDiscard);
     }
 
     /**
@@ -1539,6 +1835,7 @@ namespace glCompact {
         This is because buffers bound to one or several VAOs will be keept around even after deleting them. Only after all VAO references are droped will the recources actually be freed!
         This makes it impossible to implement a clean recource management without doing silly things like walking over every single VAO in every context or
         forcing glCompact users to manually "clean up" VAOs in some way.
+        The optional VAO cache (setVertexArrayCache) only keeps VAOs of the current context and deletes the ones that use a buffer of this context that gets deleted.
 
         Internals:
             GL_ARB_instanced_arrays      (core since 3.3) NOTE: non core uses EXT/ANGLE/NV functions!
@@ -1554,7 +1851,11 @@ namespace glCompact {
             glVertexBindingDivisor sets instance divisor for a buffer index (ARB_vertex_attrib_binding Core since 4.3)
     */
     void PipelineRasterization::processPendingChangesAttributeLayoutAndBuffers() {
-        const bool   attributeLayoutChanged     = threadContext_->attributeLayoutMaybeChanged && (threadContext_->attributeLayout_ != attributeLayout_);
+        if (threadContext_->vertexArrayCacheSize && threadContext_->attributeLayoutMaybeChanged && threadContext_->cachedBindVertexArray(attributeLayout_, vertexArrayCacheIndexHint)) {
+            buffer_attribute_changedSlotMin = 0;
+            buffer_attribute_changedSlotMax = maximum<int32_t>(buffer_attribute_changedSlotMax, attributeLayout_.uppermostActiveBufferIndex);
+        }
+        const bool   attributeLayoutChanged     = threadContext_->attributeLayoutMaybeChanged && countStateCheck(StatisticsCategory::attributeLayout, threadContext_->attributeLayout_ != attributeLayout_);
         const int    uppermostActiveLocation    = maximum(attributeLayout_.uppermostActiveLocation, threadContext_->attributeLayout_.uppermostActiveLocation);
         const int8_t changedSlotMin             = buffer_attribute_changedSlotMin;
         const int8_t changedSlotMax             = buffer_attribute_changedSlotMax;
@@ -1603,7 +1904,7 @@ namespace glCompact {
 
                     //first = 0;
                     //last  = 28;//config::MAX_ATTRIBUTES - 1;  //if value is higher then 28, the Win7 AMD blobs break without error output
-                    if (first <= last) {
+                    if (countStateCheck(StatisticsCategory::attributeBuffer, first <= last)) {
                         const uint32_t  count        = last - first + 1;
                         const uint32_t* bufferIdList =                                   &buffer_attribute_id               [first];
                         const GLintptr* offsetList   = reinterpret_cast<const GLintptr*>(&buffer_attribute_offset           [first]);
@@ -1612,8 +1913,9 @@ namespace glCompact {
                     }
                 } else {
                     for (int i = changedSlotMin; i <= changedSlotMax; ++i) {
-                        if (threadContext_->buffer_attribute_id    [i] != buffer_attribute_id    [i]
-                        ||  threadContext_->buffer_attribute_offset[i] != buffer_attribute_offset[i]) {
+                        if (countStateCheck(StatisticsCategory::attributeBuffer,
+                            threadContext_->buffer_attribute_id    [i] != buffer_attribute_id    [i]
+                        ||  threadContext_->buffer_attribute_offset[i] != buffer_attribute_offset[i])) {
                             threadContextGroup_->functions.glBindVertexBuffer(i, buffer_attribute_id[i], buffer_attribute_offset[i], attributeLayout_.bufferIndexStride[i]);
                         }
                     }
@@ -1678,6 +1980,7 @@ namespace glCompact {
                 threadContext_->buffer_attribute_id    [i] = buffer_attribute_id    [i];
                 threadContext_->buffer_attribute_offset[i] = buffer_attribute_offset[i];
             }
+            threadContext_->buffer_attribute_highestIndexNonNull = maximum<int32_t>(threadContext_->buffer_attribute_highestIndexNonNull, changedSlotMax);
             buffer_attribute_changedSlotMin = config::MAX_ATTRIBUTES;
             buffer_attribute_changedSlotMax = -1;
         }
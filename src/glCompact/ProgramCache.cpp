@@ -0,0 +1,282 @@
+#include "glCompact/ProgramCache.hpp"
+#include "glCompact/ProgramCache_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/Debug.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+
+/*
+    GL_ARB_get_program_binary (Core since 4.1)
+        void glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+        void glProgramBinary   (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+    On AMD getting the binary only works if GL_PROGRAM_BINARY_RETRIEVABLE_HINT is set before linking.
+    Older Mesa versions report support but always reject loading a binary. A rejected binary is counted and we fall back to compiling from source.
+    Binaries get invalid with driver updates, that is why GL_RENDERER, GL_VERSION and GL_SHADING_LANGUAGE_VERSION are part of the key.
+
+    File layout (native endianness, the file is only valid on the same machine anyway):
+        char     magic[8]
+        uint32_t fileVersion
+        uint32_t binaryFormat
+        uint64_t key
+        uint64_t binarySize
+        uint64_t informationSize
+        uint64_t dataHash                       FNV-1a of binary and information
+        char     binary[binarySize]
+        char     information[informationSize]   serialized reflection data, see PipelineInterface::writeInformation
+*/
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    namespace {
+        const char     fileMagic[8] = {'g', 'l', 'C', 'P', 'r', 'o', 'g', '\0'};
+        const uint32_t fileVersion  = 3;
+
+        struct FileHeader {
+            char     magic[8];
+            uint32_t fileVersion;
+            uint32_t binaryFormat;
+            uint64_t key;
+            uint64_t binarySize;
+            uint64_t informationSize;
+            uint64_t dataHash;
+        };
+
+        mutex            directoryMutex;
+        string           cacheDirectory;
+        atomic<bool>     enabled       = {false};
+        atomic<uint64_t> hitCount      = {0};
+        atomic<uint64_t> missCount     = {0};
+        atomic<uint64_t> rejectedCount = {0};
+        atomic<uint32_t> tempFileCount = {0}; //unique temp file names for concurrent writers (e.g. PipelineCompiler workers)
+
+        string getFileName(
+            uint64_t key
+        ) {
+            static const char hexDigit[] = "0123456789abcdef";
+            string keyString(16, '0');
+            for (int i = 15; i >= 0; --i, key >>= 4) keyString[i] = hexDigit[key & 0xF];
+            lock_guard<mutex> lock(directoryMutex);
+            return cacheDirectory + "/" + keyString + ".glprogram";
+        }
+
+        void fnv1a64(
+            uint64_t&   hash,
+            const void* data,
+            size_t      size
+        ) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= p[i];
+                hash *= 0x100000001B3ull;
+            }
+        }
+
+        void fnv1a64(
+            uint64_t&     hash,
+            const string& s
+        ) {
+            uint64_t size = s.size();
+            fnv1a64(hash, &size, sizeof(size));
+            fnv1a64(hash, s.data(), s.size());
+        }
+
+        uint64_t getDataHash(
+            const vector<char>& binary,
+            const vector<char>& information
+        ) {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            fnv1a64(hash, binary.data(),      binary.size());
+            fnv1a64(hash, information.data(), information.size());
+            return hash;
+        }
+    }
+
+    /**
+        \ingroup API
+        \brief Sets the directory of the disk backed program binary cache, an empty string disables the cache (default)
+
+        \details If enabled PipelineRasterization and PipelineCompute first try to load the linked program binary from this directory.
+        On a miss, or if the driver rejects the binary, the shaders are compiled from source and the resulting binary is stored in the cache.
+
+        The key of a cached program is a hash of all shader stage sources together with GL_RENDERER, GL_VERSION and GL_SHADING_LANGUAGE_VERSION.
+        The directory is not created, it must already exist. Stale files of old driver versions are never deleted.
+
+        Needs GL_ARB_get_program_binary (Core since 4.1), without it the cache stays inactive.
+    */
+    void setProgramCacheDirectory(
+        const std::string& directory
+    ) {
+        lock_guard<mutex> lock(directoryMutex);
+        cacheDirectory = directory;
+        while (cacheDirectory.size() > 1 && (cacheDirectory.back() == '/' || cacheDirectory.back() == '\\'))
+            cacheDirectory.pop_back();
+        enabled = !cacheDirectory.empty();
+    }
+
+    /**
+        \ingroup API
+        \brief Returns the directory of the program binary cache, empty if the cache is disabled
+    */
+    std::string getProgramCacheDirectory() {
+        lock_guard<mutex> lock(directoryMutex);
+        return cacheDirectory;
+    }
+
+    /**
+        \ingroup API
+        \brief Returns the hit/miss counters of the program binary cache since program start or the last resetProgramCacheCounter()
+    */
+    ProgramCacheCounter getProgramCacheCounter() {
+        ProgramCacheCounter counter;
+        counter.hit      = hitCount;
+        counter.miss     = missCount;
+        counter.rejected = rejectedCount;
+        return counter;
+    }
+
+    /**
+        \ingroup API
+        \brief Sets all program binary cache counters back to zero
+    */
+    void resetProgramCacheCounter() {
+        hitCount      = 0;
+        missCount     = 0;
+        rejectedCount = 0;
+    }
+
+    bool ProgramCache_::isEnabled() {
+        return enabled && threadContextGroup_->extensions.GL_ARB_get_program_binary;
+    }
+
+    uint64_t ProgramCache_::createKey(
+        const std::string* const shaderSrc[],
+        uint32_t                 count
+    ) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        fnv1a64(hash, &fileVersion, sizeof(fileVersion));
+        for (uint32_t i = 0; i < count; ++i) fnv1a64(hash, *shaderSrc[i]);
+        fnv1a64(hash, threadContextGroup_->version.rendererString);
+        fnv1a64(hash, threadContextGroup_->version.versionString);
+        fnv1a64(hash, threadContextGroup_->version.shadingLanguageVersionString);
+        return hash;
+    }
+
+    /*
+        Returns the id of the linked program or 0 on a miss. Does not change the cache counters if the cache is disabled.
+        On a hit information is filled with the reflection data that was given to store().
+    */
+    uint32_t ProgramCache_::load(
+        uint64_t           key,
+        std::vector<char>& information
+    ) {
+        if (!isEnabled()) return 0;
+
+        ifstream fileStream(getFileName(key).c_str(), ios::in | ios::binary);
+        FileHeader header;
+        vector<char> binary;
+        bool valid = fileStream.is_open()
+            && fileStream.read(reinterpret_cast<char*>(&header), sizeof(header))
+            && equal(begin(fileMagic), end(fileMagic), header.magic)
+            && header.fileVersion     == fileVersion
+            && header.key             == key
+            && header.binarySize      >  0
+            && header.binarySize      <= uint64_t(INT32_MAX)
+            && header.informationSize <= uint64_t(INT32_MAX);
+        if (valid) {
+            binary.resize(size_t(header.binarySize));
+            information.resize(size_t(header.informationSize));
+            valid = fileStream.read(binary.data(), binary.size())
+                &&  fileStream.read(information.data(), information.size())
+                &&  getDataHash(binary, information) == header.dataHash;
+        }
+        if (!valid) {
+            missCount++;
+            return 0;
+        }
+
+        Debug::DisableCallbackInScope disableCallbackInScope;
+        uint32_t id = threadContextGroup_->functions.glCreateProgram();
+        threadContextGroup_->functions.glProgramBinary(id, GLenum(header.binaryFormat), binary.data(), GLsizei(binary.size()));
+        int32_t linkStatus = 0;
+        threadContextGroup_->functions.glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
+        if (!linkStatus) {
+            threadContextGroup_->functions.glDeleteProgram(id);
+            rejectedCount++;
+            missCount++;
+            return 0;
+        }
+        hitCount++;
+        return id;
+    }
+
+    /*
+        Must be called before linking, otherwise some drivers (AMD) do not return a binary.
+    */
+    void ProgramCache_::setRetrievableHint(
+        uint32_t programId
+    ) {
+        if (!isEnabled()) return;
+        threadContextGroup_->functions.glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    /*
+        Writes to a temporary file first and then renames it, so other processes never see a half written file.
+        Failing to write the cache file is not an error, the program just gets compiled again next time.
+    */
+    void ProgramCache_::store(
+        uint64_t                 key,
+        uint32_t                 programId,
+        const std::vector<char>& information
+    ) {
+        if (!isEnabled()) return;
+
+        int32_t binarySize = 0;
+        threadContextGroup_->functions.glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+        if (binarySize <= 0) return;
+        vector<char> binary(binarySize);
+        GLsizei  binarySizeReturn = 0;
+        GLenum   binaryFormat     = 0;
+        threadContextGroup_->functions.glGetProgramBinary(programId, binarySize, &binarySizeReturn, &binaryFormat, binary.data());
+        if (!binarySizeReturn) return;
+        binary.resize(binarySizeReturn);
+
+        FileHeader header;
+        copy(begin(fileMagic), end(fileMagic), header.magic);
+        header.fileVersion     = fileVersion;
+        header.binaryFormat    = uint32_t(binaryFormat);
+        header.key             = key;
+        header.binarySize      = binary.size();
+        header.informationSize = information.size();
+        header.dataHash        = getDataHash(binary, information);
+
+        string fileName     = getFileName(key);
+        string fileNameTemp = fileName + "." + to_string(tempFileCount++) + ".tmp";
+        {
+            ofstream fileStream(fileNameTemp.c_str(), ios::out | ios::binary | ios::trunc);
+            if (!fileStream.is_open()) return;
+            fileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fileStream.write(binary.data(), binary.size());
+            fileStream.write(information.data(), information.size());
+            if (!fileStream) {
+                fileStream.close();
+                std::remove(fileNameTemp.c_str());
+                return;
+            }
+        }
+        //rename() does not overwrite existing files on all platforms
+        std::remove(fileName.c_str());
+        std::rename(fileNameTemp.c_str(), fileName.c_str());
+    }
+}
@@ -46,6 +46,7 @@ namespace glCompact {
             threadContextGroup_->functions.glCreateSamplers(1, &id);
         } else {
             threadContextGroup_->functions.glGenSamplers(1, &id);
+            threadContext_->flushDrawBatch();
             //this needs to be bound once before OpenGL creates the sampler for real, and before we can use operations on it like setting parameters
             threadContextGroup_->functions.glBindSampler(0, id);
             threadContext_->sampler_id[0] = id;
@@ -54,6 +55,7 @@ namespace glCompact {
     }
 
     Sampler::~Sampler() {
+        threadContext_->flushDrawBatch();
         detachFromThreadContext();
         threadContextGroup_->functions.glDeleteSamplers(1, &id);
     }
@@ -182,6 +184,7 @@ namespace glCompact {
         GLenum pname,
         float  value
     ) {
+        threadContext_->flushDrawBatch();
         threadContextGroup_->functions.glSamplerParameterf(id, pname, value);
     }
 
@@ -189,6 +192,7 @@ namespace glCompact {
         GLenum  pname,
         int32_t value
     ) {
+        threadContext_->flushDrawBatch();
         threadContextGroup_->functions.glSamplerParameteri(id, pname, value);
     }
 
@@ -0,0 +1,96 @@
+#include "glCompact/Statistics.hpp"
+#include "glCompact/Statistics_.hpp"
+#include "glCompact/threadContext_.hpp"
+#include "glCompact/gl/Functions.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace glCompact {
+    #ifdef GLCOMPACT_STATISTICS
+        namespace gl {
+            /*
+                Calls issued before the Context_ of this thread exists (ContextGroup_ init, Context_ constructor) or after it was destroyed are not counted.
+            */
+            void statisticsCountCall(
+                uint32_t functionIndex
+            ) {
+                #ifdef GLCOMPACT_MULTIPLE_CONTEXT
+                    if (!threadContext_) return;
+                #else
+                    if (!threadContextConstructed_) return;
+                #endif
+                threadContext_->statistics_glCallCount[functionIndex]++;
+            }
+        }
+    #endif
+
+    const char* Statistics::getCategoryName(
+        StatisticsCategory category
+    ) {
+        switch (category) {
+            case StatisticsCategory::shader:              return "shader";
+            case StatisticsCategory::uniform:             return "uniform";
+            case StatisticsCategory::attributeLayout:     return "attributeLayout";
+            case StatisticsCategory::vertexArray:         return "vertexArray";
+            case StatisticsCategory::attributeBuffer:     return "attributeBuffer";
+            case StatisticsCategory::indexBuffer:         return "indexBuffer";
+            case StatisticsCategory::bufferTarget:        return "bufferTarget";
+            case StatisticsCategory::uniformBuffer:       return "uniformBuffer";
+            case StatisticsCategory::shaderStorageBuffer: return "shaderStorageBuffer";
+            case StatisticsCategory::texture:             return "texture";
+            case StatisticsCategory::sampler:             return "sampler";
+            case StatisticsCategory::image:               return "image";
+            case StatisticsCategory::frame:               return "frame";
+            case StatisticsCategory::viewportScissor:     return "viewportScissor";
+            case StatisticsCategory::face:                return "face";
+            case StatisticsCategory::depth:               return "depth";
+            case StatisticsCategory::stencil:             return "stencil";
+            case StatisticsCategory::rgbaWriteMask:       return "rgbaWriteMask";
+            case StatisticsCategory::blend:               return "blend";
+            case StatisticsCategory::multiSample:         return "multiSample";
+            case StatisticsCategory::rasterizerDiscard:   return "rasterizerDiscard";
+            case StatisticsCategory::count:               break;
+        }
+        return "unknown";
+    }
+
+    /**
+        \ingroup API
+        \brief Returns a snapshot of the statistics of the current context since creation or the last resetStatistics()
+
+        \details Needs GLCOMPACT_STATISTICS to be defined in config.hpp. Otherwise this always returns an empty object.
+
+        Counts every OpenGL call glCompact issued and, per state category, how many cached state checks were elided versus forwarded to OpenGL.
+        Meant to be called once per frame, followed by resetStatistics(), to log per frame numbers.
+    */
+    Statistics getStatistics() {
+        Statistics statistics;
+        #ifdef GLCOMPACT_STATISTICS
+            for (uint32_t i = 0; i < threadContext_->statistics_glCallCount.size(); ++i) {
+                uint64_t count = threadContext_->statistics_glCallCount[i];
+                if (!count) continue;
+                statistics.glCallCount += count;
+                statistics.glCallCountList.emplace_back(gl::functionNameList[i], count);
+            }
+            stable_sort(statistics.glCallCountList.begin(), statistics.glCallCountList.end(), [](const pair<string, uint64_t>& a, const pair<string, uint64_t>& b) {
+                return a.second > b.second;
+            });
+            for (uint32_t i = 0; i < uint32_t(StatisticsCategory::count); ++i)
+                statistics.stateCheck[i] = threadContext_->statistics_stateCheck[i];
+        #endif
+        return statistics;
+    }
+
+    /**
+        \ingroup API
+        \brief Sets all statistics counters of the current context back to zero
+    */
+    void resetStatistics() {
+        #ifdef GLCOMPACT_STATISTICS
+            fill(threadContext_->statistics_glCallCount.begin(), threadContext_->statistics_glCallCount.end(), 0);
+            for (auto& stateCheck : threadContext_->statistics_stateCheck) stateCheck = Statistics::StateCheck();
+        #endif
+    }
+}
@@ -71,6 +71,7 @@ namespace glCompact {
 
     void SurfaceInterface::free() {
         if (!id) return;
+        if (threadContext_) threadContext_->flushDrawBatch();
         detachFromThreadContext();
         //If this texture/renderBuffer is part of the currently bound FBO then it would be unbound by OpenGL.
         //To prevent this we always set the default FBO. Still being bound to any FBO will act like a hard link (like a texture view) to the underlaying surface memory.
@@ -108,6 +109,7 @@ namespace glCompact {
         glm::ivec3              dstOffset,
         glm::ivec3              size
     ) {
+        threadContext_->flushDrawBatch();
         if (!this->id) return;
         if (!srcSurface.id) return;
 
@@ -273,6 +275,7 @@ namespace glCompact {
         glm::ivec3              dstOffset,
         glm::ivec3              size
     ) {
+        threadContext_->flushDrawBatch();
         //TODO: Test input parameters
         //TODO: tailor input parameters (Only in non debug mode or always? Maybe only warning?)
         UNLIKELY_IF (!this->id) return;
@@ -454,10 +457,12 @@ namespace glCompact {
             target
     */
     void SurfaceInterface::bindTemporalFirstTime() const {
+        threadContext_->flushDrawBatch();
         threadContext_->cachedBindTextureCompatibleOrFirstTime(0, target, id);
     }
 
     void SurfaceInterface::bindTemporal() const {
+        threadContext_->flushDrawBatch();
         threadContext_->cachedBindTexture(0, target, id);
     }
 }
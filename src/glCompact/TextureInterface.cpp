@@ -117,6 +117,9 @@ S
 #include "glCompact/SurfaceFormatDetail.hpp"
 #include "glCompact/MemorySurfaceFormatDetail.hpp"
 #include "glCompact/minimumMaximum.hpp"
+#include "glCompact/PipelineComputeMipmap_.hpp"
+#include "glCompact/TextureSelector.hpp"
+#include "glCompact/MemoryBarrier.hpp"
 
 #include <glm/glm.hpp>
 
@@ -623,6 +626,7 @@ namespace glCompact {
         glm::ivec3             texOffset,
         glm::ivec3             texSize
     ) {
+        threadContext_->flushDrawBatch();
         surfaceFormat.throwIfNotCopyConvertibleToThisMemorySurfaceFormat(memorySurfaceFormat);
         const uintptr_t dataOffset = reinterpret_cast<uintptr_t>(offsetPointer);
 
@@ -797,6 +801,7 @@ namespace glCompact {
         glm::ivec3          texOffset,
         glm::ivec3          texSize
     ) const {
+        threadContext_->flushDrawBatch();
         surfaceFormat.throwIfNotCopyConvertibleToThisMemorySurfaceFormat(memorySurfaceFormat);
         const uintptr_t dataOffset = reinterpret_cast<uintptr_t>(offsetPointer);
 
@@ -934,6 +939,7 @@ namespace glCompact {
     void TextureInterface::setMipmapBaseLevel(
         uint32_t level
     ) {
+        threadContext_->flushDrawBatch();
         UNLIKELY_IF (!id)
             throw runtime_error("Can't set mipmap base level of empty texture object!");
         UNLIKELY_IF (level >= mipmapCount)
@@ -954,6 +960,7 @@ namespace glCompact {
         The default behaviour of drivers seems to be that they take care of all needed memory barriers. (https://www.khronos.org/bugzilla/show_bug.cgi?id=1429)
     */
     void TextureInterface::generateMipmaps() {
+        threadContext_->flushDrawBatch();
         UNLIKELY_IF (!id)
             throw runtime_error("Can't generate mipmaps for empty texture object!");
         UNLIKELY_IF (mipmapCount <= 1)
@@ -968,7 +975,93 @@ namespace glCompact {
         }
     }
 
+    /**
+        \brief Generates all mipmaps below mipmapBaseLevel with the given filter
+
+        \details Uses generateMipmapsViaPipelineCompute() if isGenerateMipmapsViaPipelineComputeSupported(), otherwise the driver (like generateMipmaps()).
+        Only MipmapFilter::box is possible without pipeline compute, all other filters throw in that case.
+    */
+    void TextureInterface::generateMipmaps(
+        MipmapFilter mipmapFilter
+    ) {
+        if (isGenerateMipmapsViaPipelineComputeSupported()) {
+            generateMipmapsViaPipelineCompute(mipmapFilter);
+        } else {
+            UNLIKELY_IF (mipmapFilter != MipmapFilter::box)
+                throw runtime_error("generateMipmaps() with a filter other then MipmapFilter::box needs pipelineCompute and a 2d texture format with image support!");
+            generateMipmaps();
+        }
+    }
+
+    /**
+        \brief True if generateMipmapsViaPipelineCompute() can be used with this texture
+
+        \details Needs the feature pipelineCompute, a Texture2d and an uncompressed float, unorm or snorm surface format with image load/store support.
+    */
+    bool TextureInterface::isGenerateMipmapsViaPipelineComputeSupported() const {
+        return threadContextGroup_->feature.pipelineCompute
+            && target == GL_TEXTURE_2D
+            && surfaceFormat.detail().imageSupport
+            && PipelineComputeMipmap_::getImageFormatQualifier(surfaceFormat.detail().sizedFormat);
+    }
+
+    /**
+        \brief Generates all mipmaps below mipmapBaseLevel with a compute shader
+
+        \details The quality and speed of glGenerateMipmap differs a lot between drivers, and it can not do min/max reductions (e.g. for depth pyramids).
+        This reads one level and writes up to 4 following levels per dispatch. Levels are only combined into one dispatch while the sizes stay even,
+        MipmapFilter::kaiser always needs one dispatch per level.
+
+        All needed memory barriers for sampling or copying the texture afterwards are set.
+    */
+    void TextureInterface::generateMipmapsViaPipelineCompute(
+        MipmapFilter mipmapFilter
+    ) {
+        UNLIKELY_IF (!id)
+            throw runtime_error("Can't generate mipmaps for empty texture object!");
+        UNLIKELY_IF (mipmapCount <= 1)
+            throw runtime_error("Can't generate mipmaps for texture that only has base mipmap level 0!");
+        UNLIKELY_IF (!isGenerateMipmapsViaPipelineComputeSupported())
+            throw runtime_error("generateMipmapsViaPipelineCompute() needs pipelineCompute and a 2d texture format with image support!");
+
+        const int32_t sizedFormat = surfaceFormat.detail().sizedFormat;
+        PipelineComputeMipmap_* pipeline = nullptr;
+        for (auto p : threadContext_->pipelineComputeMipmap)
+            if (p->sizedFormat == sizedFormat && p->mipmapFilter == mipmapFilter) pipeline = p;
+        if (!pipeline) {
+            pipeline = new PipelineComputeMipmap_(sizedFormat, mipmapFilter);
+            threadContext_->pipelineComputeMipmap.push_back(pipeline);
+        }
+
+        pipeline->setTexture(0, *this);
+        uint32_t level = mipmapBaseLevel;
+        while (level + 1 < mipmapCount) {
+            uint32_t levelCount = 1;
+            if (mipmapFilter != MipmapFilter::kaiser) {
+                while (levelCount < PipelineComputeMipmap_::levelCountMax && level + levelCount + 1 < mipmapCount) {
+                    const glm::uvec3 levelSize = getMipmapLevelSize(level + levelCount);
+                    if ((levelSize.x & 1) || (levelSize.y & 1)) break;
+                    levelCount++;
+                }
+            }
+            LOOPI(levelCount) pipeline->setImage(i, TextureSelector(*this, level + 1 + i));
+            pipeline->srcLod     = int32_t(level - mipmapBaseLevel);
+            pipeline->levelCount = int32_t(levelCount);
+            const glm::uvec3 dstSize = getMipmapLevelSize(level + 1);
+            //The next dispatch reads the written levels via texelFetch
+            MemoryBarrier::texture();
+            pipeline->dispatch((dstSize.x + 7) / 8, (dstSize.y + 7) / 8, 1);
+            level += levelCount;
+        }
+        pipeline->setTexture();
+        pipeline->setImage();
+        MemoryBarrier::texture();
+        MemoryBarrier::imageUploadDownloadClear();
+        MemoryBarrier::frame();
+    }
+
     void TextureInterface::invalidate() {
+        threadContext_->flushDrawBatch();
         if (!id) return;
         if (!threadContextGroup_->extensions.GL_ARB_invalidate_subdata) return;
         LOOPI(mipmapCount) invalidate(i);
@@ -977,6 +1070,7 @@ namespace glCompact {
     void TextureInterface::invalidate(
         uint32_t mipmapLevel
     ) {
+        threadContext_->flushDrawBatch();
         if (!id) return;
         if (!threadContextGroup_->extensions.GL_ARB_invalidate_subdata) return;
         threadContextGroup_->functions.glInvalidateTexImage(id, mipmapLevel);
@@ -987,6 +1081,7 @@ namespace glCompact {
         glm::ivec3 offset,
         glm::ivec3 size
     ) {
+        threadContext_->flushDrawBatch();
         if (!id) return;
         if (threadContextGroup_->extensions.GL_ARB_invalidate_subdata) {
             threadContextGroup_->functions.glInvalidateTexSubImage(id, mipmapLevel, offset.x, offset.y, offset.z, size.x, size.y, size.z);
@@ -1015,6 +1110,7 @@ namespace glCompact {
     void TextureInterface::clearCheck(
         uint32_t mipmapLevel
     ) {
+        threadContext_->flushDrawBatch();
         UNLIKELY_IF (!threadContextGroup_->extensions.GL_ARB_clear_texture)
             throw runtime_error("Can't clear texture! Missing extension GL_ARB_clear_texture (Core since 4.4)");
         UNLIKELY_IF (!id)
@@ -1104,6 +1200,7 @@ namespace glCompact {
         int32_t pname,
         int32_t param
     ) {
+        threadContext_->flushDrawBatch();
         UNLIKELY_IF (!id)
             throw runtime_error("Can't set texture parameter of empty texture object!");
         if (threadContextGroup_->extensions.GL_ARB_direct_state_access) {
@@ -1118,6 +1215,7 @@ namespace glCompact {
         int32_t pname,
         float   param
     ) {
+        threadContext_->flushDrawBatch();
         UNLIKELY_IF (!id)
             throw runtime_error("Can't set texture parameter of empty texture object!");
         if (threadContextGroup_->extensions.GL_ARB_direct_state_access) {
@@ -0,0 +1,278 @@
+#include "glCompact/TextureUploader.hpp"
+#include "glCompact/TextureInterface.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::TextureUploader
+
+        \brief Streams CPU images into textures through a persistently mapped unpack ring
+
+        \details upload() writes the image data directly into the ring and queues it. If the ring is full it keeps a copy of the data instead
+        (or takes over the std::vector), so the caller can free its memory right away in any case.
+        update(), called once per frame on the GL thread, issues TextureInterface::copyConvertFromBuffer() for queued uploads, copying the
+        ones that did not fit before into the ring now. All uploads of one update() call form a batch that is guarded by a Fence, its ring space is reused once the Fence signaled.
+
+        The frame byte budget limits how many bytes one update() call issues, so that streaming does not take more than a set transfer time per frame.
+        An upload that alone is bigger than the budget is still issued, as the only upload of its frame.
+
+        \code{.cpp}
+            TextureUploader textureUploader(32 * 1024 * 1024, 4 * 1024 * 1024);
+            //loader
+            textureUploader.upload(texture, std::move(pixelData), MemorySurfaceFormat::R8G8B8A8_UNORM, 0, {0, 0, 0}, {width, height, 1});
+            //each frame
+            textureUploader.update();
+        \endcode
+
+        Textures must stay alive until their uploads are issued, or their uploads must be removed with cancel().
+        Image rows must be padded to 4 byte, the default GL_UNPACK_ALIGNMENT.
+
+        Depends on BufferStaging and therefore GL_ARB_buffer_storage (Core since 4.4)
+
+        \param ringSize        Size of the unpack ring in byte, this is the upper limit of a single upload.
+        \param frameByteBudget Maximum bytes issued per update() call, 0 for no limit
+    */
+    TextureUploader::TextureUploader(
+        uintptr_t ringSize,
+        uintptr_t frameByteBudget
+    ) :
+        ring           (alignTo<uintptr_t>(ringSize, 16)),
+        frameByteBudget(frameByteBudget),
+        statisticsStart(chrono::steady_clock::now())
+    {}
+
+    /**
+        \brief Queue a copy of size bytes from mem for upload into the given texture region
+    */
+    void TextureUploader::upload(
+        TextureInterface&   texture,
+        const void*         mem,
+        uintptr_t           size,
+        MemorySurfaceFormat memorySurfaceFormat,
+        uint32_t            mipmapLevel,
+        glm::ivec3          texOffset,
+        glm::ivec3          texSize
+    ) {
+        enqueue(texture, mem, 0, size, memorySurfaceFormat, mipmapLevel, texOffset, texSize);
+    }
+
+    /**
+        \brief Queue data for upload into the given texture region, use std::move to avoid a copy if the ring is full
+    */
+    void TextureUploader::upload(
+        TextureInterface&   texture,
+        vector<uint8_t>     data,
+        MemorySurfaceFormat memorySurfaceFormat,
+        uint32_t            mipmapLevel,
+        glm::ivec3          texOffset,
+        glm::ivec3          texSize
+    ) {
+        enqueue(texture, data.data(), &data, data.size(), memorySurfaceFormat, mipmapLevel, texOffset, texSize);
+    }
+
+    /**
+        \brief Remove all queued uploads of texture. Must be called before destroying a texture that still has queued uploads.
+    */
+    void TextureUploader::cancel(
+        const TextureInterface& texture
+    ) {
+        for (auto it = queue.begin(); it != queue.end();) {
+            if (it->texture != &texture) {
+                ++it;
+            } else if (it->inRing) {
+                //the ring space still gets released in order with the next batch
+                it->texture = 0;
+                ++it;
+            } else {
+                queuedBytes -= it->size;
+                it = queue.erase(it);
+            }
+        }
+    }
+
+    /**
+        \brief Reuse ring space of finished batches and issue queued uploads within the frame byte budget
+    */
+    void TextureUploader::update() {
+        reclaim(false);
+        issue(true);
+    }
+
+    /**
+        \brief Issue all queued uploads, ignoring the frame byte budget and waiting for ring space if needed
+    */
+    void TextureUploader::finish() {
+        reclaim(false);
+        issue(false);
+        while (!queue.empty() && reclaim(true)) issue(false);
+    }
+
+    TextureUploaderStatistics TextureUploader::getStatistics() const {
+        TextureUploaderStatistics statistics;
+        statistics.queuedCount         = uint32_t(queue.size());
+        statistics.queuedBytes         = queuedBytes;
+        statistics.batchesInFlight     = uint32_t(batch.size());
+        statistics.ringUsed            = ringUsed;
+        statistics.uploadedCount       = uploadedCount;
+        statistics.uploadedBytes       = uploadedBytes;
+        statistics.budgetLimitedFrames = budgetLimitedFrames;
+        statistics.ringLimitedFrames   = ringLimitedFrames;
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - statisticsStart).count();
+        statistics.bytesPerSecond      = seconds > 0.0 ? double(uploadedBytes) / seconds : 0.0;
+        return statistics;
+    }
+
+    void TextureUploader::resetStatistics() {
+        uploadedCount       = 0;
+        uploadedBytes       = 0;
+        budgetLimitedFrames = 0;
+        ringLimitedFrames   = 0;
+        statisticsStart     = chrono::steady_clock::now();
+    }
+
+    //Writes the data directly into the ring if possible, otherwise keeps a copy (or takes over data) until issue() finds ring space
+    void TextureUploader::enqueue(
+        TextureInterface&   texture,
+        const void*         mem,
+        vector<uint8_t>*    data,
+        uintptr_t           size,
+        MemorySurfaceFormat memorySurfaceFormat,
+        uint32_t            mipmapLevel,
+        glm::ivec3          texOffset,
+        glm::ivec3          texSize
+    ) {
+        UNLIKELY_IF (size == 0)
+            throw runtime_error("TextureUploader can not upload 0 byte!");
+        UNLIKELY_IF (size > ring.getSize())
+            throw runtime_error("TextureUploader upload of " + to_string(size) + " byte is bigger then the ring size of " + to_string(ring.getSize()) + " byte!");
+
+        Upload u(&texture, memorySurfaceFormat, mipmapLevel, texOffset, texSize, size);
+        //ring space must be taken in queue order, so only if all queued uploads are in the ring already
+        if (!(queue.empty() || queue.back().inRing) || !writeToRing(u, mem)) {
+            if (data) {
+                u.data = move(*data);
+            } else {
+                const uint8_t* memBytes = static_cast<const uint8_t*>(mem);
+                u.data.assign(memBytes, memBytes + size);
+            }
+        }
+        queuedBytes += size;
+        queue.push_back(move(u));
+    }
+
+    bool TextureUploader::writeToRing(
+        Upload&     u,
+        const void* mem
+    ) {
+        const uintptr_t ringUsedBefore = ringUsed;
+        if (!ringAllocate(u.size, u.offset)) return false;
+        memcpy(static_cast<uint8_t*>(ring.getPtr()) + u.offset, mem, u.size);
+        u.ringBytes = ringUsed - ringUsedBefore;
+        u.inRing    = true;
+        return true;
+    }
+
+    //Frees the ring space of batches whose fence signaled, in order. If wait is true it waits for the oldest batch. Returns true if anything was freed.
+    bool TextureUploader::reclaim(
+        bool wait
+    ) {
+        bool reclaimed = false;
+        while (!batch.empty()) {
+            Batch& b = batch.front();
+            if (!(wait && !reclaimed ? b.fence.isSignaledOrWait() : b.fence.isSignaled())) break;
+            tail      = b.end;
+            ringUsed -= b.used;
+            batch.pop_front();
+            reclaimed = true;
+        }
+        if (ringUsed == 0) {
+            head = 0;
+            tail = 0;
+        }
+        return reclaimed;
+    }
+
+    void TextureUploader::issue(
+        bool limitByBudget
+    ) {
+        uintptr_t frameBytes = 0;
+        uintptr_t batchUsed  = 0;
+        uintptr_t batchEnd   = 0;
+        uint32_t  batchCount = 0;
+        auto closeBatch = [&]() {
+            if (!batchCount) return;
+            batch.emplace_back();
+            batch.back().fence.insert();
+            batch.back().end  = batchEnd;
+            batch.back().used = batchUsed;
+        };
+
+        while (!queue.empty()) {
+            Upload& u = queue.front();
+            if (limitByBudget && frameByteBudget && batchCount && frameBytes + u.size > frameByteBudget) {
+                budgetLimitedFrames++;
+                break;
+            }
+            if (!u.inRing) {
+                if (!writeToRing(u, u.data.data())) {
+                    ringLimitedFrames++;
+                    break;
+                }
+                u.data = vector<uint8_t>();
+            }
+            batchUsed += u.ringBytes;
+            batchEnd   = u.offset + u.size;
+            batchCount++;
+            queuedBytes -= u.size;
+
+            if (u.texture) {
+                ring.bufferStagingFlushWrites(u.offset, u.size);
+                try {
+                    u.texture->copyConvertFromBuffer(ring, u.offset, uint32_t(u.size), u.memorySurfaceFormat, u.mipmapLevel, u.texOffset, u.texSize);
+                } catch (...) {
+                    queue.pop_front();
+                    closeBatch();
+                    throw;
+                }
+                frameBytes    += u.size;
+                uploadedBytes += u.size;
+                uploadedCount++;
+            }
+            queue.pop_front();
+        }
+        closeBatch();
+    }
+
+    //Takes size bytes at the ring head, wrapping around to the ring start if the rest of the ring is too small
+    bool TextureUploader::ringAllocate(
+        uintptr_t  size,
+        uintptr_t& offset
+    ) {
+        const uintptr_t ringSize    = ring.getSize();
+        const uintptr_t alignedHead = alignTo<uintptr_t>(head, 16);
+        const bool      wrapped     = head < tail || (head == tail && ringUsed);
+        if (!wrapped && alignedHead + size <= ringSize) {
+            offset = alignedHead;
+        } else if (!wrapped && size <= tail) {
+            //the skipped rest of the ring counts as used by this batch
+            ringUsed += ringSize - head;
+            head      = 0;
+            offset    = 0;
+        } else if (wrapped && alignedHead + size <= tail) {
+            offset = alignedHead;
+        } else {
+            return false;
+        }
+        ringUsed += offset + size - head;
+        head      = offset + size;
+        return true;
+    }
+}
@@ -0,0 +1,266 @@
+#include "glCompact/TransformFeedback.hpp"
+#include "glCompact/PipelineRasterization.hpp"
+#include "glCompact/BufferInterface.hpp"
+#include "glCompact/Context_.hpp"
+#include "glCompact/threadContext_.hpp"
+#include "glCompact/ContextGroup_.hpp"
+#include "glCompact/threadContextGroup_.hpp"
+#include "glCompact/Tools_.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::TransformFeedbackLayout
+
+        \brief List of the shader outputs a PipelineRasterization captures with transform feedback, must be given when creating the pipeline
+
+        \details Outputs are captured interleaved, in the order they got added. addNextBuffer() starts with the next TransformFeedback buffer slot.
+        Outputs of the last vertex processing stage (geometry, tessellation evaluation or vertex shader) can be captured.
+        Only float, double, int and uint based types are captured, as 32bit (or 64bit for double) values.
+
+            TransformFeedbackLayout layout;
+            layout.addOutput("outPosition");
+            layout.addOutput("outNormal");
+            layout.addNextBuffer();
+            layout.addOutput("outTexCoord");
+
+        addNextBuffer() and addSkip() depend on GL_ARB_transform_feedback3 (Core since 4.0)
+
+        Alternatively the shader can declare the captured outputs itself via layout(xfb_buffer = 0, xfb_offset = 0) (GL_ARB_enhanced_layouts, Core since 4.4).
+        That also works for pipelines created via PipelineCompiler.
+    */
+    void TransformFeedbackLayout::addOutput(
+        const std::string& name
+    ) {
+        UNLIKELY_IF (name.empty())
+            throw runtime_error("TransformFeedbackLayout::addOutput() does not take an empty name!");
+        varying.push_back(name);
+    }
+
+    /**
+        \brief Leave componentCount 32bit values of the buffer untouched
+    */
+    void TransformFeedbackLayout::addSkip(
+        uint32_t componentCount
+    ) {
+        while (componentCount) {
+            const uint32_t count = min<uint32_t>(componentCount, 4);
+            varying.push_back("gl_SkipComponents" + to_string(count));
+            componentCount -= count;
+        }
+        needsTransformFeedback3 = true;
+    }
+
+    void TransformFeedbackLayout::addNextBuffer() {
+        varying.push_back("gl_NextBuffer");
+        bufferCount++;
+        needsTransformFeedback3 = true;
+    }
+
+    void TransformFeedbackLayout::clear() {
+        varying.clear();
+        bufferCount             = 1;
+        needsTransformFeedback3 = false;
+    }
+
+    /**
+        \ingroup API
+        \class glCompact::TransformFeedback
+
+        \brief Captures the vertices of the draws of one PipelineRasterization into buffers, so they can be drawn again without running the vertex processing stages
+
+        \details Skinning or tessellating once and drawing the result in several passes:
+
+            TransformFeedback transformFeedback;
+            transformFeedback.setBuffer(0, skinnedVertexBuffer);
+            skinningPipeline.setRasterizerDiscard(true);
+            {
+                TransformFeedback::Scope scope(transformFeedback, skinningPipeline);
+                skinningPipeline.draw(vertexCount, 1, 0, 0);
+            }
+            shadowPipeline.setAttributeBuffer(0, skinnedVertexBuffer);
+            shadowPipeline.drawTransformFeedback(transformFeedback);
+            colorPipeline .setAttributeBuffer(0, skinnedVertexBuffer);
+            colorPipeline .drawTransformFeedback(transformFeedback);
+
+        The vertex count of drawTransformFeedback() comes from the TransformFeedback object, so it never needs a CPU readback.
+
+        While capturing only the pipeline given to begin() can be used, also no uniforms of other pipelines can be set and no compute dispatch can be done.
+        pause() allows to use other pipelines until resume(). Only one TransformFeedback can be active (between begin() and end()) at a time.
+
+        Captured primitives are always points, lines or triangles. Strips and adjacency primitives are split into their base primitive.
+
+        Depends on GL_ARB_transform_feedback2 (Core since 4.0)
+    */
+    TransformFeedback::~TransformFeedback() {
+        free();
+    }
+
+    void TransformFeedback::free() {
+        if (id) {
+            UNLIKELY_IF (!threadContextGroup_) crash("glCompact::TransformFeedback destructor called but thread has no reference to threadContextGroup_! Leaking OpenGL object!");
+            if (threadContext_ && isActive()) end();
+            threadContextGroup_->functions.glDeleteTransformFeedbacks(1, &id);
+            id = 0;
+        }
+        pipeline = 0;
+        paused   = false;
+        LOOPI(config::MAX_TRANSFORM_FEEDBACK_BUFFERS) {
+            buffer_id    [i] = 0;
+            buffer_offset[i] = 0;
+            buffer_size  [i] = 0;
+        }
+        bufferChanged = false;
+        captured      = false;
+    }
+
+    /**
+        \brief Capture into the buffer starting at offset until the end of the buffer. offset must be a multiple of 4.
+    */
+    void TransformFeedback::setBuffer(
+        uint32_t         slot,
+        BufferInterface& buffer,
+        uintptr_t        offset
+    ) {
+        UNLIKELY_IF (offset > buffer.size)
+            throw runtime_error("TransformFeedback::setBuffer() offset is outside of the buffer!");
+        setBuffer(slot, buffer, offset, buffer.size - offset);
+    }
+
+    /**
+        \brief Capture into the buffer range offset and size. offset and size must be a multiple of 4.
+    */
+    void TransformFeedback::setBuffer(
+        uint32_t         slot,
+        BufferInterface& buffer,
+        uintptr_t        offset,
+        uintptr_t        size
+    ) {
+        UNLIKELY_IF (isActive())
+            throw runtime_error("TransformFeedback::setBuffer() can not change the buffers between begin() and end()!");
+        UNLIKELY_IF (slot >= getMaxBufferCount())
+            throw runtime_error("TransformFeedback::setBuffer() slot " + to_string(slot) + " is not below the max. buffer count of " + to_string(getMaxBufferCount()) + "!");
+        UNLIKELY_IF (!buffer.id)
+            throw runtime_error("TransformFeedback::setBuffer() does not take empty buffers!");
+        UNLIKELY_IF (offset % 4 || size % 4 || size == 0)
+            throw runtime_error("TransformFeedback::setBuffer() offset and size must be multiples of 4 and size must not be 0!");
+        UNLIKELY_IF (offset + size > buffer.size)
+            throw runtime_error("TransformFeedback::setBuffer() range is outside of the buffer!");
+        buffer_id    [slot] = buffer.id;
+        buffer_offset[slot] = offset;
+        buffer_size  [slot] = size;
+        bufferChanged = true;
+    }
+
+    void TransformFeedback::setBuffer(
+        uint32_t slot
+    ) {
+        UNLIKELY_IF (isActive())
+            throw runtime_error("TransformFeedback::setBuffer() can not change the buffers between begin() and end()!");
+        UNLIKELY_IF (slot >= config::MAX_TRANSFORM_FEEDBACK_BUFFERS) return;
+        buffer_id    [slot] = 0;
+        buffer_offset[slot] = 0;
+        buffer_size  [slot] = 0;
+        bufferChanged = true;
+    }
+
+    void TransformFeedback::setBuffer() {
+        LOOPI(config::MAX_TRANSFORM_FEEDBACK_BUFFERS) setBuffer(i);
+    }
+
+    /**
+        \brief Starts capturing the draws of pipeline. The pipeline must have been created with a TransformFeedbackLayout or declare xfb outputs in the shader.
+    */
+    void TransformFeedback::begin(
+        PipelineRasterization& pipeline
+    ) {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!threadContextGroup_->extensions.GL_ARB_transform_feedback2)
+            throw runtime_error("missing support for GL_ARB_transform_feedback2 (Core since 4.0)!");
+        UNLIKELY_IF (isActive())
+            throw runtime_error("TransformFeedback::begin() called on active TransformFeedback!");
+        UNLIKELY_IF (threadContext_->transformFeedback != nullptr)
+            throw runtime_error("TransformFeedback::begin() called while another TransformFeedback is active!");
+        pipeline.waitReady();
+        UNLIKELY_IF (!pipeline.transformFeedbackVaryingCount)
+            throw runtime_error("TransformFeedback::begin() got a pipeline without captured outputs!");
+        const Primitive capturePrimitive = pipeline.getTransformFeedbackPrimitive();
+        UNLIKELY_IF (capturePrimitive == static_cast<Primitive>(-1))
+            throw runtime_error("TransformFeedback::begin() got a pipeline with an input primitive that needs a geometry or tessellation stage!");
+
+        if (!id) threadContextGroup_->functions.glGenTransformFeedbacks(1, &id);
+        threadContextGroup_->functions.glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, id);
+        if (bufferChanged) {
+            LOOPI(getMaxBufferCount()) {
+                if (buffer_id[i]) {
+                    threadContextGroup_->functions.glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, GLuint(i), buffer_id[i], buffer_offset[i], buffer_size[i]);
+                } else {
+                    threadContextGroup_->functions.glBindBufferBase (GL_TRANSFORM_FEEDBACK_BUFFER, GLuint(i), 0);
+                }
+            }
+            bufferChanged = false;
+        }
+        //e.g. MemoryBarrier::transformFeedback() after shaders wrote into the buffers
+        threadContext_->processPendingChangesMemoryBarriers();
+        threadContext_->cachedBindShader(pipeline.id);
+        threadContextGroup_->functions.glBeginTransformFeedback(static_cast<GLenum>(capturePrimitive));
+
+        this->pipeline = &pipeline;
+        primitive      = capturePrimitive;
+        paused         = false;
+        threadContext_->transformFeedback          = this;
+        threadContext_->transformFeedbackCapturing = true;
+    }
+
+    /**
+        \brief Stops capturing until resume(), other pipelines can be used in between
+    */
+    void TransformFeedback::pause() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!isActive() || paused)
+            throw runtime_error("TransformFeedback::pause() called on TransformFeedback that is not capturing!");
+        threadContextGroup_->functions.glPauseTransformFeedback();
+        paused = true;
+        threadContext_->transformFeedbackCapturing = false;
+    }
+
+    /**
+        \brief Continues capturing after pause(), the captured vertices get appended
+    */
+    void TransformFeedback::resume() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!isActive() || !paused)
+            throw runtime_error("TransformFeedback::resume() called on TransformFeedback that is not paused!");
+        threadContext_->cachedBindShader(pipeline->id);
+        threadContextGroup_->functions.glResumeTransformFeedback();
+        paused = false;
+        threadContext_->transformFeedbackCapturing = true;
+    }
+
+    void TransformFeedback::end() {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (!isActive())
+            throw runtime_error("TransformFeedback::end() called without TransformFeedback::begin()!");
+        threadContextGroup_->functions.glEndTransformFeedback();
+        pipeline = 0;
+        paused   = false;
+        captured = true;
+        threadContext_->transformFeedback          = 0;
+        threadContext_->transformFeedbackCapturing = false;
+    }
+
+    /**
+        \brief Max. amount of buffer slots that can be captured into at the same time
+    */
+    uint32_t TransformFeedback::getMaxBufferCount() {
+        if (!threadContextGroup_->extensions.GL_ARB_transform_feedback3) return 1;
+        return uint32_t(min<int32_t>(threadContextGroup_->values.GL_MAX_TRANSFORM_FEEDBACK_BUFFERS, config::MAX_TRANSFORM_FEEDBACK_BUFFERS));
+    }
+}
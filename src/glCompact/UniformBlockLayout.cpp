@@ -0,0 +1,189 @@
+#include "glCompact/UniformBlockLayout.hpp"
+#include "glCompact/gl/Constants.hpp"
+#include "glCompact/Tools_.hpp"
+#include "glCompact/minimumMaximum.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace glCompact::gl;
+
+namespace glCompact {
+    /**
+        \ingroup API
+        \class glCompact::UniformBlockLayout
+
+        \brief Writes uniform block (UBO) content at the offsets the shader reflection reports
+
+        \details The layout looks up a uniform block of a pipeline by its GLSL name. Its Member objects look up their offset, array stride, matrix stride and
+        matrix order once when they get constructed and check them against the C++ type and the block size. Writing a member is only a copy into block memory,
+        with the padding of the block layout (e.g. std140) applied. The block memory is usually a BufferRing allocation, so all uniforms of a draw
+        cost one setUniformBuffer() range bind instead of a glUniform* call per uniform.
+
+        \code{.cpp}
+            //layout(std140) uniform Object_binding1 {mat4 model; vec4 rgba; float roughness;};
+            class ObjectBlock : public glCompact::UniformBlockLayout {
+                public:
+                    using UniformBlockLayout::UniformBlockLayout;
+                    Member<glm::mat4> model    {this, "model"};
+                    Member<glm::vec4> rgba     {this, "rgba"};
+                    Member<float>     roughness{this, "roughness"};
+            };
+            ObjectBlock objectBlock(myPipeline, "Object_binding1");
+
+            //each draw
+            auto allocation = objectBlock.allocate(bufferRing);
+            objectBlock.model    .write(allocation.mem, object.modelMatrix);
+            objectBlock.rgba     .write(allocation.mem, object.rgba);
+            objectBlock.roughness.write(allocation.mem, object.roughness);
+            bufferRing.flushWrites();
+            objectBlock.setUniformBuffer(myPipeline, bufferRing, allocation);
+            myPipeline.draw(...);
+        \endcode
+
+        Members of std140 blocks are always active, a member name that is not part of the block throws.
+        The layout keeps a copy of the reflection it needs and can be used with any pipeline that declares the same block.
+        Waits for a pipeline created with PipelineCompileMode::async to be ready.
+    */
+    UniformBlockLayout::UniformBlockLayout(
+        PipelineInterface& pipeline,
+        HashedName         blockName
+    ) {
+        UNLIKELY_IF (pipeline.loadPending) pipeline.waitReady();
+        const PipelineInterface::UniformBlock* uniformBlock = pipeline.findUniformBlock(blockName);
+        UNLIKELY_IF (!uniformBlock)
+            throw runtime_error("UniformBlockLayout did not find a uniform block with the name \"" + string(blockName.name) + "\"!");
+        name       = uniformBlock->name;
+        binding    = uniformBlock->binding;
+        size       = uint32_t(uniformBlock->blockSize);
+        reflection = uniformBlock->uniform;
+        PipelineInterface::buildNameIndex(reflectionNameIndex, reflection);
+    }
+
+    /**
+        \brief Allocate getSize() bytes for one block from bufferRing, with the uniform buffer offset alignment
+    */
+    BufferRing::Allocation UniformBlockLayout::allocate(
+        BufferRing& bufferRing
+    ) const {
+        return bufferRing.allocateUniform(size);
+    }
+
+    /**
+        \brief Pointer to the block memory of allocation, throws if the allocation is smaller then the block
+    */
+    void* UniformBlockLayout::getBlockPtr(
+        const BufferRing::Allocation& allocation
+    ) const {
+        UNLIKELY_IF (allocation.size < size)
+            throw runtime_error("BufferRing allocation of " + to_string(allocation.size) + " byte is smaller then the uniform block " + name + " of " + to_string(size) + " byte!");
+        return allocation.mem;
+    }
+
+    /**
+        \brief Pointer to the block memory at offset of the mapped bufferStaging, throws if the block does not fit into the buffer
+    */
+    void* UniformBlockLayout::getBlockPtr(
+        BufferStaging& bufferStaging,
+        uintptr_t      offset
+    ) const {
+        UNLIKELY_IF (offset + size > bufferStaging.getSize())
+            throw runtime_error("Uniform block " + name + " of " + to_string(size) + " byte at offset " + to_string(offset) + " does not fit into BufferStaging of " + to_string(bufferStaging.getSize()) + " byte!");
+        return static_cast<uint8_t*>(bufferStaging.getPtr()) + offset;
+    }
+
+    /**
+        \brief Bind the block in allocation to the binding of this block of pipeline
+    */
+    void UniformBlockLayout::setUniformBuffer(
+        PipelineInterface&            pipeline,
+        const BufferRing&             bufferRing,
+        const BufferRing::Allocation& allocation
+    ) const {
+        getBlockPtr(allocation); //throws if the allocation is too small
+        pipeline.setUniformBuffer(uint32_t(binding), bufferRing.getBuffer(), allocation.offset, size);
+    }
+
+    //Columns and rows of matrix types, 0 for all others
+    static void getMatrixSize(
+        int32_t  type,
+        uint8_t& columns,
+        uint8_t& rows
+    ) {
+        switch (type) {
+            case GL_FLOAT_MAT2:   case GL_DOUBLE_MAT2:   columns = 2; rows = 2; return;
+            case GL_FLOAT_MAT2x3: case GL_DOUBLE_MAT2x3: columns = 2; rows = 3; return;
+            case GL_FLOAT_MAT2x4: case GL_DOUBLE_MAT2x4: columns = 2; rows = 4; return;
+            case GL_FLOAT_MAT3x2: case GL_DOUBLE_MAT3x2: columns = 3; rows = 2; return;
+            case GL_FLOAT_MAT3:   case GL_DOUBLE_MAT3:   columns = 3; rows = 3; return;
+            case GL_FLOAT_MAT3x4: case GL_DOUBLE_MAT3x4: columns = 3; rows = 4; return;
+            case GL_FLOAT_MAT4x2: case GL_DOUBLE_MAT4x2: columns = 4; rows = 2; return;
+            case GL_FLOAT_MAT4x3: case GL_DOUBLE_MAT4x3: columns = 4; rows = 3; return;
+            case GL_FLOAT_MAT4:   case GL_DOUBLE_MAT4:   columns = 4; rows = 4; return;
+        }
+        columns = 0;
+        rows    = 0;
+    }
+
+    void UniformBlockLayout::lookup(
+        HashedName  memberName,
+        int32_t     type,
+        uint32_t    cppSize,
+        MemberInfo& info
+    ) {
+        const PipelineInterface::UniformBlockUniform* uniform = PipelineInterface::findByName(reflectionNameIndex, reflection, memberName);
+        //members of blocks with an instance name are reported as BlockName.memberName
+        if (!uniform) {
+            const string qualifiedName = name + "." + memberName.name;
+            uniform = PipelineInterface::findByName(reflectionNameIndex, reflection, qualifiedName);
+        }
+        UNLIKELY_IF (!uniform)
+            throw runtime_error("UniformBlockLayout did not find the member \"" + string(memberName.name) + "\" in the uniform block " + name + "!");
+        UNLIKELY_IF (uniform->type != type)
+            throw runtime_error("UniformBlockLayout::Member type mismatches GLSL type of " + name + "." + memberName.name + ". Member is " + PipelineInterface::glTypeToCppName(type)
+                + " but GLSL type is " + PipelineInterface::glTypeToGlslName(uniform->type) + ". Change Member to " + PipelineInterface::glTypeToCppName(uniform->type) + "!");
+        info.offset       = uint32_t(uniform->offset);
+        info.arraySize    = uint32_t(maximum(uniform->arraySize, 1));
+        info.arrayStride  = uint32_t(uniform->arrayStride);
+        info.matrixStride = uint32_t(uniform->matrixStride);
+        info.size         = cppSize;
+        info.rowMajor     = uniform->matrixRowMajor;
+        getMatrixSize(type, info.columns, info.rows);
+        info.scalarSize   = info.columns ? uint8_t(cppSize / (info.columns * info.rows)) : 0;
+
+        uint32_t elementSize = cppSize;
+        if (info.columns) elementSize = info.rowMajor
+            ? (info.rows    - 1) * info.matrixStride + info.columns * info.scalarSize
+            : (info.columns - 1) * info.matrixStride + info.rows    * info.scalarSize;
+        UNLIKELY_IF (info.arraySize > 1 && info.arrayStride < elementSize)
+            throw runtime_error("UniformBlockLayout::Member " + name + "." + memberName.name + " has an array stride of " + to_string(info.arrayStride) + " byte, smaller then its element of " + to_string(elementSize) + " byte!");
+        UNLIKELY_IF (info.offset + (info.arraySize - 1) * info.arrayStride + elementSize > size)
+            throw runtime_error("UniformBlockLayout::Member " + name + "." + memberName.name + " does not fit into the block size of " + to_string(size) + " byte!");
+    }
+
+    //Writes count elements of value, glm matrices are tightly packed columns, into block with the array and matrix stride of the block layout
+    void UniformBlockLayout::writeMember(
+        const MemberInfo& info,
+        void*             block,
+        const void*       value,
+        uint32_t          count
+    ) {
+        count = minimum(count, info.arraySize);
+        uint8_t*       dst = static_cast<uint8_t*>(block) + info.offset;
+        const uint8_t* src = static_cast<const uint8_t*>(value);
+        LOOPI(count) {
+            if (!info.columns) {
+                memcpy(dst, src, info.size);
+            } else if (!info.rowMajor) {
+                const uint32_t columnSize = info.rows * info.scalarSize;
+                LOOPJ(info.columns) memcpy(dst + j * info.matrixStride, src + j * columnSize, columnSize);
+            } else {
+                LOOPJ(info.columns) for (uint32_t r = 0; r < info.rows; ++r)
+                    memcpy(dst + r * info.matrixStride + j * info.scalarSize, src + (j * info.rows + r) * info.scalarSize, info.scalarSize);
+            }
+            dst += info.arrayStride;
+            src += info.size;
+        }
+    }
+}
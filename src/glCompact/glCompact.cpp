@@ -14,17 +14,42 @@ using namespace glCompact::gl;
 */
 
 namespace glCompact {
-    /*
-        @param oqoId
-        @param waitMode Can be GL_QUERY_WAIT, GL_QUERY_NO_WAIT, GL_QUERY_BY_REGION_WAIT​, GL_QUERY_BY_REGION_NO_WAIT
+    /**
+        \ingroup API
+        \brief Only execute the following draws, clears and blits if the last ended query of occlusionQuery passed, until setCondition() gets called
+
+        \details With ConditionalRenderMode::wait the GPU waits for the query result, with noWait it may ignore the condition if the result is not available yet.
+        The byRegion modes allow the GPU to evaluate the condition per screen region. The inverted modes need GL_ARB_conditional_render_inverted (Core since 4.5).
+
+        ConditionalRenderScope calls setCondition() at the end of its scope.
     */
-    /*void setCondition(GLuint oqoId, GLenum waitMode) {
-        threadContext->glBeginConditionalRender(oqoId, waitMode);
+    void setCondition(
+        const OcclusionQuery& occlusionQuery,
+        ConditionalRenderMode conditionalRenderMode
+    ) {
+        threadContext_->flushDrawBatch();
+        UNLIKELY_IF (threadContext_->conditionalRenderOcclusionQuery != nullptr)
+            throw runtime_error("setCondition() called while a condition is already set, conditional rendering can not be nested!");
+        UNLIKELY_IF (occlusionQuery.isRunning())
+            throw runtime_error("setCondition() can not use a running OcclusionQuery!");
+        UNLIKELY_IF (occlusionQuery.lastEndedSlot < 0)
+            throw runtime_error("setCondition() needs an OcclusionQuery that got ended at last once!");
+        UNLIKELY_IF (int32_t(conditionalRenderMode) >= int32_t(ConditionalRenderMode::waitInverted) && !threadContextGroup_->extensions.GL_ARB_conditional_render_inverted)
+            throw runtime_error("missing support for GL_ARB_conditional_render_inverted (Core since 4.5)!");
+        threadContextGroup_->functions.glBeginConditionalRender(occlusionQuery.slot[occlusionQuery.lastEndedSlot].queryId, static_cast<GLenum>(conditionalRenderMode));
+        threadContext_->conditionalRenderOcclusionQuery = &occlusionQuery;
     }
 
+    /**
+        \ingroup API
+        \brief Ends conditional rendering started with setCondition(occlusionQuery)
+    */
     void setCondition() {
-        threadContext->glEndConditionalRender();
-    }*/
+        threadContext_->flushDrawBatch();
+        if (!threadContext_->conditionalRenderOcclusionQuery) return;
+        threadContextGroup_->functions.glEndConditionalRender();
+        threadContext_->conditionalRenderOcclusionQuery = nullptr;
+    }
 
     /**
         \ingroup API
@@ -41,6 +66,8 @@ namespace glCompact {
     ) {
         UNLIKELY_IF (frame.id == 0 && &frame != &threadContext_->displayFrame)
             throw runtime_error("Trying to set empty Frame as drawFrame!");
+        threadContext_->flushDrawBatch();
+        threadContext_->switchFrameGpuTimer(frame.gpuTimer);
         threadContext_->pending_frame = &frame;
         threadContext_->stateChange.viewportScissor = true;
     }
@@ -50,6 +77,8 @@ namespace glCompact {
         \brief Set target Frame object for PiepelineRasterization draw calls and blit operations to NULL
     */
     void setDrawFrame() {
+        threadContext_->flushDrawBatch();
+        threadContext_->switchFrameGpuTimer(nullptr);
         threadContext_->pending_frame = NULL;
     }
 
@@ -84,6 +113,7 @@ namespace glCompact {
     ) {
         UNLIKELY_IF (!threadContext_->isMainContext)
             throw runtime_error("Not the main context, only the main context can access to the drawFrame!");
+        threadContext_->flushDrawBatch();
         threadContext_->displayFrame.size.x = x;
         threadContext_->displayFrame.size.y = y;
         threadContext_->displayFrame.viewportOffset = {0, 0};
@@ -106,19 +136,71 @@ namespace glCompact {
         return threadContext_->displayFrame;
     }
 
-    //transform feedback
-    //If I implement this it maybe will be part of PipelineRasterization or its own object.
-    //void setTransformFeedbackLayout(const TransformFeedbackLayout& layout);
-    //void setTransformFeedbackBuffer(uint32_t slot, BufferInterface& buffer);
+    /**
+        \ingroup API
+        \brief Enable or disable automatic batching of consecutive draws for this context (disabled by default)
+
+        \details While enabled, consecutive PipelineRasterization::draw() or PipelineRasterization::drawIndexed() calls of the same pipeline,
+        without any changes to the pipeline, its bindings or the draw frame in between, are collected and submitted as one
+        glMultiDrawArraysIndirect/glMultiDrawElementsIndirect from an internal indirect buffer. They can still differ in all draw arguments.
+
+        Needs GL_ARB_multi_draw_indirect (Core since 4.3), otherwise this setting has no effect.
+
+        All glCompact functions that emit other GL commands submit the pending draws first. Before using raw OpenGL calls
+        between glCompact draws call flush() or disable draw batching, otherwise the order of the commands can change!
+
+        Disabling submits all pending draws.
+    */
+    void setDrawBatching(
+        bool enabled
+    ) {
+        if (!enabled) threadContext_->flushDrawBatch();
+        threadContext_->drawBatchEnabled = enabled;
+    }
+
+    bool getDrawBatching() {
+        return threadContext_->drawBatchEnabled;
+    }
+
+    /**
+        \ingroup API
+        \brief Keep up to maxVertexArrayCount VAOs for this context, one per distinct attribute layout (0 by default, using a single VAO)
+
+        \details By default glCompact respecifies all attribute formats of its single VAO whenever a pipeline with a different attribute layout gets used.
+        With the cache every distinct attribute layout gets its own VAO, so switching between pipelines with different layouts only costs
+        one glBindVertexArray and the rebinding of the attribute buffers that differ from the ones that were last used with this VAO.
+        If the cache is full, the VAO of the least recently used layout gets respecified for the new one.
+
+        Needs GL_ARB_vertex_attrib_binding (Core since 4.3), otherwise this setting has no effect.
+
+        Cached VAOs that use a buffer get deleted together with the buffer, but only in the context that deletes it. Like the single VAO,
+        the VAOs of other contexts keep the buffer alive until their slots get other buffers.
+
+        Any change of the size deletes all cached VAOs, 0 disables the cache.
+    */
+    void setVertexArrayCache(
+        uint32_t maxVertexArrayCount
+    ) {
+        if (!threadContextGroup_->extensions.GL_ARB_vertex_attrib_binding) return;
+        threadContext_->vertexArrayBindDefault();
+        threadContext_->vertexArrayCacheClear();
+        threadContext_->vertexArrayCacheSize = maxVertexArrayCount;
+    }
+
+    uint32_t getVertexArrayCache() {
+        return threadContext_->vertexArrayCacheSize;
+    }
 
     void flush() {
         //TODO: set all pending changes
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesMemoryBarriers();
         threadContextGroup_->functions.glFlush();
     }
 
     void finish() {
         //TODO: set all pending changes
+        threadContext_->flushDrawBatch();
         threadContext_->processPendingChangesMemoryBarriers();
         threadContextGroup_->functions.glFinish();
     }